@@ -19,11 +19,15 @@ class KaTilecutRecipe(ConanFile):
         "shared": [True, False],
         "fPIC": [True, False],
         "build_generate_grid": [True, False],
+        "exact_statistics": [True, False],
+        "build_benchmarks": [True, False],
     }
     default_options = {
         "shared": False,
         "fPIC": True,
         "build_generate_grid": True,
+        "exact_statistics": False,
+        "build_benchmarks": False,
     }
 
     def config_options(self):
@@ -43,6 +47,8 @@ class KaTilecutRecipe(ConanFile):
 
         if self.build_testing():
             self.test_requires("gtest/1.17.0")
+        if self.options.build_benchmarks:
+            self.test_requires("benchmark/1.9.1")
         if self.options.build_generate_grid:
             self.requires("boost/1.86.0")
         if self.build_testing() or self.options.build_generate_grid:
@@ -76,6 +82,8 @@ class KaTilecutRecipe(ConanFile):
         deps.generate()
         tc = CMakeToolchain(self)
         tc.variables["BUILD_GENERATE_GRID"] = bool(self.options.build_generate_grid)
+        tc.variables["EXACT_STATISTICS"] = bool(self.options.exact_statistics)
+        tc.variables["BUILD_BENCHMARKS"] = bool(self.options.build_benchmarks)
         tc.generate()
 
     def build(self):
@@ -106,3 +114,5 @@ class KaTilecutRecipe(ConanFile):
         self.cpp_info.components["tilecut"].set_property("cmake_target_name", "ka::tilecut")
         self.cpp_info.components["tilecut"].requires = ["fmt::fmt", "ka_common::ka_common", "geometry_types", "exact"]
         self.cpp_info.components["tilecut"].libs = ["ka_tilecut"]
+        if self.settings.os in ["Linux", "FreeBSD"]:
+            self.cpp_info.components["tilecut"].system_libs = ["pthread"]
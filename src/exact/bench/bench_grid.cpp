@@ -0,0 +1,216 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <vector>
+
+#include <ka/common/fixed.hpp>
+#include <ka/exact/ExactStatistics.hpp>
+#include <ka/exact/GridRounding.hpp>
+#include <ka/exact/InstructionSet.hpp>
+#include <ka/exact/LineCellTester.hpp>
+#include <ka/exact/grid.hpp>
+#include <ka/geometry_types/Vec2.hpp>
+
+#include "inputs.hpp"
+
+namespace ka
+{
+
+inline namespace
+{
+
+/// @brief Reports the share of the checks that required exact arithmetic, if statistics are collected.
+void report_line_intersects_cell_statistics(benchmark::State & state)
+{
+    if (!exact_statistics_enabled())
+    {
+        return;
+    }
+    const auto statistics = thread_exact_statistics();
+    const auto total = statistics.line_intersects_cell_filtered + statistics.line_intersects_cell_exact;
+    if (total != 0)
+    {
+        state.counters["exact_share"] = exact_cast<f64>(statistics.line_intersects_cell_exact) / exact_cast<f64>(total);
+    }
+}
+
+template <GridRounding rounding, Distribution distribution>
+void bench_column_containing_position(benchmark::State & state)
+{
+    const auto grid = production_grid();
+    const auto inputs = InputGenerator { grid }.coordinates(distribution);
+
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(column_containing_position<rounding>(grid, inputs[i++ % inputs.size()]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+/// @brief The argument of the benchmark is the instruction set used by the exact computations.
+template <GridRounding rounding, Distribution distribution>
+void bench_cells_containing_points(benchmark::State & state)
+{
+    const auto grid = production_grid();
+    const auto coordinates = InputGenerator { grid }.coordinates(distribution);
+    std::vector<Vec2f64> points;
+    for (size_t i = 0; i + 1 < coordinates.size(); i += 2)
+    {
+        points.push_back({ .x = coordinates[i], .y = coordinates[i + 1] });
+    }
+    std::vector<Vec2s64> cells(points.size());
+
+    const auto initial = exact_instruction_set();
+    set_exact_instruction_set(static_cast<InstructionSet>(state.range(0)));
+    for (auto _ : state)
+    {
+        cells_containing_points<rounding>(grid, points, cells);
+        benchmark::DoNotOptimize(cells.data());
+    }
+    set_exact_instruction_set(initial);
+    state.SetItemsProcessed(state.iterations() * exact_cast<s64>(points.size()));
+}
+
+template <Distribution distribution>
+void bench_border_between_coordinates(benchmark::State & state)
+{
+    const auto grid = production_grid();
+    const auto inputs = InputGenerator { grid }.column_borders(distribution);
+
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        const auto & [segment, c_x, c_y] = inputs[i++ % inputs.size()];
+        benchmark::DoNotOptimize(border_between_coordinates(grid.cell_size, segment.a_x, segment.b_x, c_x));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template <GridRounding rounding, Distribution distribution>
+void bench_column_border_intersection(benchmark::State & state)
+{
+    const auto grid = production_grid();
+    const auto inputs = InputGenerator { grid }.column_borders(distribution);
+
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        const auto & [segment, c_x, c_y] = inputs[i++ % inputs.size()];
+        benchmark::DoNotOptimize(
+            column_border_intersection<rounding>(grid, segment.a_x, segment.a_y, segment.b_x, segment.b_y, c_x));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template <GridRounding rounding, Distribution distribution>
+void bench_row_border_intersection(benchmark::State & state)
+{
+    const auto grid = production_grid();
+    const auto inputs = InputGenerator { grid }.row_borders(distribution);
+
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        const auto & [segment, c_x, c_y] = inputs[i++ % inputs.size()];
+        benchmark::DoNotOptimize(
+            row_border_intersection<rounding>(grid, segment.a_x, segment.a_y, segment.b_x, segment.b_y, c_y));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template <GridRounding rounding, Distribution distribution>
+void bench_line_intersects_cell(benchmark::State & state)
+{
+    const auto grid = production_grid();
+    const auto inputs = InputGenerator { grid }.cells<rounding>(distribution);
+
+    reset_thread_exact_statistics();
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        const auto & [segment, c_x, c_y] = inputs[i++ % inputs.size()];
+        benchmark::DoNotOptimize(
+            line_intersects_cell<rounding>(grid, segment.a_x, segment.a_y, segment.b_x, segment.b_y, c_x, c_y));
+    }
+    state.SetItemsProcessed(state.iterations());
+    report_line_intersects_cell_statistics(state);
+}
+
+/// @brief The argument of the benchmark is 1 if the cells are checked at once and 0 if they are checked one by one.
+/// Every line is checked against the block of 4x4 cells around the cell of the query.
+template <GridRounding rounding, Distribution distribution>
+void bench_line_cell_tester(benchmark::State & state)
+{
+    const auto grid = production_grid();
+    const auto inputs = InputGenerator { grid }.cells<rounding>(distribution);
+    const bool batch = state.range(0) != 0;
+
+    std::array<Vec2s64, 16> cells;
+    std::array<bool, cells.size()> result;
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        const auto & [segment, c_x, c_y] = inputs[i++ % inputs.size()];
+        const LineCellTester<rounding> tester { grid, segment.a_x, segment.a_y, segment.b_x, segment.b_y };
+        for (size_t j = 0; j < cells.size(); ++j)
+        {
+            cells[j] = { c_x + exact_cast<s64>(j % 4) - 2, c_y + exact_cast<s64>(j / 4) - 2 };
+        }
+        if (batch)
+        {
+            tester.intersects(cells, result);
+        }
+        else
+        {
+            for (size_t j = 0; j < cells.size(); ++j)
+            {
+                result[j] = tester.intersects(cells[j].x, cells[j].y);
+            }
+        }
+        benchmark::DoNotOptimize(result.data());
+    }
+    state.SetItemsProcessed(state.iterations() * exact_cast<s64>(cells.size()));
+}
+
+using enum Distribution;
+using enum GridRounding;
+
+// Uniform inputs measure the fast path, other distributions force the exact fallback.
+
+BENCHMARK_TEMPLATE(bench_column_containing_position, Cell, Uniform);
+BENCHMARK_TEMPLATE(bench_column_containing_position, Cell, NearInteger);
+BENCHMARK_TEMPLATE(bench_column_containing_position, NearestNode, Uniform);
+BENCHMARK_TEMPLATE(bench_column_containing_position, NearestNode, NearInteger);
+
+BENCHMARK_TEMPLATE(bench_cells_containing_points, Cell, Uniform)
+    ->DenseRange(0, static_cast<int>(supported_instruction_set()));
+BENCHMARK_TEMPLATE(bench_cells_containing_points, Cell, NearInteger)
+    ->DenseRange(0, static_cast<int>(supported_instruction_set()));
+
+BENCHMARK_TEMPLATE(bench_border_between_coordinates, Uniform);
+BENCHMARK_TEMPLATE(bench_border_between_coordinates, NearInteger);
+
+BENCHMARK_TEMPLATE(bench_column_border_intersection, Cell, Uniform);
+BENCHMARK_TEMPLATE(bench_column_border_intersection, Cell, NearInteger);
+BENCHMARK_TEMPLATE(bench_column_border_intersection, NearestNode, Uniform);
+BENCHMARK_TEMPLATE(bench_column_border_intersection, NearestNode, NearInteger);
+
+BENCHMARK_TEMPLATE(bench_row_border_intersection, Cell, Uniform);
+BENCHMARK_TEMPLATE(bench_row_border_intersection, Cell, NearInteger);
+BENCHMARK_TEMPLATE(bench_row_border_intersection, NearestNode, Uniform);
+BENCHMARK_TEMPLATE(bench_row_border_intersection, NearestNode, NearInteger);
+
+BENCHMARK_TEMPLATE(bench_line_intersects_cell, Cell, Uniform);
+BENCHMARK_TEMPLATE(bench_line_intersects_cell, Cell, NearlyCollinear);
+BENCHMARK_TEMPLATE(bench_line_intersects_cell, NearestNode, Uniform);
+BENCHMARK_TEMPLATE(bench_line_intersects_cell, NearestNode, NearlyCollinear);
+
+BENCHMARK_TEMPLATE(bench_line_cell_tester, Cell, Uniform)->Arg(0)->Arg(1);
+BENCHMARK_TEMPLATE(bench_line_cell_tester, Cell, NearlyCollinear)->Arg(0)->Arg(1);
+BENCHMARK_TEMPLATE(bench_line_cell_tester, NearestNode, Uniform)->Arg(0)->Arg(1);
+BENCHMARK_TEMPLATE(bench_line_cell_tester, NearestNode, NearlyCollinear)->Arg(0)->Arg(1);
+
+} // namespace
+
+} // namespace ka
@@ -0,0 +1,76 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <ka/common/fixed.hpp>
+#include <ka/exact/orientation.hpp>
+
+#include "inputs.hpp"
+
+namespace ka
+{
+
+inline namespace
+{
+
+[[nodiscard]] std::vector<std::array<f64, 6>> orientation_inputs(const Distribution distribution)
+{
+    const auto grid = production_grid();
+    std::mt19937_64 random { 42 };
+    std::uniform_real_distribution<f64> unit { 0.0, 1.0 };
+    std::uniform_int_distribution<int> shifts { -1, 1 };
+
+    std::vector<std::array<f64, 6>> result;
+    for (const auto & [a_x, a_y, b_x, b_y] : InputGenerator { grid }.segments(distribution))
+    {
+        if (distribution == Distribution::NearlyCollinear)
+        {
+            // The midpoint is computed exactly, so the points are collinear or one ulp away from the line.
+            auto c_x = a_x + (b_x - a_x) * 0.5;
+            const auto c_y = a_y + (b_y - a_y) * 0.5;
+            if (const auto shift = shifts(random); shift != 0)
+            {
+                constexpr auto infinity = std::numeric_limits<f64>::infinity();
+                c_x = std::nextafter(c_x, shift > 0 ? infinity : -infinity);
+            }
+            result.push_back({ a_x, a_y, b_x, b_y, c_x, c_y });
+        }
+        else
+        {
+            // The point is shifted from the line by the length of the segment.
+            const auto t = unit(random);
+            const auto c_x = a_x + (b_x - a_x) * t + (b_y - a_y);
+            const auto c_y = a_y + (b_y - a_y) * t - (b_x - a_x);
+            result.push_back({ a_x, a_y, b_x, b_y, c_x, c_y });
+        }
+    }
+    return result;
+}
+
+template <Distribution distribution>
+void bench_orientation(benchmark::State & state)
+{
+    const auto inputs = orientation_inputs(distribution);
+
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        const auto & [a_x, a_y, b_x, b_y, c_x, c_y] = inputs[i++ % inputs.size()];
+        benchmark::DoNotOptimize(orientation(a_x, a_y, b_x, b_y, c_x, c_y));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+using enum Distribution;
+
+// Uniform inputs measure the fast path, nearly collinear inputs force the adaptive stages.
+BENCHMARK_TEMPLATE(bench_orientation, Uniform);
+BENCHMARK_TEMPLATE(bench_orientation, NearlyCollinear);
+
+} // namespace
+
+} // namespace ka
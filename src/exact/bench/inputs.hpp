@@ -0,0 +1,242 @@
+#pragma once
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <ka/common/cast.hpp>
+#include <ka/common/fixed.hpp>
+#include <ka/exact/GridParameters.hpp>
+#include <ka/exact/GridRounding.hpp>
+#include <ka/exact/compute_grid_parameters.hpp>
+#include <ka/exact/grid.hpp>
+
+namespace ka
+{
+
+inline namespace
+{
+
+/// @brief Number of inputs cycled through by every benchmark.
+constexpr size_t g_input_count = 4096;
+
+/// @brief Distribution of the benchmark inputs.
+enum class Distribution
+{
+    /// @brief Uniformly distributed coordinates, almost always decided by the floating-point fast path.
+    Uniform,
+    /// @brief Coordinates and lines passing exactly through grid nodes, the quotients are integers or almost integers.
+    NearInteger,
+    /// @brief Lines passing through the tested point or grid node up to rounding errors.
+    NearlyCollinear,
+};
+
+/// @brief Parameters of the grid for EPSG:3857 computed like ka_generate_grid does for production grids.
+[[nodiscard]] inline GridParameters production_grid() noexcept
+{
+    auto grid = compute_grid_parameters({
+        .world_cells = 0x1p32,
+        .world_size = 40075016.68,
+        .min_world_coordinate = 0.005,
+        .max_world_coordinate = 0x1p25,
+    });
+    // Nearest node rounding requires the cell size to be at least twice the minimal one.
+    grid.cell_size *= 2.0;
+    return grid;
+}
+
+struct Segment final
+{
+    f64 a_x;
+    f64 a_y;
+    f64 b_x;
+    f64 b_y;
+};
+
+/// @brief Segment on a line and a cell or border to test against it.
+struct SegmentQuery final
+{
+    Segment segment;
+    s64 c_x;
+    s64 c_y;
+};
+
+class InputGenerator final
+{
+public:
+    explicit InputGenerator(const GridParameters & grid)
+        : grid_ { grid }
+    {
+    }
+
+public:
+    /// @brief Generates coordinates of points.
+    [[nodiscard]] std::vector<f64> coordinates(const Distribution distribution)
+    {
+        std::vector<f64> result;
+        while (result.size() < g_input_count)
+        {
+            const auto x = distribution == Distribution::Uniform ? coordinate_(random_) : node_coordinate();
+            if (valid_input(x))
+            {
+                result.push_back(x);
+            }
+        }
+        return result;
+    }
+
+    /// @brief Generates short segments, typical for map data.
+    [[nodiscard]] std::vector<Segment> segments(const Distribution distribution)
+    {
+        std::vector<Segment> result;
+        while (result.size() < g_input_count)
+        {
+            const auto segment = this->segment(distribution);
+            if (valid_input(segment.a_x) && valid_input(segment.a_y) && valid_input(segment.b_x) &&
+                valid_input(segment.b_y) && (segment.a_x != segment.b_x || segment.a_y != segment.b_y))
+            {
+                result.push_back(segment);
+            }
+        }
+        return result;
+    }
+
+    /// @brief Generates segments and the borders of columns between their endpoints.
+    [[nodiscard]] std::vector<SegmentQuery> column_borders(const Distribution distribution)
+    {
+        std::vector<SegmentQuery> result;
+        for (const auto & segment : segments(distribution))
+        {
+            const auto [first, last] = borders_between_coordinates(grid_.cell_size, segment.a_x, segment.b_x);
+            if (segment.a_x != segment.b_x && first <= last)
+            {
+                result.push_back({ segment, std::uniform_int_distribution<s64> { first, last }(random_), 0 });
+            }
+        }
+        return result;
+    }
+
+    /// @brief Generates segments and the borders of rows between their endpoints.
+    [[nodiscard]] std::vector<SegmentQuery> row_borders(const Distribution distribution)
+    {
+        std::vector<SegmentQuery> result;
+        for (const auto & segment : segments(distribution))
+        {
+            const auto [first, last] = borders_between_coordinates(grid_.cell_size, segment.a_y, segment.b_y);
+            if (segment.a_y != segment.b_y && first <= last)
+            {
+                result.push_back({ segment, 0, std::uniform_int_distribution<s64> { first, last }(random_) });
+            }
+        }
+        return result;
+    }
+
+    /// @brief Generates segments and the cells near them.
+    template <GridRounding rounding>
+    [[nodiscard]] std::vector<SegmentQuery> cells(const Distribution distribution)
+    {
+        if (distribution == Distribution::NearlyCollinear)
+        {
+            return node_cells<rounding>();
+        }
+
+        std::uniform_int_distribution<s64> offset { -1, 1 };
+        std::vector<SegmentQuery> result;
+        for (const auto & segment : segments(distribution))
+        {
+            // Cells along the segment, so that both results are frequent.
+            const auto t = unit_(random_);
+            const auto x = segment.a_x + (segment.b_x - segment.a_x) * t;
+            const auto y = segment.a_y + (segment.b_y - segment.a_y) * t;
+            result.push_back({
+                segment,
+                column_containing_position<rounding>(grid_, x) + offset(random_),
+                row_containing_position<rounding>(grid_, y) + offset(random_),
+            });
+        }
+        return result;
+    }
+
+private:
+    /// @brief Generates segments whose midpoints are the first tested node of the cell up to rounding errors.
+    /// See line_intersects_cell.cpp for the choice of the tested nodes.
+    template <GridRounding rounding>
+    [[nodiscard]] std::vector<SegmentQuery> node_cells()
+    {
+        std::vector<SegmentQuery> result;
+        while (result.size() < g_input_count)
+        {
+            const auto n = node_(random_) / 2, m = node_(random_) / 2;
+            // Nodes of the nearest node rounding are the centers of the cells of the grid.
+            const auto half_n = rounding == GridRounding::Cell ? 2 * n : 2 * n - 1;
+            const auto half_m = rounding == GridRounding::Cell ? 2 * m : 2 * m - 1;
+            const auto node_x = exact_cast<f64>(half_n) * grid_.cell_size / 2.0;
+            const auto node_y = exact_cast<f64>(half_m) * grid_.cell_size / 2.0;
+            const auto d_x = exact_cast<f64>(step_(random_)) * 0x1p-6;
+            const auto d_y = exact_cast<f64>(step_(random_)) * 0x1p-6;
+            const Segment segment { node_x - d_x, node_y - d_y, node_x + d_x, node_y + d_y };
+            if (!valid_input(segment.a_x) || !valid_input(segment.a_y) || !valid_input(segment.b_x) ||
+                !valid_input(segment.b_y) || (d_x == 0.0 && d_y == 0.0))
+            {
+                continue;
+            }
+            const bool main_diagonal = (d_x >= 0.0 && d_y <= 0.0) || (d_x <= 0.0 && d_y >= 0.0);
+            result.push_back({ segment, n, main_diagonal ? m : m - 1 });
+        }
+        return result;
+    }
+
+    [[nodiscard]] bool valid_input(const f64 value) const noexcept
+    {
+        return value == 0.0 || (std::abs(value) >= grid_.min_input && std::abs(value) <= grid_.max_input);
+    }
+
+    [[nodiscard]] f64 node_coordinate()
+    {
+        // Coordinates of the nodes of the grid and of the half-size grid used by the nearest node rounding.
+        return exact_cast<f64>(node_(random_)) * grid_.cell_size / 2.0;
+    }
+
+    [[nodiscard]] Segment segment(const Distribution distribution)
+    {
+        switch (distribution)
+        {
+        case Distribution::Uniform:
+        {
+            const auto a_x = coordinate_(random_), a_y = coordinate_(random_);
+            return { a_x, a_y, a_x + length_(random_), a_y + length_(random_) };
+        }
+        case Distribution::NearInteger:
+        {
+            // The line passes through two grid nodes, so many of its intersections with borders are grid nodes too.
+            const auto a_x = node_coordinate(), a_y = node_coordinate();
+            const auto step_x = exact_cast<f64>(step_(random_)) * grid_.cell_size;
+            const auto step_y = exact_cast<f64>(step_(random_)) * grid_.cell_size;
+            return { a_x, a_y, a_x + step_x, a_y + step_y };
+        }
+        case Distribution::NearlyCollinear:
+        {
+            // The midpoint of the segment is exactly the computed grid node, which differs from the exact node only
+            // by rounding errors, so the floating-point filters can not decide.
+            const auto node_x = node_coordinate(), node_y = node_coordinate();
+            const auto d_x = exact_cast<f64>(step_(random_)) * 0x1p-6;
+            const auto d_y = exact_cast<f64>(step_(random_)) * 0x1p-6;
+            return { node_x - d_x, node_y - d_y, node_x + d_x, node_y + d_y };
+        }
+        }
+        return {};
+    }
+
+private:
+    GridParameters grid_;
+    std::mt19937_64 random_ { 42 };
+    std::uniform_real_distribution<f64> coordinate_ { -20037508.34, 20037508.34 };
+    std::uniform_real_distribution<f64> length_ { -100.0 * grid_.cell_size, 100.0 * grid_.cell_size };
+    std::uniform_real_distribution<f64> unit_ { 0.0, 1.0 };
+    std::uniform_int_distribution<s64> node_ { -3'000'000'000, 3'000'000'000 };
+    std::uniform_int_distribution<s64> step_ { -100, 100 };
+};
+
+} // namespace
+
+} // namespace ka
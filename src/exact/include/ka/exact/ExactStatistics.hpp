@@ -0,0 +1,48 @@
+#pragma once
+
+#include <ka/common/fixed.hpp>
+
+namespace ka
+{
+
+/// @brief Counters of the evaluation paths taken by the exact computations.
+/// Counters are collected only if the component is built with the EXACT_STATISTICS option, otherwise they are zero.
+/// A large share of the exact paths usually means that the grid parameters or the input data are unfortunate,
+/// e.g. the input range is too large for the floating-point filters to be reliable.
+struct ExactStatistics final
+{
+    /// @brief Number of line_intersects_cell checks decided by the floating-point filter.
+    u64 line_intersects_cell_filtered;
+    /// @brief Number of line_intersects_cell checks that required exact expansion arithmetic.
+    u64 line_intersects_cell_exact;
+    /// @brief Number of coordinates rounded to cells using only the floating-point quotient.
+    u64 cell_containing_position_filtered;
+    /// @brief Number of coordinates whose floating-point quotient is an integer and had to be checked exactly.
+    u64 cell_containing_position_exact;
+    /// @brief Number of border intersections whose fractional part is reliable.
+    u64 border_intersection_filtered;
+    /// @brief Number of border intersections rounded using exact expansion arithmetic.
+    u64 border_intersection_exact;
+    /// @brief Number of floating-point orientations decided by the plain floating-point determinant.
+    u64 orientation_filtered;
+    /// @brief Number of floating-point orientations decided by the intermediate adaptive stages.
+    u64 orientation_adapted;
+    /// @brief Number of floating-point orientations that required the exact determinant.
+    u64 orientation_exact;
+};
+
+/// @brief Checks whether the component is built with the statistics collection.
+[[nodiscard]] bool exact_statistics_enabled() noexcept;
+
+/// @brief Returns the counters collected by the calling thread.
+[[nodiscard]] ExactStatistics thread_exact_statistics() noexcept;
+
+/// @brief Resets the counters collected by the calling thread.
+void reset_thread_exact_statistics() noexcept;
+
+/// @brief Returns the sum of the counters collected by all threads, including finished ones.
+/// Counters of the running threads are read without stopping them, so the result is only a consistent snapshot
+/// when no other thread performs exact computations. Counters reset by reset_thread_exact_statistics are not included.
+[[nodiscard]] ExactStatistics total_exact_statistics() noexcept;
+
+} // namespace ka
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <bit>
+
 #include <ka/common/fixed.hpp>
 
 namespace ka
@@ -25,13 +27,25 @@ struct GridParameters final
     struct
     {
         /// @brief Smaller values of the fractional part do not guarantee correct rounding in the
-        /// column_border_intersecion.
+        /// column_border_intersecion for some allowed input.
+        /// The rounding is checked using the bound computed from the actual coordinates, which never exceeds this one.
         f64 min_reliable_fractional_part;
 
         /// @brief Larger values of the fractional part do not guarantee correct rounding in the
-        /// column_border_intersecion.
+        /// column_border_intersecion for some allowed input.
         f64 max_reliable_fractional_part;
     } column_border_intersecion;
 };
 
+/// @brief Checks that the cell size is a power of two, so the coordinates can be scaled by its inverse exactly.
+/// The sizes whose half or inverse are not normal numbers are rejected.
+/// Only the binary representation is inspected, so the result does not depend on floating-point flags.
+[[nodiscard]] constexpr bool has_power_of_two_cell_size(const GridParameters & grid) noexcept
+{
+    constexpr u64 mantissa_mask = (u64 { 1 } << 52) - 1;
+    const auto bits = std::bit_cast<u64>(grid.cell_size);
+    const auto biased_exponent = bits >> 52;
+    return (bits & mantissa_mask) == 0 && biased_exponent >= 2 && biased_exponent <= 2045;
+}
+
 } // namespace ka
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <ka/common/fixed.hpp>
+
+namespace ka
+{
+
+/// @brief Instruction set extensions used by the exact computations that have several implementations.
+/// Every next set includes the previous ones. All implementations give exactly the same results.
+enum class InstructionSet : u8
+{
+    /// @brief Instructions available on every target, exact products use Dekker's splitting.
+    Generic,
+    /// @brief Exact products use fused multiply-add.
+    Fma,
+    /// @brief Batch operations use 256-bit vectors.
+    Avx2,
+    /// @brief Batch operations use 512-bit vectors.
+    Avx512,
+};
+
+/// @brief Returns the best instruction set supported by the processor and by the build of the component.
+[[nodiscard]] InstructionSet supported_instruction_set() noexcept;
+
+/// @brief Returns the instruction set used by the exact computations.
+/// It is initialized with supported_instruction_set() when the first exact computation is performed.
+[[nodiscard]] InstructionSet exact_instruction_set() noexcept;
+
+/// @brief Selects the instruction set used by the exact computations in all threads, e.g. for testing.
+/// @pre instruction_set <= supported_instruction_set().
+void set_exact_instruction_set(InstructionSet instruction_set) noexcept;
+
+} // namespace ka
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <ka/common/fixed.hpp>
+
+namespace ka
+{
+
+/// @brief Parameters of the grid over fixed-point integer coordinates, e.g. degrees scaled by 10^7.
+/// The cell size is the rational number cell_size_numerator / cell_size_denominator in units of input coordinates,
+/// so all computations on such a grid are exact integer computations.
+struct IntegerGridParameters final
+{
+    /// @brief Maximal allowed absolute value of input coordinates, numerator and denominator of the cell size.
+    /// This bound guarantees the absence of overflows in 128-bit intermediate computations.
+    static constexpr s64 max_input = s64 { 1 } << 40;
+
+    /// @brief Numerator of the cell size.
+    s64 cell_size_numerator;
+
+    /// @brief Denominator of the cell size.
+    s64 cell_size_denominator;
+};
+
+} // namespace ka
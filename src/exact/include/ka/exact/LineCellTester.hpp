@@ -0,0 +1,75 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <span>
+
+#include <ka/common/fixed.hpp>
+#include <ka/exact/GridParameters.hpp>
+#include <ka/exact/GridRounding.hpp>
+#include <ka/geometry_types/Vec2.hpp>
+
+namespace ka
+{
+
+/// @brief Checks a single line for intersection with many cells of a regular grid.
+/// Same as line_intersects_cell, but the exact terms that depend only on the line are computed once, for the first
+/// cell that the floating-point filter can not decide. Most lines never need them.
+/// A single object must not be used by several threads at a time.
+/// @tparam rounding coordinates rounding mode.
+template <GridRounding rounding>
+class LineCellTester final
+{
+public:
+    /// @param grid parameters of the grid.
+    /// @param a_x, a_y coordinates of the first point on the line.
+    /// @param b_x, b_y coordinates of the second point on the line.
+    LineCellTester(const GridParameters & grid, f64 a_x, f64 a_y, f64 b_x, f64 b_y) noexcept;
+
+public:
+    /// @brief Checks the line for intersection with the cell.
+    /// @param c_x, c_y integer coordinates of the cell.
+    /// @return true if the line intersects the cell.
+    [[nodiscard]] bool intersects(s64 c_x, s64 c_y) const noexcept;
+
+    /// @brief Checks the line for intersection with each of the cells.
+    /// The floating-point filter checks the cells in batches by vector instructions,
+    /// and only the cells it can not decide are checked exactly.
+    /// @param cells integer coordinates of the cells.
+    /// @param result destination for the results, must have the same size as cells.
+    void intersects(std::span<const Vec2s64> cells, std::span<bool> result) const noexcept;
+
+private:
+    /// @brief Checks the line for intersection with the cell using exact expansion arithmetic.
+    [[nodiscard]] bool exact_intersects(s64 c_x, s64 c_y) const noexcept;
+
+    /// @brief Computes the exact terms if it is not done yet.
+    void compute_exact_terms() const noexcept;
+
+private:
+    f64 cell_size_;
+    /// @brief When signs are not inverted intersection requires first_determinant < 0 && second_determinant > 0.
+    bool invert_signs_;
+    bool main_diagonal_;
+    /// @brief Points on the line used by the floating-point filter.
+    f64 a_x_;
+    f64 a_y_;
+    f64 b_x_;
+    f64 b_y_;
+    /// @brief Whether the exact terms below are computed.
+    mutable bool has_exact_terms_ = false;
+    /// @brief a_x - b_x in the form of a 2-component non-adjacent expansion.
+    mutable std::array<f64, 2> dx_;
+    /// @brief a_y - b_y in the form of a 2-component non-adjacent expansion.
+    mutable std::array<f64, 2> dy_;
+    /// @brief Cell independent part of the first determinant.
+    mutable std::array<f64, 4> first_common_term_;
+    /// @brief Number of nonzero components of first_common_term_.
+    mutable size_t first_common_term_size_;
+    /// @brief Cell independent part of the second determinant.
+    mutable std::array<f64, 12> second_common_term_;
+    /// @brief Number of nonzero components of second_common_term_.
+    mutable size_t second_common_term_size_;
+};
+
+} // namespace ka
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <utility>
+
+#include <ka/common/fixed.hpp>
+#include <ka/exact/GridParameters.hpp>
+#include <ka/exact/GridRounding.hpp>
+
+namespace ka
+{
+
+/// @brief Finds the intersections of a single segment with many column and row borders of a regular grid.
+/// Same as border_between_coordinates, column_border_intersection and row_border_intersection,
+/// but the exact terms that depend only on the segment are computed once, on the first intersection
+/// whose floating-point result is not reliable. Most segments never need them.
+/// A single object must not be used by several threads at a time.
+/// @tparam rounding coordinates rounding mode.
+template <GridRounding rounding>
+class SegmentBorderCrossings final
+{
+public:
+    /// @param grid parameters of the grid, they must outlive the object.
+    /// @param a_x, a_y coordinates of the first endpoint of the segment.
+    /// @param b_x, b_y coordinates of the second endpoint of the segment.
+    SegmentBorderCrossings(const GridParameters & grid, f64 a_x, f64 a_y, f64 b_x, f64 b_y) noexcept;
+
+public:
+    /// @brief Returns the range of columns whose main borders lie between the segment endpoints (inclusive).
+    /// @return A pair of minimum and maximum column coordinates.
+    /// If the first value of a pair is greater than the second, then the segment does not cross column borders.
+    [[nodiscard]] std::pair<s64, s64> column_borders() const noexcept;
+
+    /// @brief Same as column_borders but for rows.
+    [[nodiscard]] std::pair<s64, s64> row_borders() const noexcept;
+
+    /// @brief Finds the row containing the intersection point of the segment and the left border of the column.
+    /// @param c_x integer X coordinate of the column, must be in the column_borders range.
+    /// @return The Y coordinate of the found row.
+    [[nodiscard]] s64 column_border_intersection(s64 c_x) const noexcept;
+
+    /// @brief Finds the column containing the intersection point of the segment and the bottom border of the row.
+    /// @param c_y integer Y coordinate of the row, must be in the row_borders range.
+    /// @return The X coordinate of the found column.
+    [[nodiscard]] s64 row_border_intersection(s64 c_y) const noexcept;
+
+private:
+    /// @brief Column independent terms of the column border intersection.
+    /// Row border intersections are found as column border intersections of the segment rotated by 90 degrees.
+    struct AxisTerms final
+    {
+        f64 a_x;
+        f64 a_y;
+        f64 b_x;
+        f64 b_y;
+        /// @brief Whether the expansions below are computed.
+        bool has_expansions = false;
+        /// @brief a_y * b_x - a_x * b_y in the form of a non-adjacent expansion.
+        std::array<f64, 4> numerator;
+        size_t numerator_size;
+        /// @brief size * (b_y - a_y) in the form of a non-adjacent expansion.
+        std::array<f64, 4> size_dy;
+        size_t size_dy_size;
+        /// @brief size * (b_x - a_x) in the form of a non-adjacent expansion.
+        std::array<f64, 4> denominator;
+        size_t denominator_size;
+    };
+
+    [[nodiscard]] static AxisTerms axis_terms(f64 a_x, f64 a_y, f64 b_x, f64 b_y) noexcept;
+
+    /// @brief Computes the expansions of the terms if it is not done yet.
+    static void compute_expansions(f64 size, AxisTerms & terms) noexcept;
+
+    /// @brief Finds the intersection with the column border in the internally used cells.
+    [[nodiscard]] s64 axis_border_intersection(AxisTerms & terms, s64 border) const noexcept;
+
+private:
+    const GridParameters & grid_;
+    /// @brief Size of the cells used internally, for snapping to grid nodes it is a half of the cell size.
+    f64 size_;
+    std::pair<s64, s64> column_borders_;
+    std::pair<s64, s64> row_borders_;
+    mutable AxisTerms column_terms_;
+    mutable AxisTerms row_terms_;
+};
+
+} // namespace ka
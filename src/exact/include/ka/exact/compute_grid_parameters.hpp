@@ -0,0 +1,32 @@
+#pragma once
+
+#include <ka/common/fixed.hpp>
+#include <ka/exact/GridParameters.hpp>
+
+namespace ka
+{
+
+/// @brief Description of the world covered by the grid, same as the arguments of ka_generate_grid.
+struct GridDescription final
+{
+    /// @brief The size of the world in grid cells.
+    f64 world_cells;
+
+    /// @brief The physical size of the world, e.g. the length of the equator for EPSG:3857.
+    f64 world_size;
+
+    /// @brief For each input coordinate |coordinate| >= min_world_coordinate or coordinate == 0.
+    f64 min_world_coordinate;
+
+    /// @brief For each input coordinate |coordinate| <= max_world_coordinate.
+    f64 max_world_coordinate;
+};
+
+/// @brief Computes the parameters of the grid at runtime.
+/// The result is exactly the same as the constants generated by ka_generate_grid for the same description,
+/// every operation is rounded in the safe direction.
+/// @param description description of the world.
+/// @return Parameters of the grid with the minimal allowed cell size world_size / world_cells rounded down.
+[[nodiscard]] GridParameters compute_grid_parameters(const GridDescription & description) noexcept;
+
+} // namespace ka
@@ -1,8 +1,12 @@
 #pragma once
 
+#include <span>
+#include <utility>
+
 #include <ka/common/fixed.hpp>
 #include <ka/exact/GridParameters.hpp>
 #include <ka/exact/GridRounding.hpp>
+#include <ka/geometry_types/Vec2.hpp>
 
 namespace ka
 {
@@ -36,10 +40,50 @@ template <GridRounding rounding>
 template <GridRounding rounding>
 [[nodiscard]] s64 row_containing_position(const GridParameters & grid, f64 y) noexcept;
 
+/// @brief Finds the cells of a regular grid that contain the given points.
+/// Equivalent to calling column_containing_position and row_containing_position for every point,
+/// but rounds points in batches that allow the compiler to vectorize the computations.
+/// @param grid parameters of the grid.
+/// @param points coordinates of the points.
+/// @param cells destination for the found cells, must have the same size as points.
+/// @tparam rounding coordinates rounding mode.
+template <GridRounding rounding>
+void cells_containing_points(
+    const GridParameters & grid,
+    std::span<const Vec2f64> points,
+    std::span<Vec2s64> cells) noexcept;
+
+/// @brief Same as column_containing_position, but the cell size must be a power of two,
+/// see has_power_of_two_cell_size. The coordinate is scaled by the inverse of the cell size exactly,
+/// so neither division nor the exact check of the result is needed.
+/// @param grid parameters of the grid.
+/// @param x coordinate of the point, zero or not less than grid.min_input in absolute value.
+/// @tparam rounding coordinates rounding mode.
+/// @return Index of the fount column.
+template <GridRounding rounding>
+[[nodiscard]] s64 column_containing_position_power_of_two(const GridParameters & grid, f64 x) noexcept;
+
+/// @brief Same as column_containing_position_power_of_two but for rows.
+template <GridRounding rounding>
+[[nodiscard]] s64 row_containing_position_power_of_two(const GridParameters & grid, f64 y) noexcept;
+
+/// @brief Same as cells_containing_points, but the cell size must be a power of two,
+/// see column_containing_position_power_of_two.
+template <GridRounding rounding>
+void cells_containing_points_power_of_two(
+    const GridParameters & grid,
+    std::span<const Vec2f64> points,
+    std::span<Vec2s64> cells) noexcept;
+
 /// @brief Checks that the main boundary of a column or row lies between coordinates.
 /// @return a <= size * n <= b.
 [[nodiscard]] bool border_between_coordinates(const f64 cell_size, f64 a, f64 b, s64 x) noexcept;
 
+/// @brief Finds all main boundaries of columns or rows that lie between coordinates.
+/// @return A pair of minimum and maximum n such that min(a, b) <= size * n <= max(a, b).
+/// If the first value of a pair is greater than the second, then there is no such boundaries.
+[[nodiscard]] std::pair<s64, s64> borders_between_coordinates(const f64 cell_size, f64 a, f64 b) noexcept;
+
 /// @brief Finds the row containing the intersection point
 /// of a given line and the left border of a regular grid column.
 /// @param grid parameters of the grid.
@@ -74,4 +118,49 @@ template <GridRounding rounding>
     f64 b_y,
     s64 c_y) noexcept;
 
+/// @brief Finds the columns containing the given coordinate in all levels of a grid pyramid.
+/// The cell size of the level i is 2^i * grid.cell_size. Only the finest level is computed exactly,
+/// the other levels are derived from it by exact integer shifts.
+/// @param grid parameters of the finest grid.
+/// @param x coordinate of the point.
+/// @param columns destination for the columns of all levels, must contain from 1 to 63 levels.
+/// @tparam rounding coordinates rounding mode.
+template <GridRounding rounding>
+void column_containing_position_pyramid(const GridParameters & grid, f64 x, std::span<s64> columns) noexcept;
+
+/// @brief Same as column_containing_position_pyramid but for rows.
+template <GridRounding rounding>
+void row_containing_position_pyramid(const GridParameters & grid, f64 y, std::span<s64> rows) noexcept;
+
+/// @brief Finds the rows containing the intersection point of a given line and the left border of a column
+/// in all levels of a grid pyramid, see column_containing_position_pyramid.
+/// The border of the column c_x >> i of the level i lies on the border of the column c_x of the finest level,
+/// so only one intersection is computed exactly.
+/// @param grid parameters of the finest grid.
+/// @param a_x, a_y coordinates of the first point on the line.
+/// @param b_x, b_y coordinates of the second point on the line.
+/// @param c_x integer X coordinate of the column of the finest level, must be divisible by 2^(rows.size() - 1).
+/// @param rows destination for the Y coordinates of the found rows of all levels.
+/// @tparam rounding coordinates rounding mode.
+template <GridRounding rounding>
+void column_border_intersection_pyramid(
+    const GridParameters & grid,
+    f64 a_x,
+    f64 a_y,
+    f64 b_x,
+    f64 b_y,
+    s64 c_x,
+    std::span<s64> rows) noexcept;
+
+/// @brief Same as column_border_intersection_pyramid but for the bottom borders of rows.
+template <GridRounding rounding>
+void row_border_intersection_pyramid(
+    const GridParameters & grid,
+    f64 a_x,
+    f64 a_y,
+    f64 b_x,
+    f64 b_y,
+    s64 c_y,
+    std::span<s64> columns) noexcept;
+
 } // namespace ka
@@ -1,8 +1,10 @@
 #pragma once
 
 #include <concepts>
+#include <span>
 
 #include <ka/common/fixed.hpp>
+#include <ka/geometry_types/Vec2.hpp>
 
 namespace ka
 {
@@ -10,23 +12,47 @@ namespace ka
 namespace detail
 {
 
+template <typename I>
+concept OrientationInteger =
+    std::same_as<I, u16> || std::same_as<I, s16> || std::same_as<I, s32> || std::same_as<I, s64>;
+
 template <ieee_float F>
     requires std::same_as<F, f32> || std::same_as<F, f64>
 [[nodiscard]] F orientation_impl(F a_x, F a_y, F b_x, F b_y, F c_x, F c_y) noexcept;
 
-template <std::integral I>
-    requires std::same_as<I, u16> || std::same_as<I, s16>
+template <OrientationInteger I>
 [[nodiscard]] s64 orientation_impl(I a_x, I a_y, I b_x, I b_y, I c_x, I c_y) noexcept;
 
+template <OrientationInteger I>
+void orientations_impl(I a_x, I a_y, I b_x, I b_y, std::span<const Vec2<I>> points, std::span<s64> results) noexcept;
+
 } // namespace detail
 
 /// @brief Computes the orientation of three ordered points (a, b, c).
 /// @return Positive value if points are counter-clockwise (left turn), zero if collinear, negative if clockwise (right
 /// turn).
+/// @note The determinant of s32 and s64 coordinates may not fit into s64, so only its sign is returned: -1, 0 or 1.
 template <typename T>
 [[nodiscard]] auto orientation(const T a_x, const T a_y, const T b_x, const T b_y, const T c_x, const T c_y) noexcept
 {
     return detail::orientation_impl(a_x, a_y, b_x, b_y, c_x, c_y);
 }
 
+/// @brief Computes the orientations of the line through a and b and every point, see orientation().
+/// The differences of the line coordinates are computed once for all points.
+/// @param points points c of the orientation triples.
+/// @param results orientations of the triples (a, b, points[i]).
+/// @pre points.size() == results.size().
+template <detail::OrientationInteger T>
+void orientations(
+    const T a_x,
+    const T a_y,
+    const T b_x,
+    const T b_y,
+    const std::span<const Vec2<T>> points,
+    const std::span<s64> results) noexcept
+{
+    detail::orientations_impl(a_x, a_y, b_x, b_y, points, results);
+}
+
 } // namespace ka
@@ -5,6 +5,7 @@
 #include <span>
 
 #include <ka/common/fixed.hpp>
+#include <ka/exact/GridRounding.hpp>
 
 namespace ka
 {
@@ -24,6 +25,13 @@ template <typename T, size_t E>
     return std::span<const T, E> { array };
 }
 
+/// @brief Span of the first size elements of the array, e.g. components of a zero-eliminated expansion.
+template <typename T, size_t E>
+[[nodiscard]] constexpr auto const_span(const std::array<T, E> & array, const size_t size) noexcept
+{
+    return std::span<const T> { array }.first(size);
+}
+
 [[nodiscard]] [[maybe_unused]] constexpr s64 half_cell_to_nearest_full_cell(const s64 value) noexcept
 {
     if (value >= -1)
@@ -42,6 +50,60 @@ static_assert(half_cell_to_nearest_full_cell(0) == 0);
 static_assert(half_cell_to_nearest_full_cell(1) == 1);
 static_assert(half_cell_to_nearest_full_cell(2) == 1);
 
+/// @brief Maximal number of levels of a grid pyramid, so that the cell sizes differ by at most 2^62.
+constexpr size_t g_max_pyramid_levels = 63;
+
+/// @brief Finds the cell of the given pyramid level from the cell of the finest level.
+/// The cell size of the level is 2^level times larger, so the cell is found by rounding the quotient down.
+[[nodiscard]] [[maybe_unused]] constexpr s64 finest_cell_to_level_cell(const s64 cell, const size_t level) noexcept
+{
+    return cell >> level;
+}
+
+/// @brief Finds the nearest node of the given pyramid level from the half cell of the finest level.
+/// The nearest node of the finest level does not determine nodes of the other levels, but the half cell does:
+/// floor(h / 2^(level + 1) + 1 / 2) = floor((h + 2^level) / 2^(level + 1)) for an integer h.
+[[nodiscard]] [[maybe_unused]] constexpr s64 finest_half_cell_to_level_node(const s64 half_cell, const size_t level)
+    noexcept
+{
+    return (half_cell + (s64 { 1 } << level)) >> (level + 1);
+}
+
+static_assert(finest_cell_to_level_cell(-1, 3) == -1);
+static_assert(finest_cell_to_level_cell(-8, 3) == -1);
+static_assert(finest_cell_to_level_cell(-9, 3) == -2);
+static_assert(finest_half_cell_to_level_node(-5, 0) == half_cell_to_nearest_full_cell(-5));
+static_assert(finest_half_cell_to_level_node(-2, 0) == half_cell_to_nearest_full_cell(-2));
+static_assert(finest_half_cell_to_level_node(-1, 0) == half_cell_to_nearest_full_cell(-1));
+static_assert(finest_half_cell_to_level_node(2, 0) == half_cell_to_nearest_full_cell(2));
+// Nodes of the level 1 are at the even full cells of the finest level, the half cells [-6, -3] are rounded to -1.
+static_assert(finest_half_cell_to_level_node(-7, 1) == -2);
+static_assert(finest_half_cell_to_level_node(-6, 1) == -1);
+static_assert(finest_half_cell_to_level_node(-3, 1) == -1);
+static_assert(finest_half_cell_to_level_node(-2, 1) == 0);
+static_assert(finest_half_cell_to_level_node(1, 1) == 0);
+static_assert(finest_half_cell_to_level_node(2, 1) == 1);
+
+/// @brief Fills the cells of all levels of a grid pyramid.
+/// @param finest cell of the finest level for the cell rounding or its half cell for the nearest node rounding.
+/// @param levels destination, the cell size of the level i is 2^i times the cell size of the finest level.
+template <GridRounding rounding>
+[[maybe_unused]] constexpr void finest_to_pyramid(const s64 finest, const std::span<s64> levels) noexcept
+{
+    for (size_t level = 0; level < levels.size(); ++level)
+    {
+        switch (rounding)
+        {
+        case GridRounding::Cell:
+            levels[level] = finest_cell_to_level_cell(finest, level);
+            break;
+        case GridRounding::NearestNode:
+            levels[level] = finest_half_cell_to_level_node(finest, level);
+            break;
+        }
+    }
+}
+
 } // namespace
 
 } // namespace ka
@@ -0,0 +1,57 @@
+#include <atomic>
+
+#include <ka/common/assert.hpp>
+#include <ka/exact/InstructionSet.hpp>
+
+#include "dispatch.hpp"
+
+namespace ka
+{
+
+inline namespace
+{
+
+/// @brief The instruction set is initialized on first use, so it is valid during the static initialization.
+[[nodiscard]] std::atomic<InstructionSet> & selected_instruction_set() noexcept
+{
+    static std::atomic<InstructionSet> instruction_set { supported_instruction_set() };
+    return instruction_set;
+}
+
+} // namespace
+
+InstructionSet supported_instruction_set() noexcept
+{
+#ifdef KA_EXACT_MULTIVERSIONING
+    // The checks include the support of the extended registers by the operating system.
+    __builtin_cpu_init();
+    if (!__builtin_cpu_supports("fma"))
+    {
+        return InstructionSet::Generic;
+    }
+    if (!__builtin_cpu_supports("avx2"))
+    {
+        return InstructionSet::Fma;
+    }
+    if (!__builtin_cpu_supports("avx512f"))
+    {
+        return InstructionSet::Avx2;
+    }
+    return InstructionSet::Avx512;
+#else
+    return InstructionSet::Generic;
+#endif
+}
+
+InstructionSet exact_instruction_set() noexcept
+{
+    return selected_instruction_set().load(std::memory_order_relaxed);
+}
+
+void set_exact_instruction_set(const InstructionSet instruction_set) noexcept
+{
+    AR_PRE(instruction_set <= supported_instruction_set());
+    selected_instruction_set().store(instruction_set, std::memory_order_relaxed);
+}
+
+} // namespace ka
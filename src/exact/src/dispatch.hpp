@@ -0,0 +1,36 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include <ka/exact/InstructionSet.hpp>
+
+/// Implementations for instruction set extensions are compiled using function attributes rather than compiler flags
+/// of separate translation units. So the floating-point flags of the component apply to all of them, and inline
+/// functions shared with the generic code are never compiled with the extended instruction set.
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define KA_EXACT_MULTIVERSIONING
+/// @brief Compiles the function for the given extensions and inlines all its calls,
+/// so that the extensions are used by the inlined helpers too.
+#define KA_EXACT_TARGET(extensions) __attribute__((target(extensions), flatten))
+#else
+#define KA_EXACT_TARGET(extensions)
+#endif
+
+namespace ka
+{
+
+constexpr size_t g_instruction_set_count = 4;
+
+/// @brief Table of implementations of a function indexed by InstructionSet.
+template <typename Function>
+using Implementations = std::array<Function *, g_instruction_set_count>;
+
+/// @brief Selects the implementation for the instruction set used by the exact computations.
+template <typename Function>
+[[nodiscard]] Function * select(const Implementations<Function> & implementations) noexcept
+{
+    return implementations[static_cast<size_t>(exact_instruction_set())];
+}
+
+} // namespace ka
@@ -9,6 +9,7 @@
 #pragma once
 
 #include <algorithm>
+#include <cmath>
 #include <concepts>
 #include <span>
 
@@ -287,6 +288,128 @@ constexpr void fast_expansion_difference(
     fast_expansion_sum_impl<-1>(lhs, rhs, result);
 }
 
+/// @brief Computes lhs + sign * rhs eliminating zero components.
+template <int sign, std::floating_point T, size_t LSize, size_t RSize, size_t Capacity>
+[[nodiscard]] constexpr size_t fast_expansion_sum_zeroelim_impl(
+    const std::span<const T, LSize> lhs,
+    const std::span<const T, RSize> rhs,
+    const std::span<T, Capacity> result) noexcept
+{
+    if constexpr (LSize != std::dynamic_extent && RSize != std::dynamic_extent && Capacity != std::dynamic_extent)
+    {
+        static_assert(Capacity >= LSize + RSize);
+    }
+    AR_PRE(result.size() >= lhs.size() + rhs.size());
+
+    size_t result_size = 0;
+    const auto append = [&](const T component)
+    {
+        if (component != 0)
+        {
+            result[result_size++] = component;
+        }
+    };
+    if (lhs.empty() || rhs.empty())
+    {
+        for (const auto component : lhs)
+        {
+            append(component);
+        }
+        for (const auto component : rhs)
+        {
+            append(sign * component);
+        }
+        return result_size;
+    }
+
+    // Checks that |a| < |b|.
+    const auto increasing = [](const auto a, const auto b) noexcept
+    {
+        return (a < b) == (-a < b);
+    };
+    auto lhs_it = lhs.begin();
+    auto rhs_it = rhs.begin();
+    const auto next_merged = [&]()
+    {
+        if (increasing(*lhs_it, sign * *rhs_it))
+        {
+            return *lhs_it++;
+        }
+        else
+        {
+            return sign * *rhs_it++;
+        }
+    };
+
+    auto sum = next_merged();
+    if (lhs_it != lhs.end() && rhs_it != rhs.end())
+    {
+        const TwoExpansion sum_err = fast_two_sum(next_merged(), sum);
+        append(sum_err.err());
+        sum = sum_err.approx();
+    }
+    while (lhs_it != lhs.end() && rhs_it != rhs.end())
+    {
+        const TwoExpansion sum_err = two_sum(sum, next_merged());
+        append(sum_err.err());
+        sum = sum_err.approx();
+    }
+    while (lhs_it != lhs.end())
+    {
+        const TwoExpansion sum_err = two_sum(sum, *lhs_it++);
+        append(sum_err.err());
+        sum = sum_err.approx();
+    }
+    while (rhs_it != rhs.end())
+    {
+        const TwoExpansion sum_err = two_sum(sum, sign * *rhs_it++);
+        append(sum_err.err());
+        sum = sum_err.approx();
+    }
+    append(sum);
+    return result_size;
+}
+
+/// @brief Sum of two strongly nonoverlapping expansions with elimination of zero components.
+/// Same as fast_expansion_sum, but zero components are not written to the result.
+/// Input expansions may have any number of components including zero.
+/// [Shewchuk]
+/// @pre Round-to-even tiebreaking is used.
+/// @pre result.size() >= lhs.size() + rhs.size().
+/// @return Number of components written to the result, zero if the sum is zero.
+/// @tparam T type of expansion components.
+/// @tparam LSize number of the lhs components.
+/// @tparam RSize number of the rhs components.
+/// @tparam Capacity maximal number of the result components.
+template <std::floating_point T, size_t LSize, size_t RSize, size_t Capacity>
+[[nodiscard]] constexpr size_t fast_expansion_sum_zeroelim(
+    const std::span<const T, LSize> lhs,
+    const std::span<const T, RSize> rhs,
+    const std::span<T, Capacity> result) noexcept
+{
+    return fast_expansion_sum_zeroelim_impl<+1>(lhs, rhs, result);
+}
+
+/// @brief Difference of two strongly nonoverlapping expansions with elimination of zero components.
+/// Same as fast_expansion_difference, but zero components are not written to the result.
+/// Input expansions may have any number of components including zero.
+/// [Shewchuk]
+/// @pre Round-to-even tiebreaking is used.
+/// @pre result.size() >= lhs.size() + rhs.size().
+/// @return Number of components written to the result, zero if the difference is zero.
+/// @tparam T type of expansion components.
+/// @tparam LSize number of the lhs components.
+/// @tparam RSize number of the rhs components.
+/// @tparam Capacity maximal number of the result components.
+template <std::floating_point T, size_t LSize, size_t RSize, size_t Capacity>
+[[nodiscard]] constexpr size_t fast_expansion_difference_zeroelim(
+    const std::span<const T, LSize> lhs,
+    const std::span<const T, RSize> rhs,
+    const std::span<T, Capacity> result) noexcept
+{
+    return fast_expansion_sum_zeroelim_impl<-1>(lhs, rhs, result);
+}
+
 /// @brief The result of a split operation.
 /// @invariant |hi| > |lo|.
 template <std::floating_point T>
@@ -309,16 +432,31 @@ template <u8 S, std::floating_point T>
     return { hi, lo };
 }
 
+/// @brief Algorithm computing the roundoff error of a product.
+enum class TwoProduct
+{
+    /// @brief Dekker's splitting using only the basic operations.
+    Split,
+    /// @brief A single fused multiply-add, fast only if it is supported by the target.
+    Fused,
+};
+
 /// @brief Product of two numbers.
 /// Preserves nonoverlapping property.
 /// Preserves nonadjacent property if round-to-even tiebreaking is used.
 /// [Shewchuk]
+/// @tparam algorithm algorithm computing the roundoff error, both give the same result.
 /// @tparam T type of expansion components.
-template <std::floating_point T>
+template <TwoProduct algorithm = TwoProduct::Split, std::floating_point T>
 [[nodiscard]] constexpr std::array<T, 2> two_product(const T lhs, const T rhs)
 {
-    constexpr auto split_point = (std::numeric_limits<T>::digits + 1) / 2;
     const auto approx = lhs * rhs;
+    if constexpr (algorithm == TwoProduct::Fused)
+    {
+        return { std::fma(lhs, rhs, -approx), approx };
+    }
+
+    constexpr auto split_point = (std::numeric_limits<T>::digits + 1) / 2;
     const auto a = split<split_point>(lhs);
     const auto b = split<split_point>(rhs);
     auto err = approx - a.hi * b.hi;
@@ -332,9 +470,10 @@ template <std::floating_point T>
 /// Preserves nonoverlapping property.
 /// Preserves nonadjacent property if round-to-even tiebreaking is used.
 /// [Shewchuk]
+/// @tparam algorithm algorithm of two_product.
 /// @tparam T type of expansion components.
 /// @tparam Size number of expansion components.
-template <std::floating_point T, size_t Size>
+template <TwoProduct algorithm = TwoProduct::Split, std::floating_point T, size_t Size>
 constexpr void scale_expansion(
     const std::span<const T, Size> expansion,
     const T number,
@@ -342,12 +481,12 @@ constexpr void scale_expansion(
 {
     auto result_it = result.begin();
 
-    TwoExpansion prod_err = two_product(expansion.front(), number);
+    TwoExpansion prod_err = two_product<algorithm>(expansion.front(), number);
     *result_it++ = prod_err.err();
 
     for (size_t i = 1; i < expansion.size(); ++i)
     {
-        const TwoExpansion t = two_product(expansion[i], number);
+        const TwoExpansion t = two_product<algorithm>(expansion[i], number);
         prod_err = two_sum(prod_err.approx(), t.err());
         *result_it++ = prod_err.err();
         prod_err = fast_two_sum(t.approx(), prod_err.approx());
@@ -356,6 +495,72 @@ constexpr void scale_expansion(
     *result_it++ = prod_err.approx();
 }
 
+/// @brief Product of expansion and number with elimination of zero components.
+/// Same as scale_expansion, but zero components are not written to the result.
+/// Input expansion may have any number of components including zero.
+/// [Shewchuk]
+/// @pre result.size() >= 2 * expansion.size().
+/// @return Number of components written to the result, zero if the product is zero.
+/// @tparam algorithm algorithm of two_product.
+/// @tparam T type of expansion components.
+/// @tparam Size number of expansion components.
+/// @tparam Capacity maximal number of the result components.
+template <TwoProduct algorithm = TwoProduct::Split, std::floating_point T, size_t Size, size_t Capacity>
+[[nodiscard]] constexpr size_t scale_expansion_zeroelim(
+    const std::span<const T, Size> expansion,
+    const T number,
+    const std::span<T, Capacity> result) noexcept
+{
+    if constexpr (Size != std::dynamic_extent && Capacity != std::dynamic_extent)
+    {
+        static_assert(Capacity >= 2 * Size);
+    }
+    AR_PRE(result.size() >= 2 * expansion.size());
+
+    if (expansion.empty())
+    {
+        return 0;
+    }
+
+    size_t result_size = 0;
+    const auto append = [&](const T component)
+    {
+        if (component != 0)
+        {
+            result[result_size++] = component;
+        }
+    };
+
+    TwoExpansion prod_err = two_product<algorithm>(expansion.front(), number);
+    append(prod_err.err());
+
+    for (size_t i = 1; i < expansion.size(); ++i)
+    {
+        const TwoExpansion t = two_product<algorithm>(expansion[i], number);
+        prod_err = two_sum(prod_err.approx(), t.err());
+        append(prod_err.err());
+        prod_err = fast_two_sum(t.approx(), prod_err.approx());
+        append(prod_err.err());
+    }
+    append(prod_err.approx());
+    return result_size;
+}
+
+/// @brief Approximates the value of the expansion by the sum of its components.
+/// [Shewchuk]
+/// @tparam T type of expansion components.
+/// @tparam Size number of expansion components.
+template <typename T, size_t Size>
+[[nodiscard]] constexpr T expansion_estimate(const std::span<const T, Size> expansion) noexcept
+{
+    T result {};
+    for (const auto component : expansion)
+    {
+        result += component;
+    }
+    return result;
+}
+
 /// @brief Finds leading non-zero component of the expansion.
 /// @tparam T type of expansion components.
 /// @tparam Size number of expansion components.
@@ -1,4 +1,7 @@
+#include <algorithm>
+#include <cmath>
 #include <functional>
+#include <utility>
 
 #include <ka/common/assert.hpp>
 #include <ka/common/cast.hpp>
@@ -11,16 +14,24 @@
 namespace ka
 {
 
+inline namespace
+{
+
+/// @brief Compares the border s * n with the coordinate x exactly.
+template <typename Compare>
+[[nodiscard]] bool compare_border_and_coordinate(const f64 s, const s64 n, const f64 x, const Compare cmp) noexcept
+{
+    std::array<f64, 3> fms;
+    const auto tmp = two_product(exact_cast<f64>(n), s);
+    grow_expansion(const_span(tmp), -x, span(fms));
+    return cmp(expansion_approx(const_span(fms)), 0.0);
+}
+
+} // namespace
+
 bool border_between_coordinates(const f64 cell_size, const f64 a, const f64 b, const s64 x) noexcept
 {
     AR_PRE(a != b);
-    const auto compare_border_and_coordinate = [](const f64 s, const s64 n, const f64 x, const auto cmp)
-    {
-        std::array<f64, 3> fms;
-        const auto tmp = two_product(exact_cast<f64>(n), s);
-        grow_expansion(const_span(tmp), -x, span(fms));
-        return cmp(expansion_approx(const_span(fms)), 0.0);
-    };
     if (a < b)
     {
         return compare_border_and_coordinate(cell_size, x, a, std::greater_equal<f64> {}) &&
@@ -33,4 +44,33 @@ bool border_between_coordinates(const f64 cell_size, const f64 a, const f64 b, c
     }
 }
 
+std::pair<s64, s64> borders_between_coordinates(const f64 cell_size, const f64 a, const f64 b) noexcept
+{
+    AR_PRE(cell_size > 0.0);
+    const auto [min, max] = std::minmax(a, b);
+
+    // The quotients are approximations that are corrected using exact comparisons.
+    auto first = exact_cast<s64>(std::ceil(min / cell_size));
+    while (compare_border_and_coordinate(cell_size, first, min, std::less<f64> {}))
+    {
+        ++first;
+    }
+    while (compare_border_and_coordinate(cell_size, first - 1, min, std::greater_equal<f64> {}))
+    {
+        --first;
+    }
+
+    auto last = exact_cast<s64>(std::floor(max / cell_size));
+    while (compare_border_and_coordinate(cell_size, last, max, std::greater<f64> {}))
+    {
+        --last;
+    }
+    while (compare_border_and_coordinate(cell_size, last + 1, max, std::less_equal<f64> {}))
+    {
+        ++last;
+    }
+
+    return { first, last };
+}
+
 } // namespace ka
@@ -1,25 +1,132 @@
+#include <algorithm>
+#include <array>
 #include <cmath>
+#include <span>
+#include <utility>
 
 #include <ka/common/assert.hpp>
 #include <ka/common/cast.hpp>
 #include <ka/common/fixed.hpp>
+#include <ka/exact/SegmentBorderCrossings.hpp>
 #include <ka/exact/grid.hpp>
 
 #include "../expansion.hpp"
 #include "../common.hpp"
+#include "../statistics.hpp"
 
 namespace ka
 {
 
+inline namespace
+{
+
+namespace border_intersection
+{
+
+/// @brief Column independent part of the numerator in the form of a non-adjacent expansion of at most 4 components.
+/// @return Number of components.
+[[nodiscard]] inline size_t numerator_term(
+    const f64 a_x,
+    const f64 a_y,
+    const f64 b_x,
+    const f64 b_y,
+    const std::span<f64, 4> term) noexcept
+{
+    /// a_y * b_x - a_x * b_y
+    return fast_expansion_difference_zeroelim(
+        const_span(two_product(a_y, b_x)),
+        const_span(two_product(a_x, b_y)),
+        term);
+}
+
+/// @brief size * (b_y - a_y) in the form of a non-adjacent expansion of at most 4 components.
+/// @return Number of components.
+[[nodiscard]] inline size_t size_dy_term(
+    const f64 size,
+    const f64 a_y,
+    const f64 b_y,
+    const std::span<f64, 4> term) noexcept
+{
+    return scale_expansion_zeroelim(const_span(two_diff(b_y, a_y)), size, term);
+}
+
+/// @brief size * (b_x - a_x) in the form of a non-adjacent expansion of at most 4 components.
+/// @return Number of components.
+[[nodiscard]] inline size_t denominator_term(
+    const f64 size,
+    const f64 a_x,
+    const f64 b_x,
+    const std::span<f64, 4> term) noexcept
+{
+    return scale_expansion_zeroelim(const_span(two_diff(b_x, a_x)), size, term);
+}
+
+/// @brief Bound of the absolute error of the intersection computed by column_border_intersecion_impl,
+/// measured in cell sizes.
+/// The border lies between a_x and b_x, so the exact parameter t = (c_x * size - a_x) / (b_x - a_x) is in [0, 1].
+/// The computed t has relative error of at most 3u, and (b_y - a_y) * t accumulates 5u. The sum with a_y and
+/// the division by size add u each of the values bounded by Y = max(|a_y|, |b_y|). So the error does not exceed
+/// (5u * 2Y + 2uY) / size + O(u^2), and the remaining 2uY / size cover the higher order terms and the roundoff
+/// of the bound itself. Unlike the precomputed GridParameters::column_border_intersecion the bound does not
+/// depend on the largest allowed coordinate.
+[[nodiscard]] inline f64 intersection_error_bound(const f64 size, const f64 a_y, const f64 b_y) noexcept
+{
+    constexpr f64 unit_roundoff = 0x1p-53;
+    return 14.0 * unit_roundoff * std::max(std::abs(a_y), std::abs(b_y)) / size;
+}
+
+/// @brief Checks if a value can be the result of rounding a quotient towards negative infinity.
+/// @param numerator_1 expansion of at most 4 components.
+/// @param size_dy expansion of at most 4 components.
+/// @param denominator expansion of at most 4 components.
+[[nodiscard]] inline bool check_value(
+    const f64 value,
+    const s64 c_x,
+    const bool positive_denominator,
+    const std::span<const f64> numerator_1,
+    const std::span<const f64> size_dy,
+    const std::span<const f64> denominator) noexcept
+{
+    AR_PRE(numerator_1.size() <= 4);
+    AR_PRE(size_dy.size() <= 4);
+    AR_PRE(denominator.size() <= 4);
+
+    /// c_x * size * (b_y - a_y)
+    std::array<f64, 8> numerator_2;
+    const auto numerator_2_size = scale_expansion_zeroelim(size_dy, exact_cast<f64>(c_x), span(numerator_2));
+
+    std::array<f64, 12> numerator;
+    const auto numerator_size =
+        fast_expansion_sum_zeroelim(numerator_1, const_span(numerator_2, numerator_2_size), span(numerator));
+
+    /// value * denominator
+    std::array<f64, 8> product;
+    const auto product_size = scale_expansion_zeroelim(denominator, value, span(product));
+    /// value * denominator - numerator
+    std::array<f64, 20> difference;
+    const auto difference_size = fast_expansion_difference_zeroelim(
+        const_span(product, product_size),
+        const_span(numerator, numerator_size),
+        span(difference));
+
+    const auto difference_sign = expansion_approx(const_span(difference, difference_size));
+    return positive_denominator ? difference_sign <= 0.0 : difference_sign >= 0.0;
+}
+
+/// @brief Finds the row containing the intersection of the line and the column border.
 /// Size is used to override grid.cell_size without modifying struct.
-s64 column_border_intersecion_impl(
+/// @param check_value the function checking if a value can be the result of rounding a quotient towards negative
+/// infinity. It is called at most once and only if the floating-point result is not reliable.
+template <typename CheckValue>
+[[nodiscard]] s64 column_border_intersecion_impl(
     const GridParameters & grid,
     const f64 size,
     const f64 a_x,
     const f64 a_y,
     const f64 b_x,
     const f64 b_y,
-    const s64 c_x) noexcept
+    const s64 c_x,
+    const CheckValue & check_value) noexcept
 {
     AR_PRE(a_x != b_x);
     AR_PRE(border_between_coordinates(size, a_x, b_x, c_x));
@@ -43,73 +150,87 @@ s64 column_border_intersecion_impl(
     const auto lerp = a_y + lerp_delta;
     const auto intersection = lerp / size;
 
-    /// Checks if a value can be the result of rounding a quotient towards negative infinity.
-    const auto check_value = [&a_x, &a_y, &b_x, &b_y, &size, &c_x](const f64 value)
-    {
-        /// a_y * b_x - a_x * b_y
-        std::array<f64, 4> numerator_1;
-        expansion_diff(const_span(two_product(a_y, b_x)), const_span(two_product(a_x, b_y)), span(numerator_1));
-        /// size * (b_y - a_y)
-        std::array<f64, 4> size_dy;
-        scale_expansion(const_span(two_diff(b_y, a_y)), size, span(size_dy));
-        /// c_x * size * (b_y - a_y)
-        std::array<f64, 8> numerator_2;
-        scale_expansion(const_span(size_dy), exact_cast<f64>(c_x), span(numerator_2));
-
-        std::array<f64, 12> numerator;
-        // TODO: fast_expansion_sum
-        expansion_sum(const_span(numerator_1), const_span(numerator_2), span(numerator));
-
-        /// size * (b_x - a_x)
-        std::array<f64, 4> denominator;
-        scale_expansion(const_span(two_diff(b_x, a_x)), size, span(denominator));
-
-        /// value * denominator
-        std::array<f64, 8> product;
-        scale_expansion(const_span(denominator), value, span(product));
-        /// value * denominator - numerator
-        std::array<f64, 20> difference;
-        // TODO: fast_expansion_diff
-        expansion_diff(const_span(product), const_span(numerator), span(difference));
-
-        const auto difference_sign = expansion_approx(const_span(difference));
-        const auto positive_denominator = b_x > a_x;
-        return positive_denominator ? difference_sign <= 0.0 : difference_sign >= 0.0;
-    };
-
     // Computation of 1.0 - fractional_part may be inexact,
     // so we can't avoid branching based on the sign of the value using std::floor.
     f64 integral_part;
     const auto fractional_part = std::abs(std::modf(intersection, &integral_part));
     s64 truncated = exact_cast<s64>(integral_part);
 
+    // The precomputed window is the worst case of the bound over all allowed inputs.
+    const auto error_bound = intersection_error_bound(size, a_y, b_y);
+    AR_ASSERT(error_bound <= grid.column_border_intersecion.min_reliable_fractional_part);
+    // The intersection may be rounded to the wrong side of the nearest integer.
+    // The difference 1.0 - fractional_part is exact when it is not larger than 0.5 and may be compared with the bound.
+    const auto near_truncated = fractional_part < error_bound;
+    const auto near_next = 1.0 - fractional_part <= error_bound;
+    count(
+        near_truncated || near_next ? &ExactStatistics::border_intersection_exact
+                                    : &ExactStatistics::border_intersection_filtered);
+
     if (intersection >= 0.0)
     {
-        if (fractional_part < grid.column_border_intersecion.min_reliable_fractional_part &&
-            !check_value(integral_part))
+        if (near_truncated && !check_value(integral_part))
         {
             return truncated - 1;
         }
-        if (fractional_part > grid.column_border_intersecion.max_reliable_fractional_part &&
-            check_value(integral_part + 1.0))
+        if (near_next && check_value(integral_part + 1.0))
         {
             return truncated + 1;
         }
         return truncated;
     }
 
-    if (fractional_part > grid.column_border_intersecion.max_reliable_fractional_part &&
-        !check_value(integral_part - 1.0))
+    if (near_next && !check_value(integral_part - 1.0))
     {
         return truncated - 2;
     }
-    if (fractional_part < grid.column_border_intersecion.min_reliable_fractional_part && check_value(integral_part))
+    if (near_truncated && check_value(integral_part))
     {
         return truncated;
     }
     return truncated - 1;
 }
 
+/// @brief Same as column_border_intersecion_impl, but computes all exact terms on demand.
+[[nodiscard]] s64 column_border_intersecion_impl(
+    const GridParameters & grid,
+    const f64 size,
+    const f64 a_x,
+    const f64 a_y,
+    const f64 b_x,
+    const f64 b_y,
+    const s64 c_x) noexcept
+{
+    return column_border_intersecion_impl(
+        grid,
+        size,
+        a_x,
+        a_y,
+        b_x,
+        b_y,
+        c_x,
+        [&](const f64 value)
+        {
+            std::array<f64, 4> numerator;
+            const auto numerator_size = numerator_term(a_x, a_y, b_x, b_y, span(numerator));
+            std::array<f64, 4> size_dy;
+            const auto size_dy_size = size_dy_term(size, a_y, b_y, span(size_dy));
+            std::array<f64, 4> denominator;
+            const auto denominator_size = denominator_term(size, a_x, b_x, span(denominator));
+            return check_value(
+                value,
+                c_x,
+                b_x > a_x,
+                const_span(numerator, numerator_size),
+                const_span(size_dy, size_dy_size),
+                const_span(denominator, denominator_size));
+        });
+}
+
+} // namespace border_intersection
+
+} // namespace
+
 template <GridRounding rounding>
 s64 column_border_intersection(
     const GridParameters & grid,
@@ -124,10 +245,16 @@ s64 column_border_intersection(
         switch (rounding)
         {
         case GridRounding::Cell:
-            return column_border_intersecion_impl(grid, grid.cell_size, a_x, a_y, b_x, b_y, c_x);
+            return border_intersection::column_border_intersecion_impl(grid, grid.cell_size, a_x, a_y, b_x, b_y, c_x);
         case GridRounding::NearestNode:
-            return half_cell_to_nearest_full_cell(
-                column_border_intersecion_impl(grid, grid.cell_size / 2.0, a_x, a_y, b_x, b_y, c_x * 2));
+            return half_cell_to_nearest_full_cell(border_intersection::column_border_intersecion_impl(
+                grid,
+                grid.cell_size / 2.0,
+                a_x,
+                a_y,
+                b_x,
+                b_y,
+                c_x * 2));
         }
         AR_UNREACHABLE;
     }();
@@ -154,10 +281,23 @@ s64 row_border_intersection(
         switch (rounding)
         {
         case GridRounding::Cell:
-            return column_border_intersecion_impl(grid, grid.cell_size, -a_y, a_x, -b_y, b_x, -c_y);
+            return border_intersection::column_border_intersecion_impl(
+                grid,
+                grid.cell_size,
+                -a_y,
+                a_x,
+                -b_y,
+                b_x,
+                -c_y);
         case GridRounding::NearestNode:
-            return half_cell_to_nearest_full_cell(
-                column_border_intersecion_impl(grid, grid.cell_size / 2.0, -a_y, a_x, -b_y, b_x, -c_y * 2));
+            return half_cell_to_nearest_full_cell(border_intersection::column_border_intersecion_impl(
+                grid,
+                grid.cell_size / 2.0,
+                -a_y,
+                a_x,
+                -b_y,
+                b_x,
+                -c_y * 2));
         }
         AR_UNREACHABLE;
     }();
@@ -170,4 +310,247 @@ template s64 row_border_intersection<
 template s64 row_border_intersection<
     GridRounding::NearestNode>(const GridParameters & grid, f64 a_x, f64 a_y, f64 b_x, f64 b_y, s64 c_y);
 
+template <GridRounding rounding>
+void column_border_intersection_pyramid(
+    const GridParameters & grid,
+    const f64 a_x,
+    const f64 a_y,
+    const f64 b_x,
+    const f64 b_y,
+    const s64 c_x,
+    const std::span<s64> rows) noexcept
+{
+    AR_PRE(!rows.empty());
+    AR_PRE(rows.size() <= g_max_pyramid_levels);
+    AR_PRE(c_x % (s64 { 1 } << (rows.size() - 1)) == 0);
+    switch (rounding)
+    {
+    case GridRounding::Cell:
+        finest_to_pyramid<rounding>(
+            border_intersection::column_border_intersecion_impl(grid, grid.cell_size, a_x, a_y, b_x, b_y, c_x),
+            rows);
+        break;
+    case GridRounding::NearestNode:
+        finest_to_pyramid<rounding>(
+            border_intersection::column_border_intersecion_impl(
+                grid,
+                grid.cell_size / 2.0,
+                a_x,
+                a_y,
+                b_x,
+                b_y,
+                c_x * 2),
+            rows);
+        break;
+    }
+    AR_POST(rows.front() == column_border_intersection<rounding>(grid, a_x, a_y, b_x, b_y, c_x));
+}
+
+template void column_border_intersection_pyramid<GridRounding::Cell>(
+    const GridParameters & grid,
+    f64 a_x,
+    f64 a_y,
+    f64 b_x,
+    f64 b_y,
+    s64 c_x,
+    std::span<s64> rows);
+template void column_border_intersection_pyramid<GridRounding::NearestNode>(
+    const GridParameters & grid,
+    f64 a_x,
+    f64 a_y,
+    f64 b_x,
+    f64 b_y,
+    s64 c_x,
+    std::span<s64> rows);
+
+template <GridRounding rounding>
+void row_border_intersection_pyramid(
+    const GridParameters & grid,
+    const f64 a_x,
+    const f64 a_y,
+    const f64 b_x,
+    const f64 b_y,
+    const s64 c_y,
+    const std::span<s64> columns) noexcept
+{
+    AR_PRE(!columns.empty());
+    AR_PRE(columns.size() <= g_max_pyramid_levels);
+    AR_PRE(c_y % (s64 { 1 } << (columns.size() - 1)) == 0);
+    switch (rounding)
+    {
+    case GridRounding::Cell:
+        finest_to_pyramid<rounding>(
+            border_intersection::column_border_intersecion_impl(grid, grid.cell_size, -a_y, a_x, -b_y, b_x, -c_y),
+            columns);
+        break;
+    case GridRounding::NearestNode:
+        finest_to_pyramid<rounding>(
+            border_intersection::column_border_intersecion_impl(
+                grid,
+                grid.cell_size / 2.0,
+                -a_y,
+                a_x,
+                -b_y,
+                b_x,
+                -c_y * 2),
+            columns);
+        break;
+    }
+    AR_POST(columns.front() == row_border_intersection<rounding>(grid, a_x, a_y, b_x, b_y, c_y));
+}
+
+template void row_border_intersection_pyramid<GridRounding::Cell>(
+    const GridParameters & grid,
+    f64 a_x,
+    f64 a_y,
+    f64 b_x,
+    f64 b_y,
+    s64 c_y,
+    std::span<s64> columns);
+template void row_border_intersection_pyramid<GridRounding::NearestNode>(
+    const GridParameters & grid,
+    f64 a_x,
+    f64 a_y,
+    f64 b_x,
+    f64 b_y,
+    s64 c_y,
+    std::span<s64> columns);
+
+template <GridRounding rounding>
+SegmentBorderCrossings<rounding>::SegmentBorderCrossings(
+    const GridParameters & grid,
+    const f64 a_x,
+    const f64 a_y,
+    const f64 b_x,
+    const f64 b_y) noexcept
+    : grid_ { grid }
+    , size_ { rounding == GridRounding::Cell ? grid.cell_size : grid.cell_size / 2.0 }
+    , column_borders_ { a_x == b_x ? std::pair<s64, s64> { 1, 0 }
+                                   : borders_between_coordinates(grid.cell_size, a_x, b_x) }
+    , row_borders_ { a_y == b_y ? std::pair<s64, s64> { 1, 0 } : borders_between_coordinates(grid.cell_size, a_y, b_y) }
+    , column_terms_ { axis_terms(a_x, a_y, b_x, b_y) }
+    , row_terms_ { axis_terms(-a_y, a_x, -b_y, b_x) }
+{
+}
+
+template <GridRounding rounding>
+std::pair<s64, s64> SegmentBorderCrossings<rounding>::column_borders() const noexcept
+{
+    return column_borders_;
+}
+
+template <GridRounding rounding>
+std::pair<s64, s64> SegmentBorderCrossings<rounding>::row_borders() const noexcept
+{
+    return row_borders_;
+}
+
+template <GridRounding rounding>
+s64 SegmentBorderCrossings<rounding>::column_border_intersection(const s64 c_x) const noexcept
+{
+    AR_PRE(c_x >= column_borders_.first);
+    AR_PRE(c_x <= column_borders_.second);
+    const auto c_y = [&]
+    {
+        switch (rounding)
+        {
+        case GridRounding::Cell:
+            return axis_border_intersection(column_terms_, c_x);
+        case GridRounding::NearestNode:
+            return half_cell_to_nearest_full_cell(axis_border_intersection(column_terms_, c_x * 2));
+        }
+        AR_UNREACHABLE;
+    }();
+    AR_POST(line_intersects_cell<rounding>(
+        grid_,
+        column_terms_.a_x,
+        column_terms_.a_y,
+        column_terms_.b_x,
+        column_terms_.b_y,
+        c_x,
+        c_y));
+    return c_y;
+}
+
+template <GridRounding rounding>
+s64 SegmentBorderCrossings<rounding>::row_border_intersection(const s64 c_y) const noexcept
+{
+    AR_PRE(c_y >= row_borders_.first);
+    AR_PRE(c_y <= row_borders_.second);
+    const auto c_x = [&]
+    {
+        switch (rounding)
+        {
+        case GridRounding::Cell:
+            return axis_border_intersection(row_terms_, -c_y);
+        case GridRounding::NearestNode:
+            return half_cell_to_nearest_full_cell(axis_border_intersection(row_terms_, -c_y * 2));
+        }
+        AR_UNREACHABLE;
+    }();
+    AR_POST(line_intersects_cell<rounding>(
+        grid_,
+        column_terms_.a_x,
+        column_terms_.a_y,
+        column_terms_.b_x,
+        column_terms_.b_y,
+        c_x,
+        c_y));
+    return c_x;
+}
+
+template <GridRounding rounding>
+auto SegmentBorderCrossings<rounding>::axis_terms(const f64 a_x, const f64 a_y, const f64 b_x, const f64 b_y) noexcept
+    -> AxisTerms
+{
+    AxisTerms terms;
+    terms.a_x = a_x;
+    terms.a_y = a_y;
+    terms.b_x = b_x;
+    terms.b_y = b_y;
+    return terms;
+}
+
+template <GridRounding rounding>
+void SegmentBorderCrossings<rounding>::compute_expansions(const f64 size, AxisTerms & terms) noexcept
+{
+    if (terms.has_expansions)
+    {
+        return;
+    }
+    terms.numerator_size =
+        border_intersection::numerator_term(terms.a_x, terms.a_y, terms.b_x, terms.b_y, span(terms.numerator));
+    terms.size_dy_size = border_intersection::size_dy_term(size, terms.a_y, terms.b_y, span(terms.size_dy));
+    terms.denominator_size =
+        border_intersection::denominator_term(size, terms.a_x, terms.b_x, span(terms.denominator));
+    terms.has_expansions = true;
+}
+
+template <GridRounding rounding>
+s64 SegmentBorderCrossings<rounding>::axis_border_intersection(AxisTerms & terms, const s64 border) const noexcept
+{
+    return border_intersection::column_border_intersecion_impl(
+        grid_,
+        size_,
+        terms.a_x,
+        terms.a_y,
+        terms.b_x,
+        terms.b_y,
+        border,
+        [&](const f64 value)
+        {
+            compute_expansions(size_, terms);
+            return border_intersection::check_value(
+                value,
+                border,
+                terms.b_x > terms.a_x,
+                const_span(terms.numerator, terms.numerator_size),
+                const_span(terms.size_dy, terms.size_dy_size),
+                const_span(terms.denominator, terms.denominator_size));
+        });
+}
+
+template class SegmentBorderCrossings<GridRounding::Cell>;
+template class SegmentBorderCrossings<GridRounding::NearestNode>;
+
 } // namespace ka
@@ -1,16 +1,262 @@
+#include <algorithm>
+#include <array>
+#include <bit>
 #include <cmath>
+#include <limits>
+#include <span>
 
 #include <ka/common/assert.hpp>
 #include <ka/common/cast.hpp>
 #include <ka/common/fixed.hpp>
 #include <ka/exact/grid.hpp>
+#include <ka/geometry_types/Vec2.hpp>
 
 #include "../expansion.hpp"
 #include "../common.hpp"
+#include "../dispatch.hpp"
+#include "../statistics.hpp"
+
+#ifdef KA_EXACT_MULTIVERSIONING
+#include <immintrin.h>
+#endif
 
 namespace ka
 {
 
+inline namespace
+{
+
+/// @brief Number of points rounded at once by cells_containing_points.
+constexpr size_t g_batch_size = 16;
+
+/// @brief Corrects the candidate obtained by rounding down the quotient x / size when it is an integer.
+template <TwoProduct algorithm = TwoProduct::Split>
+[[nodiscard]] s64 checked_candidate(const f64 size, const f64 x, const f64 candidate) noexcept
+{
+    count(&ExactStatistics::cell_containing_position_exact);
+
+    // The quotient may have been rounded towards infinity,
+    // so the result needs to be checked exactly.
+    std::array<f64, 3> difference;
+    grow_expansion(const_span(two_product<algorithm>(candidate, size)), -x, span(difference));
+    const auto sign = expansion_approx(const_span(difference));
+    // candidate * size > x
+    if (sign > 0.0)
+    {
+        return exact_cast<s64>(candidate) - 1;
+    }
+    return exact_cast<s64>(candidate);
+}
+
+/// @brief Computes the inverse of a power of two exactly, without division.
+[[nodiscard]] f64 inverse_power_of_two(const f64 value) noexcept
+{
+    // The mantissa of a power of two is zero, so only the exponent is negated: 2046 - (e + 1023) = -e + 1023.
+    constexpr u64 doubled_exponent_bias = u64 { 2046 } << 52;
+    return std::bit_cast<f64>(doubled_exponent_bias - std::bit_cast<u64>(value));
+}
+
+/// @brief Checks that the products of the allowed input coordinates and the inverse size do not underflow.
+[[nodiscard]] bool exact_scaling(const GridParameters & grid, const f64 inverse_size) noexcept
+{
+    return grid.min_input * inverse_size >= std::numeric_limits<f64>::min();
+}
+
+/// @brief Rounds the coordinate scaled by the inverse of the power-of-two cell size.
+/// The product is exact, so its floor is the correct result.
+[[nodiscard]] s64 scaled_position_to_cell(
+    [[maybe_unused]] const GridParameters & grid,
+    const f64 inverse_size,
+    const f64 x) noexcept
+{
+    AR_PRE(std::abs(x) <= grid.max_input);
+    AR_PRE(x == 0.0 || std::abs(x) >= grid.min_input);
+    return exact_cast<s64>(std::floor(x * inverse_size));
+}
+
+/// @brief Rounds down the quotients of the coordinates of the points by the cell size.
+/// @param candidates Rounded quotients, the coordinates of every point are adjacent like in Vec2f64.
+/// @return True iff some quotient is an integer, so its candidate has to be rechecked.
+using RoundQuotientsDown = bool(f64 size, std::span<const Vec2f64> batch, std::span<f64> candidates) noexcept;
+
+[[nodiscard]] bool round_quotients_down_scalar(
+    const f64 size,
+    const std::span<const Vec2f64> batch,
+    const std::span<f64> candidates) noexcept
+{
+    AR_PRE(candidates.size() >= 2 * batch.size());
+
+    bool has_integer_quotients = false;
+    for (size_t i = 0; i < batch.size(); ++i)
+    {
+        const auto quotient_x = batch[i].x / size;
+        const auto quotient_y = batch[i].y / size;
+        candidates[2 * i] = std::floor(quotient_x);
+        candidates[2 * i + 1] = std::floor(quotient_y);
+        has_integer_quotients |= (candidates[2 * i] == quotient_x) | (candidates[2 * i + 1] == quotient_y);
+    }
+    return has_integer_quotients;
+}
+
+#ifdef KA_EXACT_MULTIVERSIONING
+
+static_assert(sizeof(Vec2f64) == 2 * sizeof(f64), "Vector loads read two points as four coordinates");
+
+/// @brief Rounds the quotients of two points at once, the last odd point is rounded by the scalar code.
+KA_EXACT_TARGET("avx2,fma")
+[[nodiscard]] bool round_quotients_down_avx2(
+    const f64 size,
+    const std::span<const Vec2f64> batch,
+    const std::span<f64> candidates) noexcept
+{
+    AR_PRE(candidates.size() >= 2 * batch.size());
+
+    const auto divisor = _mm256_set1_pd(size);
+    auto integer_quotients = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 2 <= batch.size(); i += 2)
+    {
+        const auto quotients = _mm256_div_pd(_mm256_loadu_pd(&batch[i].x), divisor);
+        const auto rounded = _mm256_floor_pd(quotients);
+        _mm256_storeu_pd(&candidates[2 * i], rounded);
+        integer_quotients = _mm256_or_pd(integer_quotients, _mm256_cmp_pd(rounded, quotients, _CMP_EQ_OQ));
+    }
+    const auto tail_has_integer_quotients =
+        round_quotients_down_scalar(size, batch.subspan(i), candidates.subspan(2 * i));
+    return _mm256_movemask_pd(integer_quotients) != 0 || tail_has_integer_quotients;
+}
+
+/// @brief Rounds the quotients of four points at once, the remaining points are handled with masked operations.
+KA_EXACT_TARGET("avx512f,avx2,fma")
+[[nodiscard]] bool round_quotients_down_avx512(
+    const f64 size,
+    const std::span<const Vec2f64> batch,
+    const std::span<f64> candidates) noexcept
+{
+    AR_PRE(candidates.size() >= 2 * batch.size());
+
+    const auto divisor = _mm512_set1_pd(size);
+    __mmask8 integer_quotients = 0;
+    for (size_t i = 0; i < batch.size(); i += 4)
+    {
+        const auto lanes = 2 * std::min<size_t>(4, batch.size() - i);
+        const auto mask = static_cast<__mmask8>((1u << lanes) - 1);
+        const auto quotients = _mm512_div_pd(_mm512_maskz_loadu_pd(mask, &batch[i].x), divisor);
+        const auto rounded = _mm512_floor_pd(quotients);
+        _mm512_mask_storeu_pd(&candidates[2 * i], mask, rounded);
+        integer_quotients |= _mm512_mask_cmp_pd_mask(mask, rounded, quotients, _CMP_EQ_OQ);
+    }
+    return integer_quotients != 0;
+}
+
+#endif
+
+/// @brief Rounds the points in batches of g_batch_size.
+/// Every batch is rounded by the branchless round_quotients_down and only the rare integer quotients are rechecked.
+template <TwoProduct algorithm, RoundQuotientsDown round_quotients_down>
+void cells_containing_points_generic(
+    [[maybe_unused]] const GridParameters & grid,
+    const f64 size,
+    const std::span<const Vec2f64> points,
+    const std::span<Vec2s64> cells) noexcept
+{
+    AR_PRE(points.size() == cells.size());
+    AR_PRE(grid.desired_cell_size > 0.0);
+    AR_PRE(size >= grid.desired_cell_size);
+
+    std::array<f64, 2 * g_batch_size> candidates;
+    for (size_t first = 0; first < points.size(); first += g_batch_size)
+    {
+        const auto batch = points.subspan(first, std::min(g_batch_size, points.size() - first));
+        const auto has_integer_quotients = round_quotients_down(size, batch, candidates);
+
+        for (size_t i = 0; i < batch.size(); ++i)
+        {
+            AR_PRE(std::abs(batch[i].x) <= grid.max_input);
+            AR_PRE(std::abs(batch[i].y) <= grid.max_input);
+            cells[first + i] = {
+                .x = exact_cast<s64>(candidates[2 * i]),
+                .y = exact_cast<s64>(candidates[2 * i + 1]),
+            };
+        }
+
+        // Lanes whose quotient is an integer are rare, so they are rechecked one by one.
+        size_t checked = 0;
+        if (has_integer_quotients)
+        {
+            for (size_t i = 0; i < batch.size(); ++i)
+            {
+                if (candidates[2 * i] == batch[i].x / size)
+                {
+                    cells[first + i].x = checked_candidate<algorithm>(size, batch[i].x, candidates[2 * i]);
+                    ++checked;
+                }
+                if (candidates[2 * i + 1] == batch[i].y / size)
+                {
+                    cells[first + i].y = checked_candidate<algorithm>(size, batch[i].y, candidates[2 * i + 1]);
+                    ++checked;
+                }
+            }
+        }
+        count(&ExactStatistics::cell_containing_position_filtered, 2 * batch.size() - checked);
+    }
+}
+
+using CellsContainingPoints =
+    void(const GridParameters & grid, f64 size, std::span<const Vec2f64> points, std::span<Vec2s64> cells) noexcept;
+
+KA_EXACT_TARGET("fma")
+void cells_containing_points_fma(
+    const GridParameters & grid,
+    const f64 size,
+    const std::span<const Vec2f64> points,
+    const std::span<Vec2s64> cells) noexcept
+{
+    cells_containing_points_generic<TwoProduct::Fused, round_quotients_down_scalar>(grid, size, points, cells);
+}
+
+#ifdef KA_EXACT_MULTIVERSIONING
+
+KA_EXACT_TARGET("avx2,fma")
+void cells_containing_points_avx2(
+    const GridParameters & grid,
+    const f64 size,
+    const std::span<const Vec2f64> points,
+    const std::span<Vec2s64> cells) noexcept
+{
+    cells_containing_points_generic<TwoProduct::Fused, round_quotients_down_avx2>(grid, size, points, cells);
+}
+
+KA_EXACT_TARGET("avx512f,avx2,fma")
+void cells_containing_points_avx512(
+    const GridParameters & grid,
+    const f64 size,
+    const std::span<const Vec2f64> points,
+    const std::span<Vec2s64> cells) noexcept
+{
+    cells_containing_points_generic<TwoProduct::Fused, round_quotients_down_avx512>(grid, size, points, cells);
+}
+
+constexpr Implementations<CellsContainingPoints> g_cells_containing_points {
+    &cells_containing_points_generic<TwoProduct::Split, round_quotients_down_scalar>,
+    &cells_containing_points_fma,
+    &cells_containing_points_avx2,
+    &cells_containing_points_avx512,
+};
+
+#else
+
+constexpr Implementations<CellsContainingPoints> g_cells_containing_points {
+    &cells_containing_points_generic<TwoProduct::Split, round_quotients_down_scalar>,
+    &cells_containing_points_fma,
+    &cells_containing_points_fma,
+    &cells_containing_points_fma,
+};
+
+#endif
+
+} // namespace
+
 /// Size is used to override grid.cell_size without modifying struct.
 s64 column_containing_position_impl([[maybe_unused]] const GridParameters & grid, const f64 size, const f64 x) noexcept
 {
@@ -22,20 +268,22 @@ s64 column_containing_position_impl([[maybe_unused]] const GridParameters & grid
     const auto candidate = std::floor(quotient);
     if (candidate == quotient)
     {
-        // The quotient may have been rounded towards infinity,
-        // so the result needs to be checked exactly.
-        std::array<f64, 3> difference;
-        grow_expansion(const_span(two_product(candidate, size)), -x, span(difference));
-        const auto sign = expansion_approx(const_span(difference));
-        // candidate * size > x
-        if (sign > 0.0)
-        {
-            return exact_cast<s64>(candidate) - 1;
-        }
+        return checked_candidate(size, x, candidate);
     }
+    count(&ExactStatistics::cell_containing_position_filtered);
     return exact_cast<s64>(candidate);
 }
 
+/// Size is used to override grid.cell_size without modifying struct.
+void cells_containing_points_impl(
+    const GridParameters & grid,
+    const f64 size,
+    const std::span<const Vec2f64> points,
+    const std::span<Vec2s64> cells) noexcept
+{
+    select(g_cells_containing_points)(grid, size, points, cells);
+}
+
 template <GridRounding rounding>
 s64 column_containing_position(const GridParameters & grid, const f64 x) noexcept
 {
@@ -52,6 +300,69 @@ s64 column_containing_position(const GridParameters & grid, const f64 x) noexcep
 template s64 column_containing_position<GridRounding::Cell>(const GridParameters & grid, f64 x);
 template s64 column_containing_position<GridRounding::NearestNode>(const GridParameters & grid, f64 x);
 
+/// Inverse size is used instead of the half of grid.cell_size for the nearest node rounding.
+s64 column_containing_position_power_of_two_impl(
+    [[maybe_unused]] const GridParameters & grid,
+    const f64 inverse_size,
+    const f64 x) noexcept
+{
+    AR_PRE(has_power_of_two_cell_size(grid));
+    AR_PRE(grid.desired_cell_size > 0.0);
+    AR_PRE(1.0 / inverse_size >= grid.desired_cell_size);
+    AR_PRE(exact_scaling(grid, inverse_size));
+    return scaled_position_to_cell(grid, inverse_size, x);
+}
+
+/// Inverse size is used instead of the half of grid.cell_size for the nearest node rounding.
+void cells_containing_points_power_of_two_impl(
+    [[maybe_unused]] const GridParameters & grid,
+    const f64 inverse_size,
+    const std::span<const Vec2f64> points,
+    const std::span<Vec2s64> cells) noexcept
+{
+    AR_PRE(points.size() == cells.size());
+    AR_PRE(has_power_of_two_cell_size(grid));
+    AR_PRE(grid.desired_cell_size > 0.0);
+    AR_PRE(1.0 / inverse_size >= grid.desired_cell_size);
+    AR_PRE(exact_scaling(grid, inverse_size));
+
+    // Unlike cells_containing_points_impl there are no rare lanes to recheck, so the loop is branchless.
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+        cells[i] = {
+            .x = scaled_position_to_cell(grid, inverse_size, points[i].x),
+            .y = scaled_position_to_cell(grid, inverse_size, points[i].y),
+        };
+    }
+}
+
+template <GridRounding rounding>
+s64 column_containing_position_power_of_two(const GridParameters & grid, const f64 x) noexcept
+{
+    const auto inverse_size = inverse_power_of_two(grid.cell_size);
+    switch (rounding)
+    {
+    case GridRounding::Cell:
+        return column_containing_position_power_of_two_impl(grid, inverse_size, x);
+    case GridRounding::NearestNode:
+        return half_cell_to_nearest_full_cell(
+            column_containing_position_power_of_two_impl(grid, inverse_size * 2.0, x));
+    }
+    AR_UNREACHABLE;
+}
+
+template s64 column_containing_position_power_of_two<GridRounding::Cell>(const GridParameters & grid, f64 x);
+template s64 column_containing_position_power_of_two<GridRounding::NearestNode>(const GridParameters & grid, f64 x);
+
+template <GridRounding rounding>
+s64 row_containing_position_power_of_two(const GridParameters & grid, const f64 y) noexcept
+{
+    return column_containing_position_power_of_two<rounding>(grid, y);
+}
+
+template s64 row_containing_position_power_of_two<GridRounding::Cell>(const GridParameters & grid, f64 y);
+template s64 row_containing_position_power_of_two<GridRounding::NearestNode>(const GridParameters & grid, f64 y);
+
 template <GridRounding rounding>
 s64 row_containing_position(const GridParameters & grid, const f64 y) noexcept
 {
@@ -61,4 +372,101 @@ s64 row_containing_position(const GridParameters & grid, const f64 y) noexcept
 template s64 row_containing_position<GridRounding::Cell>(const GridParameters & grid, f64 y);
 template s64 row_containing_position<GridRounding::NearestNode>(const GridParameters & grid, f64 y);
 
+template <GridRounding rounding>
+void column_containing_position_pyramid(const GridParameters & grid, const f64 x, const std::span<s64> columns) noexcept
+{
+    AR_PRE(!columns.empty());
+    AR_PRE(columns.size() <= g_max_pyramid_levels);
+    switch (rounding)
+    {
+    case GridRounding::Cell:
+        finest_to_pyramid<rounding>(column_containing_position_impl(grid, grid.cell_size, x), columns);
+        return;
+    case GridRounding::NearestNode:
+        finest_to_pyramid<rounding>(column_containing_position_impl(grid, grid.cell_size / 2.0, x), columns);
+        return;
+    }
+    AR_UNREACHABLE;
+}
+
+template void column_containing_position_pyramid<
+    GridRounding::Cell>(const GridParameters & grid, f64 x, std::span<s64> columns);
+template void column_containing_position_pyramid<
+    GridRounding::NearestNode>(const GridParameters & grid, f64 x, std::span<s64> columns);
+
+template <GridRounding rounding>
+void row_containing_position_pyramid(const GridParameters & grid, const f64 y, const std::span<s64> rows) noexcept
+{
+    AR_PRE(!rows.empty());
+    column_containing_position_pyramid<rounding>(grid, y, rows);
+}
+
+template void row_containing_position_pyramid<
+    GridRounding::Cell>(const GridParameters & grid, f64 y, std::span<s64> rows);
+template void row_containing_position_pyramid<
+    GridRounding::NearestNode>(const GridParameters & grid, f64 y, std::span<s64> rows);
+
+template <GridRounding rounding>
+void cells_containing_points(
+    const GridParameters & grid,
+    const std::span<const Vec2f64> points,
+    const std::span<Vec2s64> cells) noexcept
+{
+    switch (rounding)
+    {
+    case GridRounding::Cell:
+        cells_containing_points_impl(grid, grid.cell_size, points, cells);
+        return;
+    case GridRounding::NearestNode:
+        cells_containing_points_impl(grid, grid.cell_size / 2.0, points, cells);
+        for (auto & cell : cells)
+        {
+            cell = {
+                .x = half_cell_to_nearest_full_cell(cell.x),
+                .y = half_cell_to_nearest_full_cell(cell.y),
+            };
+        }
+        return;
+    }
+    AR_UNREACHABLE;
+}
+
+template void cells_containing_points<
+    GridRounding::Cell>(const GridParameters & grid, std::span<const Vec2f64> points, std::span<Vec2s64> cells);
+template void cells_containing_points<
+    GridRounding::NearestNode>(const GridParameters & grid, std::span<const Vec2f64> points, std::span<Vec2s64> cells);
+
+template <GridRounding rounding>
+void cells_containing_points_power_of_two(
+    const GridParameters & grid,
+    const std::span<const Vec2f64> points,
+    const std::span<Vec2s64> cells) noexcept
+{
+    const auto inverse_size = inverse_power_of_two(grid.cell_size);
+    switch (rounding)
+    {
+    case GridRounding::Cell:
+        cells_containing_points_power_of_two_impl(grid, inverse_size, points, cells);
+        return;
+    case GridRounding::NearestNode:
+        cells_containing_points_power_of_two_impl(grid, inverse_size * 2.0, points, cells);
+        for (auto & cell : cells)
+        {
+            cell = {
+                .x = half_cell_to_nearest_full_cell(cell.x),
+                .y = half_cell_to_nearest_full_cell(cell.y),
+            };
+        }
+        return;
+    }
+    AR_UNREACHABLE;
+}
+
+template void cells_containing_points_power_of_two<
+    GridRounding::Cell>(const GridParameters & grid, std::span<const Vec2f64> points, std::span<Vec2s64> cells);
+template void cells_containing_points_power_of_two<GridRounding::NearestNode>(
+    const GridParameters & grid,
+    std::span<const Vec2f64> points,
+    std::span<Vec2s64> cells);
+
 } // namespace ka
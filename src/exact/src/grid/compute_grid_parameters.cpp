@@ -0,0 +1,104 @@
+#include <cmath>
+#include <limits>
+
+#include <ka/common/assert.hpp>
+#include <ka/common/fixed.hpp>
+#include <ka/exact/compute_grid_parameters.hpp>
+
+#include "../expansion.hpp"
+
+namespace ka
+{
+
+inline namespace
+{
+
+/// The functions below emulate directed rounding without changing the floating-point environment.
+/// Each of them computes the result rounded to nearest and corrects it by one ulp using the exact roundoff error.
+
+[[nodiscard]] f64 round_down(const f64 value) noexcept
+{
+    return std::nextafter(value, -std::numeric_limits<f64>::infinity());
+}
+
+[[nodiscard]] f64 round_up(const f64 value) noexcept
+{
+    return std::nextafter(value, std::numeric_limits<f64>::infinity());
+}
+
+[[nodiscard]] f64 multiply_up(const f64 lhs, const f64 rhs) noexcept
+{
+    const TwoExpansion product = two_product(lhs, rhs);
+    return product.err() > 0.0 ? round_up(product.approx()) : product.approx();
+}
+
+/// @brief Sign of lhs - quotient * rhs, i.e. the sign of the remainder of the division.
+[[nodiscard]] f64 remainder_sign(const f64 lhs, const f64 rhs, const f64 quotient) noexcept
+{
+    const TwoExpansion product = two_product(quotient, rhs);
+    // The quotient is rounded to nearest, so the product is close to lhs and the difference is exact.
+    const auto difference = lhs - product.approx();
+    return difference - product.err();
+}
+
+/// @pre rhs > 0.
+[[nodiscard]] f64 divide_down(const f64 lhs, const f64 rhs) noexcept
+{
+    AR_PRE(rhs > 0.0);
+    const auto quotient = lhs / rhs;
+    return remainder_sign(lhs, rhs, quotient) < 0.0 ? round_down(quotient) : quotient;
+}
+
+/// @pre rhs > 0.
+[[nodiscard]] f64 divide_up(const f64 lhs, const f64 rhs) noexcept
+{
+    AR_PRE(rhs > 0.0);
+    const auto quotient = lhs / rhs;
+    return remainder_sign(lhs, rhs, quotient) > 0.0 ? round_up(quotient) : quotient;
+}
+
+[[nodiscard]] f64 subtract_down(const f64 lhs, const f64 rhs) noexcept
+{
+    const TwoExpansion difference = two_diff(lhs, rhs);
+    return difference.err() < 0.0 ? round_down(difference.approx()) : difference.approx();
+}
+
+} // namespace
+
+GridParameters compute_grid_parameters(const GridDescription & description) noexcept
+{
+    AR_PRE(description.world_cells > 0.0);
+    AR_PRE(description.world_size > 0.0);
+    AR_PRE(description.min_world_coordinate > 0.0);
+    AR_PRE(description.min_world_coordinate <= description.max_world_coordinate);
+    AR_PRE(std::isfinite(description.world_cells));
+    AR_PRE(std::isfinite(description.world_size));
+    AR_PRE(std::isfinite(description.max_world_coordinate));
+
+    constexpr f64 unit_roundoff = 0x1p-53;
+
+    // RoundDown(world_size / world_cells)
+    const auto min_grid_step = divide_down(description.world_size, description.world_cells);
+    AR_PRE(min_grid_step > 0.0);
+
+    // RoundUp(21 * max_world_coordinate * unit_roundoff / min_grid_step)
+    auto reliable_fractional_part = multiply_up(description.max_world_coordinate, 21.0);
+    reliable_fractional_part = multiply_up(reliable_fractional_part, unit_roundoff);
+    reliable_fractional_part = divide_up(reliable_fractional_part, min_grid_step);
+
+    const GridParameters result {
+        .cell_size = min_grid_step,
+        .desired_cell_size = min_grid_step,
+        .min_input = description.min_world_coordinate,
+        .max_input = description.max_world_coordinate,
+        .column_border_intersecion = {
+            .min_reliable_fractional_part = reliable_fractional_part,
+            // RoundDown(1.0 - min_reliable_fractional_part)
+            .max_reliable_fractional_part = subtract_down(1.0, reliable_fractional_part),
+        },
+    };
+    AR_POST(result.column_border_intersecion.min_reliable_fractional_part > 0.0);
+    return result;
+}
+
+} // namespace ka
@@ -0,0 +1,246 @@
+#include <limits>
+
+#include <ka/common/assert.hpp>
+#include <ka/common/fixed.hpp>
+#include <ka/exact/integer_grid.hpp>
+
+#include "line_cell_intersection.hpp"
+
+namespace ka
+{
+
+inline namespace
+{
+
+/// All intermediate values are bounded using IntegerGridParameters::max_input.
+/// Let M = max_input = 2^40, then the input coordinates, the numerator and the denominator of the cell size
+/// do not exceed M, and the cells lie within the input range, so the values computed below do not exceed 2^126
+/// and 128-bit arithmetic is exact.
+using s128 = __int128;
+
+[[nodiscard]] bool valid_grid(const IntegerGridParameters & grid) noexcept
+{
+    return grid.cell_size_numerator > 0 && grid.cell_size_numerator <= IntegerGridParameters::max_input &&
+           grid.cell_size_denominator > 0 && grid.cell_size_denominator <= IntegerGridParameters::max_input;
+}
+
+[[nodiscard]] bool valid_input(const s64 value) noexcept
+{
+    return value >= -IntegerGridParameters::max_input && value <= IntegerGridParameters::max_input;
+}
+
+/// @brief Checks that the cell lies within the input range expanded by one cell.
+[[nodiscard]] bool valid_cell(const IntegerGridParameters & grid, const s64 c) noexcept
+{
+    const auto position = s128 { c < 0 ? -s128 { c } : s128 { c } } * grid.cell_size_numerator;
+    const auto limit = s128 { IntegerGridParameters::max_input } + grid.cell_size_numerator;
+    return position <= limit * grid.cell_size_denominator;
+}
+
+/// @brief Rounds the quotient towards negative infinity.
+[[nodiscard]] constexpr s128 floor_div(const s128 numerator, const s128 denominator) noexcept
+{
+    AR_PRE(denominator != 0);
+    const auto quotient = numerator / denominator;
+    const auto remainder = numerator % denominator;
+    return remainder != 0 && (remainder < 0) != (denominator < 0) ? quotient - 1 : quotient;
+}
+
+[[nodiscard]] s64 narrow(const s128 value) noexcept
+{
+    AR_PRE(value >= std::numeric_limits<s64>::min());
+    AR_PRE(value <= std::numeric_limits<s64>::max());
+    return static_cast<s64>(value);
+}
+
+/// @brief Finds the cell containing the coordinate numerator / denominator measured in cell sizes.
+template <GridRounding rounding>
+[[nodiscard]] s64 rational_to_cell(const s128 numerator, const s128 denominator) noexcept
+{
+    switch (rounding)
+    {
+    case GridRounding::Cell:
+        return narrow(floor_div(numerator, denominator));
+    case GridRounding::NearestNode:
+        // floor(numerator / denominator + 1 / 2)
+        return narrow(floor_div(2 * numerator + denominator, 2 * denominator));
+    }
+    AR_UNREACHABLE;
+}
+
+/// @brief Computes the sign of the determinant D(n, m) multiplied by the denominator of the cell size,
+/// see line_intersects_cell.cpp for the details.
+/// @param n, m coordinates of the node measured in cell_size_numerator / denominator.
+[[nodiscard]] int determinant_sign(
+    const s64 numerator,
+    const s128 denominator,
+    const s64 a_x,
+    const s64 a_y,
+    const s64 b_x,
+    const s64 b_y,
+    const s128 n,
+    const s128 m) noexcept
+{
+    const auto common_term = (s128 { a_x } * b_y - s128 { a_y } * b_x) * denominator;
+    const auto cell_dependent_term = numerator * (n * (a_y - b_y) - m * (a_x - b_x));
+    const auto determinant = common_term + cell_dependent_term;
+    return determinant > 0 ? 1 : determinant < 0 ? -1 : 0;
+}
+
+} // namespace
+
+template <GridRounding rounding>
+bool line_intersects_cell(
+    const IntegerGridParameters & grid,
+    const s64 a_x,
+    const s64 a_y,
+    const s64 b_x,
+    const s64 b_y,
+    const s64 c_x,
+    const s64 c_y) noexcept
+{
+    AR_PRE(valid_grid(grid));
+    AR_PRE(valid_input(a_x));
+    AR_PRE(valid_input(a_y));
+    AR_PRE(valid_input(b_x));
+    AR_PRE(valid_input(b_y));
+    AR_PRE(valid_cell(grid, c_x));
+    AR_PRE(valid_cell(grid, c_y));
+
+    const auto [invert_signs, main_diagonal] = line_cell_intersection::choose_flags(a_x, a_y, b_x, b_y);
+
+    // For snapping to grid nodes cells of the half size are used, like in the floating-point version.
+    const s128 step = rounding == GridRounding::Cell ? 1 : 2;
+    const s128 denominator = s128 { grid.cell_size_denominator } * step;
+    const s128 n = rounding == GridRounding::Cell ? s128 { c_x } : s128 { c_x } * 2 - 1;
+    const s128 m = rounding == GridRounding::Cell ? (main_diagonal ? s128 { c_y } : s128 { c_y } + 1)
+                                                  : (main_diagonal ? s128 { c_y } * 2 - 1 : s128 { c_y } * 2 + 1);
+
+    const auto numerator = grid.cell_size_numerator;
+    const auto first_sign = determinant_sign(numerator, denominator, a_x, a_y, b_x, b_y, n, m);
+    if (main_diagonal && first_sign == 0)
+    {
+        return true;
+    }
+    if (!line_cell_intersection::good_first_sign(invert_signs, first_sign))
+    {
+        return false;
+    }
+    const auto second_sign =
+        determinant_sign(numerator, denominator, a_x, a_y, b_x, b_y, n + step, main_diagonal ? m + step : m - step);
+    return line_cell_intersection::good_second_sign(invert_signs, second_sign);
+}
+
+template bool line_intersects_cell<
+    GridRounding::Cell>(const IntegerGridParameters & grid, s64 a_x, s64 a_y, s64 b_x, s64 b_y, s64 c_x, s64 c_y);
+template bool line_intersects_cell<GridRounding::NearestNode>(
+    const IntegerGridParameters & grid,
+    s64 a_x,
+    s64 a_y,
+    s64 b_x,
+    s64 b_y,
+    s64 c_x,
+    s64 c_y);
+
+template <GridRounding rounding>
+s64 column_containing_position(const IntegerGridParameters & grid, const s64 x) noexcept
+{
+    AR_PRE(valid_grid(grid));
+    AR_PRE(valid_input(x));
+    return rational_to_cell<rounding>(s128 { x } * grid.cell_size_denominator, grid.cell_size_numerator);
+}
+
+template s64 column_containing_position<GridRounding::Cell>(const IntegerGridParameters & grid, s64 x);
+template s64 column_containing_position<GridRounding::NearestNode>(const IntegerGridParameters & grid, s64 x);
+
+template <GridRounding rounding>
+s64 row_containing_position(const IntegerGridParameters & grid, const s64 y) noexcept
+{
+    return column_containing_position<rounding>(grid, y);
+}
+
+template s64 row_containing_position<GridRounding::Cell>(const IntegerGridParameters & grid, s64 y);
+template s64 row_containing_position<GridRounding::NearestNode>(const IntegerGridParameters & grid, s64 y);
+
+bool border_between_coordinates(const IntegerGridParameters & grid, const s64 a, const s64 b, const s64 x) noexcept
+{
+    AR_PRE(a != b);
+    AR_PRE(valid_grid(grid));
+    AR_PRE(valid_input(a));
+    AR_PRE(valid_input(b));
+    const auto border = s128 { x } * grid.cell_size_numerator;
+    const auto scaled_a = s128 { a } * grid.cell_size_denominator;
+    const auto scaled_b = s128 { b } * grid.cell_size_denominator;
+    if (a < b)
+    {
+        return scaled_a <= border && border <= scaled_b;
+    }
+    return scaled_b <= border && border <= scaled_a;
+}
+
+template <GridRounding rounding>
+s64 column_border_intersection(
+    const IntegerGridParameters & grid,
+    const s64 a_x,
+    const s64 a_y,
+    const s64 b_x,
+    const s64 b_y,
+    const s64 c_x) noexcept
+{
+    AR_PRE(a_x != b_x);
+    AR_PRE(border_between_coordinates(grid, a_x, b_x, c_x));
+    AR_PRE(valid_input(a_y));
+    AR_PRE(valid_input(b_y));
+
+    // The intersection in cell sizes is
+    //     (a_y + (b_y - a_y) * (c_x * size - a_x) / (b_x - a_x)) / size,
+    // where size = numerator / denominator.
+    const s128 numerator = grid.cell_size_numerator;
+    const s128 denominator = grid.cell_size_denominator;
+    const s128 dx = s128 { b_x } - a_x;
+    const s128 dy = s128 { b_y } - a_y;
+    const auto intersection_numerator = a_y * dx * denominator + dy * (c_x * numerator - a_x * denominator);
+    const auto intersection_denominator = numerator * dx;
+    const auto c_y = rational_to_cell<rounding>(intersection_numerator, intersection_denominator);
+
+    AR_POST(line_intersects_cell<rounding>(grid, a_x, a_y, b_x, b_y, c_x, c_y));
+    return c_y;
+}
+
+template s64 column_border_intersection<
+    GridRounding::Cell>(const IntegerGridParameters & grid, s64 a_x, s64 a_y, s64 b_x, s64 b_y, s64 c_x);
+template s64 column_border_intersection<
+    GridRounding::NearestNode>(const IntegerGridParameters & grid, s64 a_x, s64 a_y, s64 b_x, s64 b_y, s64 c_x);
+
+template <GridRounding rounding>
+s64 row_border_intersection(
+    const IntegerGridParameters & grid,
+    const s64 a_x,
+    const s64 a_y,
+    const s64 b_x,
+    const s64 b_y,
+    const s64 c_y) noexcept
+{
+    AR_PRE(a_y != b_y);
+    AR_PRE(border_between_coordinates(grid, a_y, b_y, c_y));
+    AR_PRE(valid_input(a_x));
+    AR_PRE(valid_input(b_x));
+
+    const s128 numerator = grid.cell_size_numerator;
+    const s128 denominator = grid.cell_size_denominator;
+    const s128 dx = s128 { b_x } - a_x;
+    const s128 dy = s128 { b_y } - a_y;
+    const auto intersection_numerator = a_x * dy * denominator + dx * (c_y * numerator - a_y * denominator);
+    const auto intersection_denominator = numerator * dy;
+    const auto c_x = rational_to_cell<rounding>(intersection_numerator, intersection_denominator);
+
+    AR_POST(line_intersects_cell<rounding>(grid, a_x, a_y, b_x, b_y, c_x, c_y));
+    return c_x;
+}
+
+template s64 row_border_intersection<
+    GridRounding::Cell>(const IntegerGridParameters & grid, s64 a_x, s64 a_y, s64 b_x, s64 b_y, s64 c_y);
+template s64 row_border_intersection<
+    GridRounding::NearestNode>(const IntegerGridParameters & grid, s64 a_x, s64 a_y, s64 b_x, s64 b_y, s64 c_y);
+
+} // namespace ka
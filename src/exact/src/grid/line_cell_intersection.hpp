@@ -0,0 +1,58 @@
+#pragma once
+
+#include <concepts>
+
+namespace ka
+{
+
+inline namespace
+{
+
+/// @brief Parts of the line and cell intersection test that do not depend on the type of coordinates.
+/// See line_intersects_cell.cpp for the description of the algorithm.
+namespace line_cell_intersection
+{
+
+struct Flags final
+{
+    /// @brief When signs are not inverted intersection requires first_determinant < 0 && second_determinant > 0.
+    bool invert_signs;
+    bool main_diagonal;
+};
+
+template <typename T>
+    requires std::floating_point<T> || std::signed_integral<T>
+[[nodiscard]] inline Flags choose_flags(const T a_x, const T a_y, const T b_x, const T b_y) noexcept
+{
+    //! The main diagonal of a cell is a segment parallel to the line x = y.
+    const bool main_diagonal = (a_x <= b_x && a_y >= b_y) || (a_x >= b_x && a_y <= b_y);
+    if (main_diagonal)
+    {
+        return {
+            .invert_signs = a_x >= b_x && a_y <= b_y,
+            .main_diagonal = main_diagonal,
+        };
+    }
+    return {
+        .invert_signs = a_x < b_x,
+        .main_diagonal = main_diagonal,
+    };
+}
+
+template <typename T>
+[[nodiscard]] inline bool good_first_sign(const bool invert_signs, const T first_sign) noexcept
+{
+    return invert_signs ? first_sign > 0 : first_sign < 0;
+}
+
+template <typename T>
+[[nodiscard]] inline bool good_second_sign(const bool invert_signs, const T second_sign) noexcept
+{
+    return invert_signs ? second_sign < 0 : second_sign > 0;
+}
+
+} // namespace line_cell_intersection
+
+} // namespace
+
+} // namespace ka
@@ -1,14 +1,25 @@
+#include <algorithm>
 #include <array>
+#include <cmath>
+#include <limits>
+#include <optional>
 #include <span>
+#include <tuple>
 #include <utility>
 
 #include <ka/common/assert.hpp>
 #include <ka/common/cast.hpp>
 #include <ka/common/fixed.hpp>
+#include <ka/exact/ExactStatistics.hpp>
+#include <ka/exact/LineCellTester.hpp>
 #include <ka/exact/grid.hpp>
+#include <ka/geometry_types/Vec2.hpp>
 
 #include "../expansion.hpp"
 #include "../common.hpp"
+#include "../dispatch.hpp"
+#include "../statistics.hpp"
+#include "line_cell_intersection.hpp"
 
 namespace ka
 {
@@ -39,62 +50,45 @@ inline namespace
 ///
 /// There is the possibility of reusing some terms and thair sum when testing the same line against multiple cells.
 /// But testing a line against a single cell appears to be more efficient when using lazy evaluation of terms.
+/// LineCellTester computes all cell independent terms once, for the first cell that needs them.
+///
+/// In most cases the signs of the determinants can be determined using plain floating-point arithmetic.
+/// So the exact expansion arithmetic is used only if the floating-point filter fails to guarantee the sign.
 namespace line_cell_intersection
 {
 
-struct Flags final
-{
-    /// @brief When signs are not inverted intersection requires first_determinant < 0 && second_determinant > 0.
-    bool invert_signs;
-    bool main_diagonal;
-};
-
-[[nodiscard]] Flags choose_flags(const f64 a_x, const f64 a_y, const f64 b_x, const f64 b_y) noexcept
-{
-    //! The main diagonal of a cell is a segment parallel to the line x = y.
-    const bool main_diagonal = (a_x <= b_x && a_y >= b_y) || (a_x >= b_x && a_y <= b_y);
-    if (main_diagonal)
-    {
-        return {
-            .invert_signs = a_x >= b_x && a_y <= b_y,
-            .main_diagonal = main_diagonal,
-        };
-    }
-    return {
-        .invert_signs = a_x < b_x,
-        .main_diagonal = main_diagonal,
-    };
-}
-
-/// @brief Common term of two determinants in the form of a 4-component non-adjacent expansion.
-[[nodiscard]] inline std::array<f64, 4> common_term(const f64 a_x, const f64 a_y, const f64 b_x, const f64 b_y) noexcept
+/// @brief Common term of two determinants in the form of a non-adjacent expansion of at most 4 components.
+/// @return Number of components.
+template <TwoProduct algorithm = TwoProduct::Split>
+[[nodiscard]] inline size_t common_term(
+    const f64 a_x,
+    const f64 a_y,
+    const f64 b_x,
+    const f64 b_y,
+    const std::span<f64, 4> term) noexcept
 {
     /// a_x * b_y - a_y * b_x
-    std::array<f64, 4> term;
-    expansion_diff(const_span(two_product(a_x, b_y)), const_span(two_product(a_y, b_x)), span(term));
-    return term;
+    return fast_expansion_difference_zeroelim(
+        const_span(two_product<algorithm>(a_x, b_y)),
+        const_span(two_product<algorithm>(a_y, b_x)),
+        term);
 }
 
-/// @brief Difference between two determinants in the form of a 8-component non-adjacent expansion.
-[[nodiscard]] inline std::array<f64, 8> difference_term(
+/// @brief Difference between two determinants in the form of a non-adjacent expansion of at most 8 components.
+/// @return Number of components.
+template <TwoProduct algorithm = TwoProduct::Split>
+[[nodiscard]] inline size_t difference_term(
     const bool main_diagonal,
     const f64 size,
     const std::span<const f64, 2> dx,
-    const std::span<const f64, 2> dy) noexcept
+    const std::span<const f64, 2> dy,
+    const std::span<f64, 8> term) noexcept
 {
     /// size * (dy -+ dx)
-    std::array<f64, 8> term;
     std::array<f64, 4> tmp;
-    if (main_diagonal)
-    {
-        expansion_diff(dy, dx, span(tmp));
-    }
-    else
-    {
-        expansion_sum(dy, dx, span(tmp));
-    }
-    scale_expansion(const_span(tmp), size, span(term));
-    return term;
+    const auto tmp_size = main_diagonal ? fast_expansion_difference_zeroelim(dy, dx, span(tmp))
+                                        : fast_expansion_sum_zeroelim(dy, dx, span(tmp));
+    return scale_expansion_zeroelim<algorithm>(const_span(tmp, tmp_size), size, term);
 }
 
 struct CellNode final
@@ -124,63 +118,479 @@ template <GridRounding rounding>
     }
 }
 
-/// @brief The second common term of both determinants depending on the cell coordinates in the form of a 16-component
-/// non-adjacent expansion.
-[[nodiscard]] inline std::array<f64, 16> cell_dependent_term(
+/// @brief The node of the cell defining the second determinant, i.e. the opposite end of the chosen diagonal.
+template <GridRounding rounding>
+[[nodiscard]] inline CellNode opposite_cell_node(const bool main_diagonal, const CellNode & node) noexcept
+{
+    constexpr s64 step = rounding == GridRounding::Cell ? 1 : 2;
+    AR_PRE(node.x <= std::numeric_limits<decltype(node.x)>::max() - step);
+    AR_PRE(node.y >= std::numeric_limits<decltype(node.y)>::min() + step);
+    AR_PRE(node.y <= std::numeric_limits<decltype(node.y)>::max() - step);
+    return { node.x + step, main_diagonal ? node.y + step : node.y - step, node.size_multiplier };
+}
+
+/// @brief Approximate value of a determinant and the bound of its absolute error.
+struct FilteredDeterminant final
+{
+    f64 value;
+    f64 error_bound;
+
+    /// @brief Checks that the value has the same sign as the determinant.
+    [[nodiscard]] bool reliable() const noexcept
+    {
+        constexpr f64 unit_roundoff = 0x1p-53;
+        return std::abs(value) > error_bound * (1.0 + 8.0 * unit_roundoff);
+    }
+};
+
+/// @brief Evaluates the determinant D(n, m) in the floating-point arithmetic using the equivalent form
+///     D(n, m) = (a.x - size * n) * (b.y - size * m) - (a.y - size * m) * (b.x - size * n).
+/// Unlike the expanded form, the rounding errors of this form are proportional to the distances from the node to the
+/// points on the line rather than to the squared magnitudes of the coordinates.
+/// @note The input constraints of GridParameters guarantee the absence of underflows and overflows,
+/// so the standard model of floating-point arithmetic with the unit roundoff u = 2^-53 is valid.
+/// @param node_x, node_y computed coordinates of the node, size * n and size * m.
+[[nodiscard]] inline FilteredDeterminant filtered_determinant(
+    const f64 a_x,
+    const f64 a_y,
+    const f64 b_x,
+    const f64 b_y,
+    const f64 node_x,
+    const f64 node_y) noexcept
+{
+    constexpr f64 unit_roundoff = 0x1p-53;
+
+    const auto p = a_x - node_x;
+    const auto q = b_y - node_y;
+    const auto r = a_y - node_y;
+    const auto t = b_x - node_x;
+    const auto pq = p * q;
+    const auto rt = r * t;
+
+    // Each difference is affected by the rounding of the node coordinate and by its own rounding:
+    //     |p' - p| <= u * |p| + u * (1 + u) * |node_x| < 2 * u * (|p'| + |node_x'|),
+    // where primes denote computed values.
+    const auto p_error = 2.0 * unit_roundoff * (std::abs(p) + std::abs(node_x));
+    const auto q_error = 2.0 * unit_roundoff * (std::abs(q) + std::abs(node_y));
+    const auto r_error = 2.0 * unit_roundoff * (std::abs(r) + std::abs(node_y));
+    const auto t_error = 2.0 * unit_roundoff * (std::abs(t) + std::abs(node_x));
+
+    // |p'q' - pq| <= |p'| * |q' - q| + |q'| * |p' - p| + |p' - p| * |q' - q|.
+    // Rounding of both products and of the difference adds at most (2 + O(u)) * u * (|pq'| + |rt'|).
+    // The coefficient 3 covers O(u) terms and the rounding errors of the bound computation itself.
+    return {
+        .value = pq - rt,
+        .error_bound = 3.0 * unit_roundoff * (std::abs(pq) + std::abs(rt)) +
+                       (std::abs(p) * q_error + std::abs(q) * p_error + p_error * q_error) +
+                       (std::abs(r) * t_error + std::abs(t) * r_error + r_error * t_error),
+    };
+}
+
+/// @brief Computed coordinates of the node, see filtered_determinant.
+[[nodiscard]] inline std::pair<f64, f64> node_coordinates(const CellNode & node, const f64 cell_size) noexcept
+{
+    // Multiplication by a power of two is exact.
+    const auto size = node.size_multiplier * cell_size;
+    return { exact_cast<f64>(node.x) * size, exact_cast<f64>(node.y) * size };
+}
+
+/// @brief Evaluates the determinant D(n, m) of the node of the cell using filtered_determinant.
+/// @return Approximate value of the determinant with the same sign as determinant,
+/// or std::nullopt if the sign is not guaranteed.
+[[nodiscard]] inline std::optional<f64> filtered_determinant_sign(
+    const f64 a_x,
+    const f64 a_y,
+    const f64 b_x,
+    const f64 b_y,
+    const CellNode & node,
+    const f64 cell_size) noexcept
+{
+    const auto [node_x, node_y] = node_coordinates(node, cell_size);
+    const auto determinant = filtered_determinant(a_x, a_y, b_x, b_y, node_x, node_y);
+    if (determinant.reliable())
+    {
+        return determinant.value;
+    }
+    return std::nullopt;
+}
+
+/// @brief Checks the line for intersection with the cell using floating-point filters of both determinants.
+/// @param node main node of the cell.
+/// @return The result of the check or std::nullopt if any of determinant signs is not guaranteed.
+template <GridRounding rounding>
+[[nodiscard]] inline std::optional<bool> filtered_intersects(
+    const Flags flags,
+    const CellNode & node,
+    const f64 cell_size,
+    const f64 a_x,
+    const f64 a_y,
+    const f64 b_x,
+    const f64 b_y) noexcept
+{
+    const auto first_sign = filtered_determinant_sign(a_x, a_y, b_x, b_y, node, cell_size);
+    if (!first_sign.has_value())
+    {
+        return std::nullopt;
+    }
+    if (!good_first_sign(flags.invert_signs, *first_sign))
+    {
+        return false;
+    }
+    const auto opposite_node = opposite_cell_node<rounding>(flags.main_diagonal, node);
+    const auto second_sign = filtered_determinant_sign(a_x, a_y, b_x, b_y, opposite_node, cell_size);
+    if (!second_sign.has_value())
+    {
+        return std::nullopt;
+    }
+    return good_second_sign(flags.invert_signs, *second_sign);
+}
+
+/// @brief Number of cells checked at once by LineCellTester.
+constexpr size_t g_batch_size = 16;
+
+/// @brief Checks the line for intersection with a batch of cells like filtered_intersects.
+/// Both determinants are evaluated for every cell and the loop always runs g_batch_size times,
+/// so it has no branches and is vectorized by the AVX2 and AVX-512 implementations.
+/// The flags are stored as 64-bit lanes equal to 0 or 1, since stores of bool prevent the vectorization.
+/// @param cells integer coordinates of 1 to g_batch_size cells, the rest of the batch repeats the last cell.
+/// @param result destination for the results, only the results of the decided cells are meaningful.
+/// @param decided destination for the flags showing that the result of the cell is guaranteed.
+template <GridRounding rounding>
+void filtered_intersects_batch(
+    const Flags flags,
+    const f64 cell_size,
+    const f64 a_x,
+    const f64 a_y,
+    const f64 b_x,
+    const f64 b_y,
+    const std::span<const Vec2s64> cells,
+    const std::span<u64, g_batch_size> result,
+    const std::span<u64, g_batch_size> decided) noexcept
+{
+    AR_PRE(!cells.empty());
+    AR_PRE(cells.size() <= g_batch_size);
+
+    // Integer coordinates are converted by a separate loop,
+    // since conversions of 64-bit integers have no vector instructions below AVX-512DQ.
+    std::array<f64, g_batch_size> first_x;
+    std::array<f64, g_batch_size> first_y;
+    std::array<f64, g_batch_size> second_x;
+    std::array<f64, g_batch_size> second_y;
+    for (size_t i = 0; i < g_batch_size; ++i)
+    {
+        const auto & cell = cells[std::min(i, cells.size() - 1)];
+        const auto node = main_cell_node<rounding>(flags.main_diagonal, cell.x, cell.y);
+        std::tie(first_x[i], first_y[i]) = node_coordinates(node, cell_size);
+        std::tie(second_x[i], second_y[i]) =
+            node_coordinates(opposite_cell_node<rounding>(flags.main_diagonal, node), cell_size);
+    }
+
+    // Multiplication by the sign is exact, it replaces the choice of the comparisons in good_first_sign and
+    // good_second_sign: the first determinant must be negative and the second one positive.
+    const auto sign = flags.invert_signs ? -1.0 : 1.0;
+    // The results are stored locally, so they can not alias the inputs and the loop needs no runtime checks.
+    std::array<u64, g_batch_size> local_result;
+    std::array<u64, g_batch_size> local_decided;
+    for (size_t i = 0; i < g_batch_size; ++i)
+    {
+        const auto first = filtered_determinant(a_x, a_y, b_x, b_y, first_x[i], first_y[i]);
+        const auto second = filtered_determinant(a_x, a_y, b_x, b_y, second_x[i], second_y[i]);
+        // A reliable wrong sign of the first determinant decides the cell regardless of the second one.
+        const bool good_first = sign * first.value < 0.0;
+        const bool good_second = sign * second.value > 0.0;
+        local_result[i] = good_first & good_second;
+        local_decided[i] = first.reliable() & (!good_first | second.reliable());
+    }
+    std::ranges::copy(local_result, result.begin());
+    std::ranges::copy(local_decided, decided.begin());
+}
+
+/// @brief The second common term of both determinants depending on the cell coordinates in the form of a non-adjacent
+/// expansion of at most 16 components.
+/// @return Number of components.
+template <TwoProduct algorithm = TwoProduct::Split>
+[[nodiscard]] inline size_t cell_dependent_term(
     const s64 node_x,
     const s64 node_y,
     const f64 size,
     const std::span<const f64, 2> dx,
-    const std::span<const f64, 2> dy) noexcept
+    const std::span<const f64, 2> dy,
+    const std::span<f64, 16> term) noexcept
 {
     const auto n = exact_cast<f64>(node_x);
     const auto m = exact_cast<f64>(node_y);
 
-    std::array<f64, 16> term;
     std::array<f64, 4> ndy;
-    scale_expansion(dy, n, span(ndy));
+    const auto ndy_size = scale_expansion_zeroelim<algorithm>(dy, n, span(ndy));
     std::array<f64, 4> mdx;
-    scale_expansion(dx, m, span(mdx));
+    const auto mdx_size = scale_expansion_zeroelim<algorithm>(dx, m, span(mdx));
     std::array<f64, 8> cell_tmp;
-    expansion_diff(const_span(ndy), const_span(mdx), span(cell_tmp));
-    scale_expansion(const_span(cell_tmp), size, span(term));
-    return term;
+    const auto cell_tmp_size =
+        fast_expansion_difference_zeroelim(const_span(ndy, ndy_size), const_span(mdx, mdx_size), span(cell_tmp));
+    return scale_expansion_zeroelim<algorithm>(const_span(cell_tmp, cell_tmp_size), size, term);
 }
 
 /// @brief Approximate value of the first determinant with the same sign as determinant.
+/// @param common_term expansion of at most 4 components.
+/// @param cell_dependent_term expansion of at most 16 components.
 [[nodiscard]] inline f64 first_determinant_sign(
-    const std::span<const f64, 4> common_term,
-    const std::span<const f64, 16> cell_dependent_term) noexcept
+    const std::span<const f64> common_term,
+    const std::span<const f64> cell_dependent_term) noexcept
 {
     std::array<f64, 20> first_determinant;
-    fast_expansion_sum(common_term, cell_dependent_term, span(first_determinant));
-    return expansion_approx(const_span(first_determinant));
+    const auto size = fast_expansion_sum_zeroelim(common_term, cell_dependent_term, span(first_determinant));
+    return expansion_approx(const_span(first_determinant, size));
+}
+
+/// @brief Cell independent part of the second determinant in the form of a non-adjacent expansion of at most 12
+/// components.
+/// @param common_term expansion of at most 4 components.
+/// @param difference_term expansion of at most 8 components.
+/// @return Number of components.
+[[nodiscard]] inline size_t second_common_term(
+    const std::span<const f64> common_term,
+    const std::span<const f64> difference_term,
+    const std::span<f64, 12> term) noexcept
+{
+    /// common_term + difference_term
+    return fast_expansion_sum_zeroelim(common_term, difference_term, term);
 }
 
 /// @brief Approximate value of the second determinant with the same sign as determinant.
+/// @param second_common_term expansion of at most 12 components.
+/// @param cell_dependent_term expansion of at most 16 components.
 [[nodiscard]] inline f64 second_determinant_sign(
-    const std::span<const f64, 4> common_term,
-    const std::span<const f64, 8> difference_term,
-    const std::span<const f64, 16> cell_dependent_term) noexcept
+    const std::span<const f64> second_common_term,
+    const std::span<const f64> cell_dependent_term) noexcept
 {
-    /// common_term + difference_term
-    std::array<f64, 12> precomputed_second;
-    expansion_sum(common_term, difference_term, span(precomputed_second));
     std::array<f64, 28> second_determinant;
-    fast_expansion_sum(const_span(precomputed_second), cell_dependent_term, span(second_determinant));
-    return expansion_approx(const_span(second_determinant));
+    const auto size = fast_expansion_sum_zeroelim(second_common_term, cell_dependent_term, span(second_determinant));
+    return expansion_approx(const_span(second_determinant, size));
 }
 
-[[nodiscard]] inline bool good_first_sign(const bool invert_signs, const f64 first_sign) noexcept
+/// @brief Checks the line for intersection with the cell using exact expansion arithmetic.
+/// @tparam algorithm algorithm of the exact products.
+template <TwoProduct algorithm>
+[[nodiscard]] bool exact_intersects(
+    const Flags flags,
+    const CellNode & node,
+    const f64 cell_size,
+    const f64 a_x,
+    const f64 a_y,
+    const f64 b_x,
+    const f64 b_y) noexcept
 {
-    return invert_signs ? first_sign > 0 : first_sign < 0;
+    const auto dx = two_diff(a_x, b_x);
+    const auto dy = two_diff(a_y, b_y);
+
+    std::array<f64, 4> common_term;
+    const auto common_term_size =
+        line_cell_intersection::common_term<algorithm>(a_x, a_y, b_x, b_y, span(common_term));
+
+    std::array<f64, 16> cell_dependent_term;
+    const auto cell_dependent_term_size = line_cell_intersection::cell_dependent_term<algorithm>(
+        node.x,
+        node.y,
+        node.size_multiplier * cell_size,
+        dx,
+        dy,
+        span(cell_dependent_term));
+
+    const auto first_sign = first_determinant_sign(
+        const_span(common_term, common_term_size),
+        const_span(cell_dependent_term, cell_dependent_term_size));
+    if (flags.main_diagonal && first_sign == 0)
+    {
+        return true;
+    }
+    if (!good_first_sign(flags.invert_signs, first_sign))
+    {
+        return false;
+    }
+
+    std::array<f64, 8> difference_term;
+    const auto difference_term_size = line_cell_intersection::difference_term<algorithm>(
+        flags.main_diagonal,
+        cell_size,
+        dx,
+        dy,
+        span(difference_term));
+    std::array<f64, 12> second_common_term;
+    const auto second_common_term_size = line_cell_intersection::second_common_term(
+        const_span(common_term, common_term_size),
+        const_span(difference_term, difference_term_size),
+        span(second_common_term));
+    const auto second_sign = second_determinant_sign(
+        const_span(second_common_term, second_common_term_size),
+        const_span(cell_dependent_term, cell_dependent_term_size));
+    return good_second_sign(flags.invert_signs, second_sign);
 }
 
-[[nodiscard]] inline bool good_second_sign(const bool invert_signs, const f64 second_sign) noexcept
+/// @brief Same as exact_intersects, but uses the cell independent terms precomputed by LineCellTester.
+/// @param first_common_term expansion of at most 4 components.
+/// @param second_common_term expansion of at most 12 components.
+template <TwoProduct algorithm>
+[[nodiscard]] bool exact_intersects_precomputed(
+    const Flags flags,
+    const CellNode & node,
+    const f64 cell_size,
+    const std::span<const f64, 2> dx,
+    const std::span<const f64, 2> dy,
+    const std::span<const f64> first_common_term,
+    const std::span<const f64> second_common_term) noexcept
+{
+    std::array<f64, 16> cell_dependent_term;
+    const auto cell_dependent_term_size = line_cell_intersection::cell_dependent_term<algorithm>(
+        node.x,
+        node.y,
+        node.size_multiplier * cell_size,
+        dx,
+        dy,
+        span(cell_dependent_term));
+
+    const auto first_sign =
+        first_determinant_sign(first_common_term, const_span(cell_dependent_term, cell_dependent_term_size));
+    if (flags.main_diagonal && first_sign == 0)
+    {
+        return true;
+    }
+    if (!good_first_sign(flags.invert_signs, first_sign))
+    {
+        return false;
+    }
+
+    const auto second_sign =
+        second_determinant_sign(second_common_term, const_span(cell_dependent_term, cell_dependent_term_size));
+    return good_second_sign(flags.invert_signs, second_sign);
+}
+
+using ExactIntersects =
+    bool(Flags flags, const CellNode & node, f64 cell_size, f64 a_x, f64 a_y, f64 b_x, f64 b_y) noexcept;
+
+using ExactIntersectsPrecomputed = bool(
+    Flags flags,
+    const CellNode & node,
+    f64 cell_size,
+    std::span<const f64, 2> dx,
+    std::span<const f64, 2> dy,
+    std::span<const f64> first_common_term,
+    std::span<const f64> second_common_term) noexcept;
+
+KA_EXACT_TARGET("fma")
+bool exact_intersects_fma(
+    const Flags flags,
+    const CellNode & node,
+    const f64 cell_size,
+    const f64 a_x,
+    const f64 a_y,
+    const f64 b_x,
+    const f64 b_y) noexcept
+{
+    return exact_intersects<TwoProduct::Fused>(flags, node, cell_size, a_x, a_y, b_x, b_y);
+}
+
+KA_EXACT_TARGET("fma")
+bool exact_intersects_precomputed_fma(
+    const Flags flags,
+    const CellNode & node,
+    const f64 cell_size,
+    const std::span<const f64, 2> dx,
+    const std::span<const f64, 2> dy,
+    const std::span<const f64> first_common_term,
+    const std::span<const f64> second_common_term) noexcept
 {
-    return invert_signs ? second_sign < 0 : second_sign > 0;
+    return exact_intersects_precomputed<TwoProduct::Fused>(
+        flags,
+        node,
+        cell_size,
+        dx,
+        dy,
+        first_common_term,
+        second_common_term);
 }
 
+/// The exact stage of a single check does not benefit from wider vectors, so only exact products depend on the
+/// instruction set.
+constexpr Implementations<ExactIntersects> g_exact_intersects {
+    &exact_intersects<TwoProduct::Split>,
+    &exact_intersects_fma,
+    &exact_intersects_fma,
+    &exact_intersects_fma,
+};
+
+constexpr Implementations<ExactIntersectsPrecomputed> g_exact_intersects_precomputed {
+    &exact_intersects_precomputed<TwoProduct::Split>,
+    &exact_intersects_precomputed_fma,
+    &exact_intersects_precomputed_fma,
+    &exact_intersects_precomputed_fma,
+};
+
+using FilteredIntersectsBatch = void(
+    Flags flags,
+    f64 cell_size,
+    f64 a_x,
+    f64 a_y,
+    f64 b_x,
+    f64 b_y,
+    std::span<const Vec2s64> cells,
+    std::span<u64, g_batch_size> result,
+    std::span<u64, g_batch_size> decided) noexcept;
+
+#ifdef KA_EXACT_MULTIVERSIONING
+
+template <GridRounding rounding>
+KA_EXACT_TARGET("avx2,fma")
+void filtered_intersects_batch_avx2(
+    const Flags flags,
+    const f64 cell_size,
+    const f64 a_x,
+    const f64 a_y,
+    const f64 b_x,
+    const f64 b_y,
+    const std::span<const Vec2s64> cells,
+    const std::span<u64, g_batch_size> result,
+    const std::span<u64, g_batch_size> decided) noexcept
+{
+    filtered_intersects_batch<rounding>(flags, cell_size, a_x, a_y, b_x, b_y, cells, result, decided);
+}
+
+template <GridRounding rounding>
+KA_EXACT_TARGET("avx512f,avx2,fma")
+void filtered_intersects_batch_avx512(
+    const Flags flags,
+    const f64 cell_size,
+    const f64 a_x,
+    const f64 a_y,
+    const f64 b_x,
+    const f64 b_y,
+    const std::span<const Vec2s64> cells,
+    const std::span<u64, g_batch_size> result,
+    const std::span<u64, g_batch_size> decided) noexcept
+{
+    filtered_intersects_batch<rounding>(flags, cell_size, a_x, a_y, b_x, b_y, cells, result, decided);
+}
+
+/// The filter does not compute exact products, so the FMA instruction set uses the generic code.
+template <GridRounding rounding>
+constexpr Implementations<FilteredIntersectsBatch> g_filtered_intersects_batch {
+    &filtered_intersects_batch<rounding>,
+    &filtered_intersects_batch<rounding>,
+    &filtered_intersects_batch_avx2<rounding>,
+    &filtered_intersects_batch_avx512<rounding>,
+};
+
+#else
+
+template <GridRounding rounding>
+constexpr Implementations<FilteredIntersectsBatch> g_filtered_intersects_batch {
+    &filtered_intersects_batch<rounding>,
+    &filtered_intersects_batch<rounding>,
+    &filtered_intersects_batch<rounding>,
+    &filtered_intersects_batch<rounding>,
+};
+
+#endif
+
 } // namespace line_cell_intersection
 
 } // namespace
@@ -195,36 +605,149 @@ bool line_intersects_cell(
     const s64 c_x,
     const s64 c_y) noexcept
 {
-    const auto [invert_signs, main_diagonal] = line_cell_intersection::choose_flags(a_x, a_y, b_x, b_y);
+    const auto flags = line_cell_intersection::choose_flags(a_x, a_y, b_x, b_y);
+    const auto node = line_cell_intersection::main_cell_node<rounding>(flags.main_diagonal, c_x, c_y);
 
-    const auto dx = two_diff(a_x, b_x);
-    const auto dy = two_diff(a_y, b_y);
+    const auto filtered =
+        line_cell_intersection::filtered_intersects<rounding>(flags, node, grid.cell_size, a_x, a_y, b_x, b_y);
+    if (filtered.has_value())
+    {
+        count(&ExactStatistics::line_intersects_cell_filtered);
+        return *filtered;
+    }
+    count(&ExactStatistics::line_intersects_cell_exact);
 
-    const auto common_term = line_cell_intersection::common_term(a_x, a_y, b_x, b_y);
+    return select(line_cell_intersection::g_exact_intersects)(flags, node, grid.cell_size, a_x, a_y, b_x, b_y);
+}
 
-    const auto node = line_cell_intersection::main_cell_node<rounding>(main_diagonal, c_x, c_y);
-    const auto cell_dependent_term =
-        line_cell_intersection::cell_dependent_term(node.x, node.y, node.size_multiplier * grid.cell_size, dx, dy);
+template bool line_intersects_cell<
+    GridRounding::Cell>(const GridParameters & grid, f64 a_x, f64 a_y, f64 b_x, f64 b_y, s64 c_x, s64 c_y);
+template bool line_intersects_cell<
+    GridRounding::NearestNode>(const GridParameters & grid, f64 a_x, f64 a_y, f64 b_x, f64 b_y, s64 c_x, s64 c_y);
+
+template <GridRounding rounding>
+LineCellTester<rounding>::LineCellTester(
+    const GridParameters & grid,
+    const f64 a_x,
+    const f64 a_y,
+    const f64 b_x,
+    const f64 b_y) noexcept
+    : cell_size_ { grid.cell_size }
+    , a_x_ { a_x }
+    , a_y_ { a_y }
+    , b_x_ { b_x }
+    , b_y_ { b_y }
+{
+    const auto flags = line_cell_intersection::choose_flags(a_x, a_y, b_x, b_y);
+    invert_signs_ = flags.invert_signs;
+    main_diagonal_ = flags.main_diagonal;
+}
 
-    const auto first_sign = line_cell_intersection::first_determinant_sign(common_term, cell_dependent_term);
-    if (main_diagonal && first_sign == 0)
+template <GridRounding rounding>
+bool LineCellTester<rounding>::intersects(const s64 c_x, const s64 c_y) const noexcept
+{
+    const auto node = line_cell_intersection::main_cell_node<rounding>(main_diagonal_, c_x, c_y);
+
+    const auto filtered = line_cell_intersection::filtered_intersects<rounding>(
+        { .invert_signs = invert_signs_, .main_diagonal = main_diagonal_ },
+        node,
+        cell_size_,
+        a_x_,
+        a_y_,
+        b_x_,
+        b_y_);
+    if (filtered.has_value())
     {
-        return true;
+        count(&ExactStatistics::line_intersects_cell_filtered);
+        return *filtered;
     }
-    if (!line_cell_intersection::good_first_sign(invert_signs, first_sign))
+    count(&ExactStatistics::line_intersects_cell_exact);
+    return exact_intersects(c_x, c_y);
+}
+
+template <GridRounding rounding>
+void LineCellTester<rounding>::intersects(const std::span<const Vec2s64> cells, const std::span<bool> result)
+    const noexcept
+{
+    using line_cell_intersection::g_batch_size;
+    AR_PRE(cells.size() == result.size());
+
+    const auto filtered_intersects_batch = select(line_cell_intersection::g_filtered_intersects_batch<rounding>);
+    std::array<u64, g_batch_size> filtered;
+    std::array<u64, g_batch_size> decided;
+    for (size_t first = 0; first < cells.size(); first += g_batch_size)
     {
-        return false;
+        const auto batch = cells.subspan(first, std::min(g_batch_size, cells.size() - first));
+        filtered_intersects_batch(
+            { .invert_signs = invert_signs_, .main_diagonal = main_diagonal_ },
+            cell_size_,
+            a_x_,
+            a_y_,
+            b_x_,
+            b_y_,
+            batch,
+            span(filtered),
+            span(decided));
+
+        // Cells the filter can not decide are rare, so they are checked one by one.
+        size_t checked = 0;
+        for (size_t i = 0; i < batch.size(); ++i)
+        {
+            if (decided[i] != 0)
+            {
+                result[first + i] = filtered[i] != 0;
+            }
+            else
+            {
+                result[first + i] = exact_intersects(batch[i].x, batch[i].y);
+                ++checked;
+            }
+        }
+        count(&ExactStatistics::line_intersects_cell_filtered, batch.size() - checked);
+        count(&ExactStatistics::line_intersects_cell_exact, checked);
     }
+}
 
-    const auto difference_term = line_cell_intersection::difference_term(main_diagonal, grid.cell_size, dx, dy);
-    const auto second_sign =
-        line_cell_intersection::second_determinant_sign(common_term, difference_term, cell_dependent_term);
-    return line_cell_intersection::good_second_sign(invert_signs, second_sign);
+template <GridRounding rounding>
+bool LineCellTester<rounding>::exact_intersects(const s64 c_x, const s64 c_y) const noexcept
+{
+    compute_exact_terms();
+    return select(line_cell_intersection::g_exact_intersects_precomputed)(
+        { .invert_signs = invert_signs_, .main_diagonal = main_diagonal_ },
+        line_cell_intersection::main_cell_node<rounding>(main_diagonal_, c_x, c_y),
+        cell_size_,
+        dx_,
+        dy_,
+        const_span(first_common_term_, first_common_term_size_),
+        const_span(second_common_term_, second_common_term_size_));
 }
 
-template bool line_intersects_cell<
-    GridRounding::Cell>(const GridParameters & grid, f64 a_x, f64 a_y, f64 b_x, f64 b_y, s64 c_x, s64 c_y);
-template bool line_intersects_cell<
-    GridRounding::NearestNode>(const GridParameters & grid, f64 a_x, f64 a_y, f64 b_x, f64 b_y, s64 c_x, s64 c_y);
+template <GridRounding rounding>
+void LineCellTester<rounding>::compute_exact_terms() const noexcept
+{
+    if (has_exact_terms_)
+    {
+        return;
+    }
+    dx_ = two_diff(a_x_, b_x_);
+    dy_ = two_diff(a_y_, b_y_);
+    first_common_term_size_ = line_cell_intersection::common_term(a_x_, a_y_, b_x_, b_y_, span(first_common_term_));
+
+    std::array<f64, 8> difference_term;
+    const auto difference_term_size = line_cell_intersection::difference_term(
+        main_diagonal_,
+        cell_size_,
+        const_span(dx_),
+        const_span(dy_),
+        span(difference_term));
+    second_common_term_size_ = line_cell_intersection::second_common_term(
+        const_span(first_common_term_, first_common_term_size_),
+        const_span(difference_term, difference_term_size),
+        span(second_common_term_));
+    has_exact_terms_ = true;
+}
+
+template class LineCellTester<GridRounding::Cell>;
+template class LineCellTester<GridRounding::NearestNode>;
 
 } // namespace ka
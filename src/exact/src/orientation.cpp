@@ -1,10 +1,17 @@
 #include <array>
+#include <cmath>
 #include <concepts>
+#include <limits>
+#include <span>
+#include <type_traits>
 
+#include <ka/common/assert.hpp>
 #include <ka/exact/orientation.hpp>
 
 #include "common.hpp"
+#include "dispatch.hpp"
 #include "expansion.hpp"
+#include "statistics.hpp"
 
 namespace ka
 {
@@ -12,43 +19,257 @@ namespace ka
 namespace detail
 {
 
+inline namespace
+{
+
+/// @brief Error bounds of the staged orientation predicate.
+/// [Shewchuk]
+template <ieee_float F>
+struct OrientationErrorBounds final
+{
+    /// @brief Unit roundoff.
+    static constexpr F epsilon = std::numeric_limits<F>::epsilon() / 2;
+    /// @brief Relative error of the approximation of a determinant obtained from an expansion.
+    static constexpr F result = (3 + 8 * epsilon) * epsilon;
+    /// @brief Relative error of the plain floating-point determinant.
+    static constexpr F a = (3 + 16 * epsilon) * epsilon;
+    /// @brief Relative error of the determinant with exact products of rounded differences.
+    static constexpr F b = (2 + 12 * epsilon) * epsilon;
+    /// @brief Relative error of the determinant corrected by first-order difference roundoff terms.
+    static constexpr F c = (9 + 64 * epsilon) * epsilon * epsilon;
+};
+
+[[nodiscard]] bool certain_sign(const auto determinant, const auto error_bound) noexcept
+{
+    return determinant >= error_bound || -determinant >= error_bound;
+}
+
+/// @brief Evaluates the determinant more precisely each time its sign remains uncertain.
+/// [Shewchuk]
+/// @param determinant_sum sum of absolute values of the determinant terms.
+/// @tparam algorithm algorithm of the exact products.
+template <TwoProduct algorithm, ieee_float F>
+[[nodiscard]] F orientation_adapt(
+    const F a_x,
+    const F a_y,
+    const F b_x,
+    const F b_y,
+    const F c_x,
+    const F c_y,
+    const F determinant_sum) noexcept
+{
+    using Bounds = OrientationErrorBounds<F>;
+
+    const TwoExpansion acx = two_diff(a_x, c_x);
+    const TwoExpansion bcx = two_diff(b_x, c_x);
+    const TwoExpansion acy = two_diff(a_y, c_y);
+    const TwoExpansion bcy = two_diff(b_y, c_y);
+
+    // Exact determinant of the rounded differences.
+    std::array<F, 4> b;
+    expansion_diff(
+        const_span(two_product<algorithm>(acx.approx(), bcy.approx())),
+        const_span(two_product<algorithm>(acy.approx(), bcx.approx())),
+        span(b));
+
+    auto determinant = expansion_estimate(const_span(b));
+    if (certain_sign(determinant, Bounds::b * determinant_sum))
+    {
+        count(&ExactStatistics::orientation_adapted);
+        return determinant;
+    }
+
+    if (acx.err() == 0 && bcx.err() == 0 && acy.err() == 0 && bcy.err() == 0)
+    {
+        count(&ExactStatistics::orientation_adapted);
+        return determinant;
+    }
+
+    determinant += (acx.approx() * bcy.err() + bcy.approx() * acx.err()) -
+                   (acy.approx() * bcx.err() + bcx.approx() * acy.err());
+    if (certain_sign(determinant, Bounds::c * determinant_sum + Bounds::result * std::abs(determinant)))
+    {
+        count(&ExactStatistics::orientation_adapted);
+        return determinant;
+    }
+    count(&ExactStatistics::orientation_exact);
+
+    // The exact determinant is the sum of the four products of the differences split into approximations and errors.
+    std::array<F, 4> u;
+
+    auto u_size = fast_expansion_difference_zeroelim(
+        const_span(two_product<algorithm>(acx.err(), bcy.approx())),
+        const_span(two_product<algorithm>(acy.err(), bcx.approx())),
+        span(u));
+    std::array<F, 8> c1;
+    const auto c1_size = fast_expansion_sum_zeroelim(const_span(b), const_span(u, u_size), span(c1));
+
+    u_size = fast_expansion_difference_zeroelim(
+        const_span(two_product<algorithm>(acx.approx(), bcy.err())),
+        const_span(two_product<algorithm>(acy.approx(), bcx.err())),
+        span(u));
+    std::array<F, 12> c2;
+    const auto c2_size = fast_expansion_sum_zeroelim(const_span(c1, c1_size), const_span(u, u_size), span(c2));
+
+    u_size = fast_expansion_difference_zeroelim(
+        const_span(two_product<algorithm>(acx.err(), bcy.err())),
+        const_span(two_product<algorithm>(acy.err(), bcx.err())),
+        span(u));
+    std::array<F, 16> d;
+    const auto d_size = fast_expansion_sum_zeroelim(const_span(c2, c2_size), const_span(u, u_size), span(d));
+
+    return expansion_approx(const_span(d, d_size));
+}
+
+template <ieee_float F>
+using OrientationAdapt = F(F a_x, F a_y, F b_x, F b_y, F c_x, F c_y, F determinant_sum) noexcept;
+
+template <ieee_float F>
+KA_EXACT_TARGET("fma")
+F orientation_adapt_fma(
+    const F a_x,
+    const F a_y,
+    const F b_x,
+    const F b_y,
+    const F c_x,
+    const F c_y,
+    const F determinant_sum) noexcept
+{
+    return orientation_adapt<TwoProduct::Fused>(a_x, a_y, b_x, b_y, c_x, c_y, determinant_sum);
+}
+
+/// @brief The adaptive stages do not benefit from wider vectors, so only exact products depend on the instruction set.
+template <ieee_float F>
+constexpr Implementations<OrientationAdapt<F>> g_orientation_adapt {
+    &orientation_adapt<TwoProduct::Split, F>,
+    &orientation_adapt_fma<F>,
+    &orientation_adapt_fma<F>,
+    &orientation_adapt_fma<F>,
+};
+
+/// @brief Unsigned type holding exactly the product of two differences of the coordinates.
+template <std::signed_integral I>
+using ProductMagnitude = std::conditional_t<std::same_as<I, s32>, u64, unsigned __int128>;
+
+/// @brief Integer represented by its sign and magnitude.
+/// The difference of two s64 coordinates does not fit into any signed type, but its magnitude fits into u64,
+/// and the product of two such magnitudes fits into 128 bits.
+template <typename U>
+struct SignMagnitude final
+{
+    /// @brief -1, 0 or 1.
+    int sign;
+    U magnitude;
+};
+
+template <typename U, std::signed_integral I>
+[[nodiscard]] SignMagnitude<U> difference(const I lhs, const I rhs) noexcept
+{
+    // The difference of the unsigned representations modulo 2^n is exact when it is not negative.
+    using Unsigned = std::make_unsigned_t<I>;
+    if (lhs < rhs)
+    {
+        return {
+            .sign = -1,
+            .magnitude = static_cast<Unsigned>(static_cast<Unsigned>(rhs) - static_cast<Unsigned>(lhs)),
+        };
+    }
+    return {
+        .sign = lhs > rhs ? 1 : 0,
+        .magnitude = static_cast<Unsigned>(static_cast<Unsigned>(lhs) - static_cast<Unsigned>(rhs)),
+    };
+}
+
+template <typename U>
+[[nodiscard]] SignMagnitude<U> product(const SignMagnitude<U> & lhs, const SignMagnitude<U> & rhs) noexcept
+{
+    return { .sign = lhs.sign * rhs.sign, .magnitude = lhs.magnitude * rhs.magnitude };
+}
+
+/// @brief Computes the sign of lhs - rhs.
+template <typename U>
+[[nodiscard]] s64 difference_sign(const SignMagnitude<U> & lhs, const SignMagnitude<U> & rhs) noexcept
+{
+    if (lhs.sign != rhs.sign)
+    {
+        return lhs.sign > rhs.sign ? 1 : -1;
+    }
+    if (lhs.magnitude == rhs.magnitude)
+    {
+        return 0;
+    }
+    return lhs.magnitude > rhs.magnitude ? lhs.sign : -lhs.sign;
+}
+
+/// @brief Computes the sign of the orientation determinant of s32 or s64 coordinates without overflow.
+/// @param m00, m10 differences b_x - a_x and b_y - a_y.
+template <typename U, std::signed_integral I>
+[[nodiscard]] s64 wide_orientation(
+    const SignMagnitude<U> & m00,
+    const SignMagnitude<U> & m10,
+    const I a_x,
+    const I a_y,
+    const I c_x,
+    const I c_y) noexcept
+{
+    const auto m01 = difference<U>(c_x, a_x);
+    const auto m11 = difference<U>(c_y, a_y);
+    return difference_sign(product(m00, m11), product(m01, m10));
+}
+
+} // namespace
+
 template <ieee_float F>
     requires std::same_as<F, f32> || std::same_as<F, f64>
 [[nodiscard]] F orientation_impl(const F a_x, const F a_y, const F b_x, const F b_y, const F c_x, const F c_y) noexcept
 {
-    // TODO: Implement robust predicate from [Shewchuk].
+    // Adaptive-precision predicate from [Shewchuk].
     //
-    // | b_x - a_x   c_x - a_x |
-    // |                       | = (b_x - a_x)(c_y - a_y) - (b_y - a_y)(c_x - a_x) =
-    // | b_y - a_y   c_y - a_y |
+    // | a_x - c_x   a_y - c_y |
+    // |                       | = (a_x - c_x)(b_y - c_y) - (a_y - c_y)(b_x - c_x)
+    // | b_x - c_x   b_y - c_y |
     //
-    // = (b_x - a_x) * c_y - (b_x - a_x) * a_y - (b_y - a_y) * c_x + (b_y - a_y) * a_x
+    // The determinant is first computed in plain floating-point arithmetic. More precise stages are evaluated only when
+    // the error bound does not guarantee the correct sign.
 
-    const auto dx = two_diff(b_x, a_x);
-    const auto dy = two_diff(b_y, a_y);
+    const auto left = (a_x - c_x) * (b_y - c_y);
+    const auto right = (a_y - c_y) * (b_x - c_x);
+    const auto determinant = left - right;
 
-    std::array<F, 4> t1;
-    scale_expansion(const_span(dx), c_y, span(t1));
-    std::array<F, 4> t2;
-    scale_expansion(const_span(dx), a_y, span(t2));
-    std::array<F, 4> t3;
-    scale_expansion(const_span(dy), c_x, span(t3));
-    std::array<F, 4> t4;
-    scale_expansion(const_span(dy), a_x, span(t4));
+    F determinant_sum;
+    if (left > 0)
+    {
+        if (right <= 0)
+        {
+            count(&ExactStatistics::orientation_filtered);
+            return determinant;
+        }
+        determinant_sum = left + right;
+    }
+    else if (left < 0)
+    {
+        if (right >= 0)
+        {
+            count(&ExactStatistics::orientation_filtered);
+            return determinant;
+        }
+        determinant_sum = -left - right;
+    }
+    else
+    {
+        count(&ExactStatistics::orientation_filtered);
+        return determinant;
+    }
 
-    std::array<F, 8> t1t4;
-    fast_expansion_sum(const_span(t1), const_span(t4), span(t1t4));
-    std::array<F, 8> t2t3;
-    fast_expansion_sum(const_span(t2), const_span(t3), span(t2t3));
-
-    std::array<F, 16> res;
-    fast_expansion_difference(const_span(t1t4), const_span(t2t3), span(res));
-
-    return expansion_approx(const_span(res));
+    if (certain_sign(determinant, OrientationErrorBounds<F>::a * determinant_sum))
+    {
+        count(&ExactStatistics::orientation_filtered);
+        return determinant;
+    }
+    return select(g_orientation_adapt<F>)(a_x, a_y, b_x, b_y, c_x, c_y, determinant_sum);
 }
 
-template <std::integral I>
-    requires std::same_as<I, u16> || std::same_as<I, s16>
+template <OrientationInteger I>
 [[nodiscard]] s64 orientation_impl(
     const I a_x,
     const I a_y,
@@ -57,17 +278,90 @@ template <std::integral I>
     const I c_x,
     const I c_y) noexcept
 {
-    const s64 m00 = b_x - a_x;
-    const s64 m01 = c_x - a_x;
-    const s64 m10 = b_y - a_y;
-    const s64 m11 = c_y - a_y;
-    return m00 * m11 - m01 * m10;
+    if constexpr (sizeof(I) <= sizeof(s16))
+    {
+        const s64 m00 = b_x - a_x;
+        const s64 m01 = c_x - a_x;
+        const s64 m10 = b_y - a_y;
+        const s64 m11 = c_y - a_y;
+        return m00 * m11 - m01 * m10;
+    }
+    else
+    {
+        using U = ProductMagnitude<I>;
+        return wide_orientation(difference<U>(b_x, a_x), difference<U>(b_y, a_y), a_x, a_y, c_x, c_y);
+    }
+}
+
+template <OrientationInteger I>
+void orientations_impl(
+    const I a_x,
+    const I a_y,
+    const I b_x,
+    const I b_y,
+    const std::span<const Vec2<I>> points,
+    const std::span<s64> results) noexcept
+{
+    AR_PRE(points.size() == results.size());
+
+    if constexpr (sizeof(I) <= sizeof(s16))
+    {
+        const s64 m00 = b_x - a_x;
+        const s64 m10 = b_y - a_y;
+        for (size_t i = 0; i < points.size(); ++i)
+        {
+            const s64 m01 = points[i].x - a_x;
+            const s64 m11 = points[i].y - a_y;
+            results[i] = m00 * m11 - m01 * m10;
+        }
+    }
+    else
+    {
+        using U = ProductMagnitude<I>;
+        const auto m00 = difference<U>(b_x, a_x);
+        const auto m10 = difference<U>(b_y, a_y);
+        for (size_t i = 0; i < points.size(); ++i)
+        {
+            results[i] = wide_orientation(m00, m10, a_x, a_y, points[i].x, points[i].y);
+        }
+    }
 }
 
 template f32 orientation_impl<f32>(f32 a_x, f32 a_y, f32 b_x, f32 b_y, f32 c_x, f32 c_y) noexcept;
 template f64 orientation_impl<f64>(f64 a_x, f64 a_y, f64 b_x, f64 b_y, f64 c_x, f64 c_y) noexcept;
 template s64 orientation_impl<u16>(u16 a_x, u16 a_y, u16 b_x, u16 b_y, u16 c_x, u16 c_y) noexcept;
 template s64 orientation_impl<s16>(s16 a_x, s16 a_y, s16 b_x, s16 b_y, s16 c_x, s16 c_y) noexcept;
+template s64 orientation_impl<s32>(s32 a_x, s32 a_y, s32 b_x, s32 b_y, s32 c_x, s32 c_y) noexcept;
+template s64 orientation_impl<s64>(s64 a_x, s64 a_y, s64 b_x, s64 b_y, s64 c_x, s64 c_y) noexcept;
+
+template void orientations_impl<u16>(
+    u16 a_x,
+    u16 a_y,
+    u16 b_x,
+    u16 b_y,
+    std::span<const Vec2<u16>> points,
+    std::span<s64> results) noexcept;
+template void orientations_impl<s16>(
+    s16 a_x,
+    s16 a_y,
+    s16 b_x,
+    s16 b_y,
+    std::span<const Vec2<s16>> points,
+    std::span<s64> results) noexcept;
+template void orientations_impl<s32>(
+    s32 a_x,
+    s32 a_y,
+    s32 b_x,
+    s32 b_y,
+    std::span<const Vec2<s32>> points,
+    std::span<s64> results) noexcept;
+template void orientations_impl<s64>(
+    s64 a_x,
+    s64 a_y,
+    s64 b_x,
+    s64 b_y,
+    std::span<const Vec2<s64>> points,
+    std::span<s64> results) noexcept;
 
 } // namespace detail
 
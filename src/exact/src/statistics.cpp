@@ -0,0 +1,114 @@
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include <ka/common/assert.hpp>
+#include <ka/exact/ExactStatistics.hpp>
+
+#include "statistics.hpp"
+
+namespace ka
+{
+
+inline namespace
+{
+
+/// @brief Counters of all running threads and the sum of the counters of finished threads.
+struct StatisticsRegistry final
+{
+    std::mutex mutex;
+    std::vector<const ExactStatistics *> threads;
+    ExactStatistics finished {};
+};
+
+/// @brief The registry is never destroyed, because threads may finish after the destruction of static objects.
+[[nodiscard]] StatisticsRegistry & registry() noexcept
+{
+    static auto * const instance = new StatisticsRegistry {};
+    return *instance;
+}
+
+[[nodiscard]] u64 load(const u64 & counter) noexcept
+{
+    // std::atomic_ref requires a non-const reference even for loads.
+    return std::atomic_ref { const_cast<u64 &>(counter) }.load(std::memory_order_relaxed);
+}
+
+void accumulate(ExactStatistics & total, const ExactStatistics & statistics) noexcept
+{
+    for (const auto counter : g_exact_statistics_counters)
+    {
+        total.*counter += load(statistics.*counter);
+    }
+}
+
+/// @brief Keeps the counters of the calling thread in the registry until the thread ends.
+/// Unlike the counters, it has a non-trivial constructor and destructor, so it is only accessed on registration.
+class ThreadRegistration final
+{
+public:
+    ThreadRegistration()
+    {
+        auto & instance = registry();
+        const std::lock_guard lock { instance.mutex };
+        instance.threads.push_back(&g_thread_exact_statistics);
+    }
+
+    ~ThreadRegistration()
+    {
+        auto & instance = registry();
+        const std::lock_guard lock { instance.mutex };
+        accumulate(instance.finished, g_thread_exact_statistics);
+        const auto it = std::find(instance.threads.begin(), instance.threads.end(), &g_thread_exact_statistics);
+        AR_ASSERT(it != instance.threads.end());
+        instance.threads.erase(it);
+    }
+
+    ThreadRegistration(const ThreadRegistration &) = delete;
+    ThreadRegistration & operator=(const ThreadRegistration &) = delete;
+};
+
+} // namespace
+
+thread_local constinit ExactStatistics g_thread_exact_statistics {};
+
+thread_local constinit bool g_thread_exact_statistics_registered = false;
+
+void register_thread_exact_statistics() noexcept
+{
+    thread_local const ThreadRegistration registration {};
+    g_thread_exact_statistics_registered = true;
+}
+
+bool exact_statistics_enabled() noexcept
+{
+    return g_exact_statistics_enabled;
+}
+
+ExactStatistics thread_exact_statistics() noexcept
+{
+    return g_thread_exact_statistics;
+}
+
+void reset_thread_exact_statistics() noexcept
+{
+    for (const auto counter : g_exact_statistics_counters)
+    {
+        std::atomic_ref { g_thread_exact_statistics.*counter }.store(0, std::memory_order_relaxed);
+    }
+}
+
+ExactStatistics total_exact_statistics() noexcept
+{
+    auto & instance = registry();
+    const std::lock_guard lock { instance.mutex };
+    auto total = instance.finished;
+    for (const auto * const statistics : instance.threads)
+    {
+        accumulate(total, *statistics);
+    }
+    return total;
+}
+
+} // namespace ka
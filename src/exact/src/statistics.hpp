@@ -0,0 +1,62 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+
+#include <ka/common/fixed.hpp>
+#include <ka/exact/ExactStatistics.hpp>
+
+namespace ka
+{
+
+#ifdef KA_EXACT_STATISTICS
+constexpr bool g_exact_statistics_enabled = true;
+#else
+constexpr bool g_exact_statistics_enabled = false;
+#endif
+
+/// @brief All counters of ExactStatistics, used to process them uniformly.
+constexpr std::array g_exact_statistics_counters {
+    &ExactStatistics::line_intersects_cell_filtered,
+    &ExactStatistics::line_intersects_cell_exact,
+    &ExactStatistics::cell_containing_position_filtered,
+    &ExactStatistics::cell_containing_position_exact,
+    &ExactStatistics::border_intersection_filtered,
+    &ExactStatistics::border_intersection_exact,
+    &ExactStatistics::orientation_filtered,
+    &ExactStatistics::orientation_adapted,
+    &ExactStatistics::orientation_exact,
+};
+
+static_assert(sizeof(ExactStatistics) == g_exact_statistics_counters.size() * sizeof(u64));
+static_assert(std::atomic_ref<u64>::required_alignment <= alignof(ExactStatistics));
+
+/// @brief Counters of the calling thread.
+/// Counters are written only by the owning thread, but may be read by any thread using std::atomic_ref.
+/// The variable is trivial and constant-initialized, so accessing it does not go through the thread-local
+/// initialization wrapper.
+extern thread_local constinit ExactStatistics g_thread_exact_statistics;
+
+/// @brief Whether the counters of the calling thread are registered for the computation of the total statistics.
+extern thread_local constinit bool g_thread_exact_statistics_registered;
+
+/// @brief Registers the counters of the calling thread, they are added to the total statistics when the thread ends.
+void register_thread_exact_statistics() noexcept;
+
+/// @brief Increments the counter of the calling thread if statistics collection is enabled.
+inline void count(u64 ExactStatistics::*counter, const u64 increment = 1) noexcept
+{
+    if constexpr (g_exact_statistics_enabled)
+    {
+        if (!g_thread_exact_statistics_registered) [[unlikely]]
+        {
+            register_thread_exact_statistics();
+        }
+        // Only the owning thread modifies the counter, so the relaxed load and store do not lose increments
+        // and compile to plain memory accesses.
+        const std::atomic_ref value { g_thread_exact_statistics.*counter };
+        value.store(value.load(std::memory_order_relaxed) + increment, std::memory_order_relaxed);
+    }
+}
+
+} // namespace ka
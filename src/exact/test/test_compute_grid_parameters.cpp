@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+
+#include <fmt/format.h>
+
+#include <mpfr.h>
+
+#include <ka/common/fixed.hpp>
+#include <ka/exact/GridParameters.hpp>
+#include <ka/exact/compute_grid_parameters.hpp>
+
+#include "mock_grid_parameters.hpp"
+
+namespace ka
+{
+
+inline namespace
+{
+
+/// @brief The same computations as in ka_generate_grid.
+[[nodiscard]] GridParameters mpfr_compute_grid_parameters(const GridDescription & description)
+{
+    constexpr f64 unit_roundoff = 0x1p-53;
+
+    mpfr_t min_grid_step;
+    mpfr_init2(min_grid_step, 53);
+    mpfr_t reliable_fractional_part;
+    mpfr_init2(reliable_fractional_part, 53);
+
+    mpfr_set_d(min_grid_step, description.world_size, MPFR_RNDD);
+    mpfr_div_d(min_grid_step, min_grid_step, description.world_cells, MPFR_RNDD);
+
+    mpfr_set_d(reliable_fractional_part, description.max_world_coordinate, MPFR_RNDU);
+    mpfr_mul_ui(reliable_fractional_part, reliable_fractional_part, 21, MPFR_RNDU);
+    mpfr_mul_d(reliable_fractional_part, reliable_fractional_part, unit_roundoff, MPFR_RNDU);
+    mpfr_div(reliable_fractional_part, reliable_fractional_part, min_grid_step, MPFR_RNDU);
+    const auto min_reliable = mpfr_get_d(reliable_fractional_part, MPFR_RNDN);
+    mpfr_ui_sub(reliable_fractional_part, 1, reliable_fractional_part, MPFR_RNDD);
+    const auto max_reliable = mpfr_get_d(reliable_fractional_part, MPFR_RNDN);
+
+    const GridParameters result {
+        .cell_size = mpfr_get_d(min_grid_step, MPFR_RNDN),
+        .desired_cell_size = mpfr_get_d(min_grid_step, MPFR_RNDN),
+        .min_input = description.min_world_coordinate,
+        .max_input = description.max_world_coordinate,
+        .column_border_intersecion = {
+            .min_reliable_fractional_part = min_reliable,
+            .max_reliable_fractional_part = max_reliable,
+        },
+    };
+
+    mpfr_clear(reliable_fractional_part);
+    mpfr_clear(min_grid_step);
+    return result;
+}
+
+void expect_same_parameters(const GridParameters & lhs, const GridParameters & rhs, const std::string & message)
+{
+    EXPECT_EQ(lhs.cell_size, rhs.cell_size) << message;
+    EXPECT_EQ(lhs.desired_cell_size, rhs.desired_cell_size) << message;
+    EXPECT_EQ(lhs.min_input, rhs.min_input) << message;
+    EXPECT_EQ(lhs.max_input, rhs.max_input) << message;
+    EXPECT_EQ(
+        lhs.column_border_intersecion.min_reliable_fractional_part,
+        rhs.column_border_intersecion.min_reliable_fractional_part)
+        << message;
+    EXPECT_EQ(
+        lhs.column_border_intersecion.max_reliable_fractional_part,
+        rhs.column_border_intersecion.max_reliable_fractional_part)
+        << message;
+}
+
+} // namespace
+
+TEST(ComputeGridParametersTest, same_as_embedded_grid)
+{
+    // The arguments used to generate g_embedded_grid.
+    const auto grid = compute_grid_parameters({
+        .world_cells = 0x1p32,
+        .world_size = 40075016.68,
+        .min_world_coordinate = 0.005,
+        .max_world_coordinate = 0x1p25,
+    });
+    expect_same_parameters(grid, g_embedded_grid, "embedded grid");
+}
+
+TEST(ComputeGridParametersTest, same_as_generator)
+{
+    std::mt19937_64 random { 42 };
+    std::uniform_real_distribution<f64> exponent { -10.0, 40.0 };
+
+    for (size_t i = 0; i < 10000; ++i)
+    {
+        const auto max_world_coordinate = std::exp2(exponent(random));
+        const GridDescription description {
+            .world_cells = std::round(std::exp2(exponent(random))) + 1.0,
+            .world_size = std::exp2(exponent(random)),
+            .min_world_coordinate = max_world_coordinate * 0x1p-30,
+            .max_world_coordinate = max_world_coordinate,
+        };
+        const auto message = fmt::format(
+            "world_cells: {}, world_size: {}, max_world_coordinate: {}",
+            description.world_cells,
+            description.world_size,
+            description.max_world_coordinate);
+        expect_same_parameters(
+            compute_grid_parameters(description),
+            mpfr_compute_grid_parameters(description),
+            message);
+        if (HasFailure())
+        {
+            return;
+        }
+    }
+}
+
+} // namespace ka
@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <thread>
+
+#include <ka/common/fixed.hpp>
+#include <ka/exact/ExactStatistics.hpp>
+#include <ka/exact/grid.hpp>
+#include <ka/exact/orientation.hpp>
+#include <ka/geometry_types/Vec2.hpp>
+
+#include "mock_grid_parameters.hpp"
+
+namespace ka
+{
+
+TEST(ExactStatisticsTest, cell_containing_position)
+{
+    if (!exact_statistics_enabled())
+    {
+        GTEST_SKIP() << "Statistics collection is disabled";
+    }
+    const auto & grid = g_embedded_grid;
+
+    reset_thread_exact_statistics();
+    EXPECT_EQ(column_containing_position<GridRounding::Cell>(grid, 0.15), 16);
+    EXPECT_EQ(thread_exact_statistics().cell_containing_position_filtered, 1);
+    EXPECT_EQ(thread_exact_statistics().cell_containing_position_exact, 0);
+
+    // The quotient is an integer.
+    EXPECT_EQ(column_containing_position<GridRounding::Cell>(grid, 0.0), 0);
+    EXPECT_EQ(thread_exact_statistics().cell_containing_position_filtered, 1);
+    EXPECT_EQ(thread_exact_statistics().cell_containing_position_exact, 1);
+
+    reset_thread_exact_statistics();
+    const std::array<Vec2f64, 3> points { { { 0.15, 0.0 }, { 0.15, 0.15 }, { 0.0, 0.0 } } };
+    std::array<Vec2s64, 3> cells;
+    cells_containing_points<GridRounding::Cell>(grid, points, cells);
+    EXPECT_EQ(thread_exact_statistics().cell_containing_position_filtered, 3);
+    EXPECT_EQ(thread_exact_statistics().cell_containing_position_exact, 3);
+}
+
+TEST(ExactStatisticsTest, border_intersection)
+{
+    if (!exact_statistics_enabled())
+    {
+        GTEST_SKIP() << "Statistics collection is disabled";
+    }
+    const auto & grid = g_embedded_grid;
+
+    reset_thread_exact_statistics();
+    EXPECT_EQ(column_border_intersection<GridRounding::Cell>(grid, 0.1, 0.15, 0.3, 0.15, 20), 16);
+    EXPECT_EQ(thread_exact_statistics().border_intersection_filtered, 1);
+    EXPECT_EQ(thread_exact_statistics().border_intersection_exact, 0);
+
+    // The line passes through the corner of the cell.
+    const auto node = 10.0 * grid.cell_size;
+    EXPECT_EQ(column_border_intersection<GridRounding::Cell>(grid, -node, -node, node, node, 0), 0);
+    EXPECT_EQ(thread_exact_statistics().border_intersection_filtered, 1);
+    EXPECT_EQ(thread_exact_statistics().border_intersection_exact, 1);
+
+    // The intersection is close to the border of the row, but the error bound is small near the origin.
+    const auto near_node = 16.0 * grid.cell_size + 1e-10;
+    EXPECT_EQ(column_border_intersection<GridRounding::Cell>(grid, 0.1, near_node, 0.3, near_node, 20), 16);
+    EXPECT_EQ(thread_exact_statistics().border_intersection_filtered, 2);
+    EXPECT_EQ(thread_exact_statistics().border_intersection_exact, 1);
+}
+
+TEST(ExactStatisticsTest, orientation)
+{
+    if (!exact_statistics_enabled())
+    {
+        GTEST_SKIP() << "Statistics collection is disabled";
+    }
+
+    reset_thread_exact_statistics();
+    EXPECT_GT(orientation(0.0, 0.0, 1.0, 0.0, 0.0, 1.0), 0.0);
+    EXPECT_EQ(thread_exact_statistics().orientation_filtered, 1);
+    EXPECT_EQ(thread_exact_statistics().orientation_adapted, 0);
+    EXPECT_EQ(thread_exact_statistics().orientation_exact, 0);
+
+    // The points are nearly collinear, so the plain floating-point determinant is not reliable.
+    EXPECT_EQ(orientation(0.1, 0.1, 0.2, 0.2, 0.3, 0.3), orientation(0.1, 0.1, 0.2, 0.2, 0.3, 0.3));
+    EXPECT_EQ(thread_exact_statistics().orientation_filtered, 1);
+    EXPECT_EQ(thread_exact_statistics().orientation_adapted + thread_exact_statistics().orientation_exact, 2);
+
+    // Integer orientation is always exact and is not counted.
+    EXPECT_EQ(orientation(s16 { 1 }, s16 { 2 }, s16 { 6 }, s16 { 10 }, s16 { 11 }, s16 { 18 }), s64 { 0 });
+    EXPECT_EQ(thread_exact_statistics().orientation_filtered, 1);
+}
+
+TEST(ExactStatisticsTest, total)
+{
+    if (!exact_statistics_enabled())
+    {
+        GTEST_SKIP() << "Statistics collection is disabled";
+    }
+    const auto & grid = g_embedded_grid;
+
+    reset_thread_exact_statistics();
+    const auto before = total_exact_statistics();
+
+    EXPECT_TRUE(line_intersects_cell<GridRounding::Cell>(grid, 0.1, 0.2, 0.3, 0.5, 10, 21));
+    ExactStatistics running {};
+    std::thread thread {
+        [&]
+        {
+            EXPECT_TRUE(line_intersects_cell<GridRounding::Cell>(grid, 0.1, 0.2, 0.3, 0.5, 10, 21));
+            EXPECT_TRUE(line_intersects_cell<GridRounding::Cell>(grid, 0.1, 0.2, 0.3, 0.5, 10, 21));
+            running = total_exact_statistics();
+        },
+    };
+    thread.join();
+
+    // The counters of the running thread are included.
+    EXPECT_EQ(running.line_intersects_cell_filtered, before.line_intersects_cell_filtered + 3);
+    // The counters of the finished thread are kept.
+    const auto after = total_exact_statistics();
+    EXPECT_EQ(after.line_intersects_cell_filtered, before.line_intersects_cell_filtered + 3);
+    EXPECT_EQ(after.line_intersects_cell_exact, before.line_intersects_cell_exact);
+    EXPECT_EQ(thread_exact_statistics().line_intersects_cell_filtered, 1);
+}
+
+} // namespace ka
@@ -0,0 +1,199 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+#include <span>
+#include <vector>
+
+#include <mpfr.h>
+
+#include <ka/common/fixed.hpp>
+
+#include "expansion.hpp"
+
+namespace ka
+{
+
+inline namespace
+{
+
+/// @brief Exact value of a sum of doubles, the precision covers the whole exponent range of f64.
+class ExactValue final
+{
+public:
+    explicit ExactValue(const std::span<const f64> expansion)
+    {
+        mpfr_init2(value_, 4096);
+        mpfr_set_zero(value_, 1);
+        add(expansion);
+    }
+
+    ExactValue(const ExactValue &) = delete;
+    ExactValue & operator=(const ExactValue &) = delete;
+
+    ~ExactValue()
+    {
+        mpfr_clear(value_);
+    }
+
+public:
+    void add(const std::span<const f64> expansion)
+    {
+        for (const auto component : expansion)
+        {
+            EXPECT_EQ(0, mpfr_add_d(value_, value_, component, MPFR_RNDN));
+        }
+    }
+
+    void subtract(const std::span<const f64> expansion)
+    {
+        for (const auto component : expansion)
+        {
+            EXPECT_EQ(0, mpfr_sub_d(value_, value_, component, MPFR_RNDN));
+        }
+    }
+
+    void multiply(const f64 number)
+    {
+        EXPECT_EQ(0, mpfr_mul_d(value_, value_, number, MPFR_RNDN));
+    }
+
+    [[nodiscard]] bool operator==(const ExactValue & other) const
+    {
+        return mpfr_equal_p(value_, other.value_) != 0;
+    }
+
+private:
+    mpfr_t value_;
+};
+
+/// @brief Generates a nonoverlapping expansion of up to four nonzero components.
+[[nodiscard]] std::vector<f64> random_expansion(std::mt19937_64 & random)
+{
+    std::uniform_real_distribution<f64> mantissa { -1.0, 1.0 };
+    std::uniform_int_distribution<int> exponent { -40, 40 };
+    const auto number = [&]
+    {
+        const auto value = std::ldexp(mantissa(random), exponent(random));
+        // Integers give products and sums without roundoff, so some components are zero.
+        return random() % 4 == 0 ? std::round(value) : value;
+    };
+
+    std::array<f64, 2> product = two_product(number(), number());
+    std::array<f64, 2> sum = two_sum(number(), number());
+    std::array<f64, 4> buffer {};
+    const auto size = fast_expansion_sum_zeroelim(
+        std::span<const f64>(product),
+        std::span<const f64>(sum),
+        std::span<f64>(buffer));
+    return { buffer.begin(), buffer.begin() + static_cast<std::ptrdiff_t>(size) };
+}
+
+/// @brief Checks that the components are nonzero and sorted by increasing magnitude.
+void expect_zero_eliminated(const std::span<const f64> expansion)
+{
+    for (size_t i = 0; i < expansion.size(); ++i)
+    {
+        EXPECT_NE(expansion[i], 0.0) << i;
+        if (i > 0)
+        {
+            EXPECT_LT(std::abs(expansion[i - 1]), std::abs(expansion[i])) << i;
+        }
+    }
+}
+
+} // namespace
+
+TEST(ExpansionTest, sum_zeroelim)
+{
+    std::mt19937_64 random { 42 };
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        const auto lhs = random_expansion(random);
+        const auto rhs = random_expansion(random);
+        std::array<f64, 8> buffer {};
+
+        const auto sum_size = fast_expansion_sum_zeroelim(
+            std::span<const f64>(lhs),
+            std::span<const f64>(rhs),
+            std::span<f64>(buffer));
+        const auto sum = std::span<const f64>(buffer).first(sum_size);
+        expect_zero_eliminated(sum);
+        ExactValue expected_sum { lhs };
+        expected_sum.add(rhs);
+        EXPECT_TRUE(ExactValue { sum } == expected_sum) << i;
+
+        const auto difference_size = fast_expansion_difference_zeroelim(
+            std::span<const f64>(lhs),
+            std::span<const f64>(rhs),
+            std::span<f64>(buffer));
+        const auto difference = std::span<const f64>(buffer).first(difference_size);
+        expect_zero_eliminated(difference);
+        ExactValue expected_difference { lhs };
+        expected_difference.subtract(rhs);
+        EXPECT_TRUE(ExactValue { difference } == expected_difference) << i;
+    }
+}
+
+TEST(ExpansionTest, scale_zeroelim)
+{
+    std::mt19937_64 random { 42 };
+    std::uniform_real_distribution<f64> number { -1e10, 1e10 };
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        const auto expansion = random_expansion(random);
+        const auto factor = i % 10 == 0 ? std::round(number(random)) : number(random);
+        ExactValue expected { expansion };
+        expected.multiply(factor);
+
+        std::array<f64, 8> split_buffer {};
+        const auto split_size = scale_expansion_zeroelim<TwoProduct::Split>(
+            std::span<const f64>(expansion),
+            factor,
+            std::span<f64>(split_buffer));
+        const auto split = std::span<const f64>(split_buffer).first(split_size);
+        expect_zero_eliminated(split);
+        EXPECT_TRUE(ExactValue { split } == expected) << i;
+
+        std::array<f64, 8> fused_buffer {};
+        const auto fused_size = scale_expansion_zeroelim<TwoProduct::Fused>(
+            std::span<const f64>(expansion),
+            factor,
+            std::span<f64>(fused_buffer));
+        const auto fused = std::span<const f64>(fused_buffer).first(fused_size);
+        EXPECT_TRUE(std::ranges::equal(fused, split)) << i;
+    }
+}
+
+TEST(ExpansionTest, zeroelim_cancellation)
+{
+    const std::vector<f64> expansion { 0x1p-60, 0x1p-10, 3.0 };
+    const std::vector<f64> negated { -0x1p-60, -0x1p-10, -3.0 };
+    const std::vector<f64> empty;
+    std::array<f64, 6> buffer {};
+
+    EXPECT_EQ(
+        fast_expansion_sum_zeroelim(
+            std::span<const f64>(expansion),
+            std::span<const f64>(negated),
+            std::span<f64>(buffer)),
+        0);
+    EXPECT_EQ(
+        fast_expansion_difference_zeroelim(
+            std::span<const f64>(expansion),
+            std::span<const f64>(expansion),
+            std::span<f64>(buffer)),
+        0);
+    EXPECT_EQ(scale_expansion_zeroelim(std::span<const f64>(expansion), 0.0, std::span<f64>(buffer)), 0);
+    EXPECT_EQ(scale_expansion_zeroelim(std::span<const f64>(empty), 2.0, std::span<f64>(buffer)), 0);
+
+    const auto size = fast_expansion_difference_zeroelim(
+        std::span<const f64>(empty),
+        std::span<const f64>(expansion),
+        std::span<f64>(buffer));
+    EXPECT_TRUE(std::ranges::equal(std::span<const f64>(buffer).first(size), negated));
+}
+
+} // namespace ka
@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cmath>
+#include <random>
+#include <span>
+
+#include <fmt/format.h>
+
+#include <ka/common/cast.hpp>
+#include <ka/common/fixed.hpp>
+#include <ka/exact/GridParameters.hpp>
+#include <ka/exact/grid.hpp>
+
+#include "mock_grid_parameters.hpp"
+
+namespace ka
+{
+
+inline namespace
+{
+
+constexpr size_t g_levels = 15;
+
+[[nodiscard]] GridParameters level_grid(const GridParameters & grid, const size_t level)
+{
+    auto result = grid;
+    result.cell_size = std::ldexp(grid.cell_size, static_cast<int>(level));
+    return result;
+}
+
+[[nodiscard]] bool valid_input(const GridParameters & grid, const f64 value)
+{
+    return value == 0.0 || (std::abs(value) >= grid.min_input && std::abs(value) <= grid.max_input);
+}
+
+template <GridRounding rounding>
+void check_position_pyramid(const f64 cell_size)
+{
+    auto grid = g_embedded_grid;
+    grid.cell_size = cell_size;
+
+    std::mt19937_64 random { 42 };
+    std::uniform_real_distribution<f64> coordinate { -grid.max_input, grid.max_input };
+    std::uniform_int_distribution<s64> node { -100000, 100000 };
+
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        // Points on the borders and centers of cells are the most difficult for the nearest node rounding.
+        const std::array<f64, 3> positions {
+            coordinate(random),
+            exact_cast<f64>(node(random)) * cell_size,
+            exact_cast<f64>(node(random)) * cell_size / 2.0,
+        };
+        for (const auto x : positions)
+        {
+            if (!valid_input(grid, x))
+            {
+                continue;
+            }
+            std::array<s64, g_levels> columns;
+            column_containing_position_pyramid<rounding>(grid, x, columns);
+            std::array<s64, g_levels> rows;
+            row_containing_position_pyramid<rounding>(grid, x, rows);
+            for (size_t level = 0; level < g_levels; ++level)
+            {
+                const auto expected = column_containing_position<rounding>(level_grid(grid, level), x);
+                ASSERT_EQ(columns[level], expected) << fmt::format("x: {}, level: {}", x, level);
+                ASSERT_EQ(rows[level], expected) << fmt::format("y: {}, level: {}", x, level);
+            }
+        }
+    }
+}
+
+template <GridRounding rounding>
+void check_border_intersection_pyramid(const f64 cell_size)
+{
+    auto grid = g_embedded_grid;
+    grid.cell_size = cell_size;
+
+    std::mt19937_64 random { 42 };
+    std::uniform_real_distribution<f64> coordinate { -1e3 * cell_size, 1e3 * cell_size };
+    std::uniform_int_distribution<size_t> levels_count { 1, g_levels };
+
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        const auto a_x = coordinate(random), a_y = coordinate(random);
+        const auto b_x = coordinate(random), b_y = coordinate(random);
+        if (!valid_input(grid, a_x) || !valid_input(grid, a_y) || !valid_input(grid, b_x) || !valid_input(grid, b_y))
+        {
+            continue;
+        }
+        const auto message = fmt::format("a: {}, {}; b: {}, {}", a_x, a_y, b_x, b_y);
+
+        // Borders of the coarsest level are the borders of all levels.
+        const auto levels = levels_count(random);
+        const auto coarsest_grid = level_grid(grid, levels - 1);
+
+        std::array<s64, g_levels> result;
+        const auto [first_column, last_column] = borders_between_coordinates(coarsest_grid.cell_size, a_x, b_x);
+        for (auto x = first_column; a_x != b_x && x <= last_column; ++x)
+        {
+            const auto c_x = x << (levels - 1);
+            const auto rows = std::span(result).first(levels);
+            column_border_intersection_pyramid<rounding>(grid, a_x, a_y, b_x, b_y, c_x, rows);
+            for (size_t level = 0; level < levels; ++level)
+            {
+                const auto expected =
+                    column_border_intersection<rounding>(level_grid(grid, level), a_x, a_y, b_x, b_y, c_x >> level);
+                ASSERT_EQ(rows[level], expected) << message << fmt::format("; c_x: {}, level: {}", c_x, level);
+            }
+        }
+        const auto [first_row, last_row] = borders_between_coordinates(coarsest_grid.cell_size, a_y, b_y);
+        for (auto y = first_row; a_y != b_y && y <= last_row; ++y)
+        {
+            const auto c_y = y << (levels - 1);
+            const auto columns = std::span(result).first(levels);
+            row_border_intersection_pyramid<rounding>(grid, a_x, a_y, b_x, b_y, c_y, columns);
+            for (size_t level = 0; level < levels; ++level)
+            {
+                const auto expected =
+                    row_border_intersection<rounding>(level_grid(grid, level), a_x, a_y, b_x, b_y, c_y >> level);
+                ASSERT_EQ(columns[level], expected) << message << fmt::format("; c_y: {}, level: {}", c_y, level);
+            }
+        }
+    }
+}
+
+} // namespace
+
+TEST(GridPyramidTest, position)
+{
+    check_position_pyramid<GridRounding::Cell>(g_embedded_grid.cell_size);
+    check_position_pyramid<GridRounding::Cell>(1.0);
+    check_position_pyramid<GridRounding::NearestNode>(g_embedded_grid.cell_size * 2.0);
+    check_position_pyramid<GridRounding::NearestNode>(1.0);
+}
+
+TEST(GridPyramidTest, border_intersection)
+{
+    check_border_intersection_pyramid<GridRounding::Cell>(g_embedded_grid.cell_size);
+    check_border_intersection_pyramid<GridRounding::Cell>(1.0);
+    check_border_intersection_pyramid<GridRounding::NearestNode>(g_embedded_grid.cell_size * 2.0);
+    check_border_intersection_pyramid<GridRounding::NearestNode>(1.0);
+}
+
+} // namespace ka
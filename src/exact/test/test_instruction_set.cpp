@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include <ka/common/cast.hpp>
+#include <ka/common/fixed.hpp>
+#include <ka/exact/InstructionSet.hpp>
+#include <ka/exact/LineCellTester.hpp>
+#include <ka/exact/grid.hpp>
+#include <ka/exact/orientation.hpp>
+#include <ka/geometry_types/Vec2.hpp>
+
+#include "mock_grid_parameters.hpp"
+
+namespace ka
+{
+
+inline namespace
+{
+
+/// @brief Results of the computations that have several implementations.
+struct Results final
+{
+    std::vector<f64> orientations;
+    std::vector<bool> intersections;
+    std::vector<Vec2s64> cells;
+};
+
+/// @brief Runs the computations on inputs that mostly require the exact fallback.
+[[nodiscard]] Results compute_results()
+{
+    const auto & grid = g_embedded_grid;
+    const auto size = grid.cell_size;
+
+    std::mt19937_64 random { 42 };
+    std::uniform_int_distribution<s64> node { -100000, 100000 };
+    std::uniform_int_distribution<s64> offset { -2, 2 };
+    std::uniform_real_distribution<f64> coordinate { -1000.0, 1000.0 };
+
+    Results results;
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        // The segment passes exactly through a grid node.
+        const auto n = node(random), m = node(random);
+        const auto d_x = offset(random) * 3 + 1, d_y = offset(random) * 5 + 1;
+        const auto a_x = exact_cast<f64>(n - d_x) * size, a_y = exact_cast<f64>(m - d_y) * size;
+        const auto b_x = exact_cast<f64>(n + d_x) * size, b_y = exact_cast<f64>(m + d_y) * size;
+        const auto c_x = std::nextafter(exact_cast<f64>(n) * size, coordinate(random));
+
+        results.orientations.push_back(orientation(a_x, a_y, b_x, b_y, c_x, exact_cast<f64>(m) * size));
+        // The third point is next to the midpoint of the segment on the line x = y.
+        const auto p = static_cast<f32>(coordinate(random)), q = static_cast<f32>(coordinate(random));
+        const auto midpoint = (p + q) / 2.0f;
+        results.orientations.push_back(orientation(p, p, q, q, midpoint, std::nextafter(midpoint, q)));
+
+        const LineCellTester<GridRounding::Cell> tester { grid, a_x, a_y, b_x, b_y };
+        std::vector<Vec2s64> cells;
+        for (s64 x = n - 1; x <= n; ++x)
+        {
+            for (s64 y = m - 1; y <= m; ++y)
+            {
+                results.intersections.push_back(
+                    line_intersects_cell<GridRounding::Cell>(grid, a_x, a_y, b_x, b_y, x, y));
+                results.intersections.push_back(
+                    line_intersects_cell<GridRounding::NearestNode>(grid, a_x, a_y, b_x, b_y, x, y));
+                results.intersections.push_back(tester.intersects(x, y));
+                cells.push_back({ x, y });
+            }
+        }
+        std::array<bool, 4> batch_result;
+        tester.intersects(cells, batch_result);
+        results.intersections.insert(results.intersections.end(), batch_result.begin(), batch_result.end());
+    }
+
+    // Every third coordinate lies on a cell border. The number of points is not a multiple of the vector size.
+    std::vector<Vec2f64> points;
+    for (size_t i = 0; i < 1001; ++i)
+    {
+        const auto border = exact_cast<f64>(node(random)) * size;
+        points.push_back({
+            .x = i % 3 == 0 ? border : coordinate(random),
+            .y = i % 3 == 1 ? border : coordinate(random),
+        });
+    }
+    results.cells.resize(points.size());
+    cells_containing_points<GridRounding::Cell>(grid, points, results.cells);
+    return results;
+}
+
+} // namespace
+
+TEST(InstructionSetTest, same_as_generic)
+{
+    const auto initial = exact_instruction_set();
+    EXPECT_EQ(initial, supported_instruction_set());
+
+    set_exact_instruction_set(InstructionSet::Generic);
+    const auto expected = compute_results();
+    for (auto instruction_set = InstructionSet::Fma; instruction_set <= supported_instruction_set();
+         instruction_set = static_cast<InstructionSet>(static_cast<u8>(instruction_set) + 1))
+    {
+        set_exact_instruction_set(instruction_set);
+        EXPECT_EQ(exact_instruction_set(), instruction_set);
+        const auto actual = compute_results();
+        const auto message = fmt::format("instruction set: {}", static_cast<u8>(instruction_set));
+        EXPECT_EQ(actual.orientations, expected.orientations) << message;
+        EXPECT_EQ(actual.intersections, expected.intersections) << message;
+        EXPECT_EQ(actual.cells, expected.cells) << message;
+    }
+    set_exact_instruction_set(initial);
+}
+
+} // namespace ka
@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+
+#include <random>
+
+#include <fmt/format.h>
+
+#include <ka/common/cast.hpp>
+#include <ka/common/fixed.hpp>
+#include <ka/exact/IntegerGridParameters.hpp>
+#include <ka/exact/grid.hpp>
+#include <ka/exact/integer_grid.hpp>
+
+#include "mock_grid_parameters.hpp"
+
+namespace ka
+{
+
+inline namespace
+{
+
+/// @brief Checks that the integer grid gives the same results as the floating-point grid.
+/// The cell size is exactly representable and input coordinates are small integers,
+/// so the exact floating-point functions must agree with the integer ones.
+template <GridRounding rounding>
+void check_same_as_floating_point(const IntegerGridParameters & integer_grid, const s64 range)
+{
+    auto grid = g_embedded_grid;
+    grid.cell_size =
+        exact_cast<f64>(integer_grid.cell_size_numerator) / exact_cast<f64>(integer_grid.cell_size_denominator);
+
+    std::mt19937_64 random { 42 };
+    std::uniform_int_distribution<s64> coordinate { -range, range };
+    std::uniform_int_distribution<s64> offset { -2, 2 };
+
+    for (size_t i = 0; i < 2000; ++i)
+    {
+        const auto a_x = coordinate(random), a_y = coordinate(random);
+        const auto b_x = coordinate(random), b_y = coordinate(random);
+        const auto message = fmt::format("a: {}, {}; b: {}, {}", a_x, a_y, b_x, b_y);
+
+        const auto f_a_x = exact_cast<f64>(a_x), f_a_y = exact_cast<f64>(a_y);
+        const auto f_b_x = exact_cast<f64>(b_x), f_b_y = exact_cast<f64>(b_y);
+
+        const auto c_a_x = column_containing_position<rounding>(integer_grid, a_x);
+        const auto c_a_y = row_containing_position<rounding>(integer_grid, a_y);
+        const auto c_b_x = column_containing_position<rounding>(integer_grid, b_x);
+        const auto c_b_y = row_containing_position<rounding>(integer_grid, b_y);
+        ASSERT_EQ(c_a_x, column_containing_position<rounding>(grid, f_a_x)) << message;
+        ASSERT_EQ(c_a_y, row_containing_position<rounding>(grid, f_a_y)) << message;
+        ASSERT_EQ(c_b_x, column_containing_position<rounding>(grid, f_b_x)) << message;
+        ASSERT_EQ(c_b_y, row_containing_position<rounding>(grid, f_b_y)) << message;
+
+        for (auto x = std::min(c_a_x, c_b_x) - 1; a_x != b_x && x <= std::max(c_a_x, c_b_x) + 1; ++x)
+        {
+            const auto between = border_between_coordinates(integer_grid, a_x, b_x, x);
+            ASSERT_EQ(between, border_between_coordinates(grid.cell_size, f_a_x, f_b_x, x)) << message << "; x: " << x;
+            if (between)
+            {
+                ASSERT_EQ(
+                    column_border_intersection<rounding>(integer_grid, a_x, a_y, b_x, b_y, x),
+                    column_border_intersection<rounding>(grid, f_a_x, f_a_y, f_b_x, f_b_y, x))
+                    << message << "; x: " << x;
+            }
+        }
+        for (auto y = std::min(c_a_y, c_b_y) - 1; a_y != b_y && y <= std::max(c_a_y, c_b_y) + 1; ++y)
+        {
+            const auto between = border_between_coordinates(integer_grid, a_y, b_y, y);
+            ASSERT_EQ(between, border_between_coordinates(grid.cell_size, f_a_y, f_b_y, y)) << message << "; y: " << y;
+            if (between)
+            {
+                ASSERT_EQ(
+                    row_border_intersection<rounding>(integer_grid, a_x, a_y, b_x, b_y, y),
+                    row_border_intersection<rounding>(grid, f_a_x, f_a_y, f_b_x, f_b_y, y))
+                    << message << "; y: " << y;
+            }
+        }
+
+        for (size_t j = 0; j < 8 && (a_x != b_x || a_y != b_y); ++j)
+        {
+            const auto c_x = (j % 2 == 0 ? c_a_x : c_b_x) + offset(random);
+            const auto c_y = (j % 2 == 0 ? c_a_y : c_b_y) + offset(random);
+            ASSERT_EQ(
+                line_intersects_cell<rounding>(integer_grid, a_x, a_y, b_x, b_y, c_x, c_y),
+                line_intersects_cell<rounding>(grid, f_a_x, f_a_y, f_b_x, f_b_y, c_x, c_y))
+                << message << fmt::format("; c: {}, {}", c_x, c_y);
+        }
+    }
+}
+
+} // namespace
+
+TEST(IntegerGridTest, same_as_floating_point)
+{
+    check_same_as_floating_point<GridRounding::Cell>({ .cell_size_numerator = 1, .cell_size_denominator = 1 }, 20);
+    check_same_as_floating_point<GridRounding::Cell>({ .cell_size_numerator = 3, .cell_size_denominator = 2 }, 20);
+    check_same_as_floating_point<GridRounding::Cell>({ .cell_size_numerator = 5, .cell_size_denominator = 256 }, 5);
+    check_same_as_floating_point<GridRounding::Cell>(
+        { .cell_size_numerator = 1000, .cell_size_denominator = 1 },
+        10'000'000);
+    check_same_as_floating_point<GridRounding::NearestNode>(
+        { .cell_size_numerator = 1, .cell_size_denominator = 1 },
+        20);
+    check_same_as_floating_point<GridRounding::NearestNode>(
+        { .cell_size_numerator = 3, .cell_size_denominator = 2 },
+        20);
+    check_same_as_floating_point<GridRounding::NearestNode>(
+        { .cell_size_numerator = 5, .cell_size_denominator = 256 },
+        5);
+    check_same_as_floating_point<GridRounding::NearestNode>(
+        { .cell_size_numerator = 1000, .cell_size_denominator = 1 },
+        10'000'000);
+}
+
+TEST(IntegerGridTest, large_coordinates)
+{
+    // Degrees scaled by 10^7 and the cell size of 1/2^20 of the full turn.
+    const IntegerGridParameters grid { .cell_size_numerator = 3'600'000'000, .cell_size_denominator = 1 << 20 };
+    const s64 a_x = -1'799'999'999, a_y = -899'999'999;
+    const s64 b_x = 1'799'999'999, b_y = 899'999'999;
+
+    EXPECT_EQ(column_containing_position<GridRounding::Cell>(grid, a_x), -524'288);
+    EXPECT_EQ(column_containing_position<GridRounding::Cell>(grid, b_x), 524'287);
+    EXPECT_EQ(column_containing_position<GridRounding::NearestNode>(grid, b_x), 524'288);
+
+    // The line passes through the origin.
+    EXPECT_EQ(column_border_intersection<GridRounding::Cell>(grid, a_x, a_y, b_x, b_y, 0), 0);
+    EXPECT_EQ(column_border_intersection<GridRounding::Cell>(grid, a_x, -a_y, b_x, -b_y, 0), 0);
+    EXPECT_EQ(column_border_intersection<GridRounding::Cell>(grid, a_x, a_y - 1, b_x, b_y - 1, 0), -1);
+    EXPECT_EQ(column_border_intersection<GridRounding::NearestNode>(grid, a_x, a_y - 1, b_x, b_y - 1, 0), 0);
+    EXPECT_TRUE(line_intersects_cell<GridRounding::Cell>(grid, a_x, a_y, b_x, b_y, 0, 0));
+    EXPECT_TRUE(line_intersects_cell<GridRounding::Cell>(grid, a_x, a_y, b_x, b_y, -1, -1));
+    EXPECT_FALSE(line_intersects_cell<GridRounding::Cell>(grid, a_x, a_y, b_x, b_y, -1, 0));
+    EXPECT_FALSE(line_intersects_cell<GridRounding::Cell>(grid, a_x, a_y, b_x, b_y, 0, -1));
+}
+
+} // namespace ka
@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cmath>
+#include <random>
+
+#include <fmt/format.h>
+
+#include <ka/common/cast.hpp>
+#include <ka/common/fixed.hpp>
+#include <ka/exact/LineCellTester.hpp>
+#include <ka/exact/grid.hpp>
+#include <ka/geometry_types/Vec2.hpp>
+
+#include "mock_grid_parameters.hpp"
+
+namespace ka
+{
+
+inline namespace
+{
+
+template <GridRounding rounding>
+void check_same_as_line_intersects_cell(const f64 cell_size)
+{
+    auto grid = g_embedded_grid;
+    grid.cell_size = cell_size;
+
+    std::mt19937_64 random { 42 };
+    std::uniform_real_distribution<f64> coordinate { -100.0 * cell_size, 100.0 * cell_size };
+    std::uniform_int_distribution<s64> offset { -3, 3 };
+
+    // Several batches of the filter and an incomplete one.
+    constexpr size_t cells_per_line = 40;
+    for (size_t line = 0; line < 1000; ++line)
+    {
+        auto a_x = coordinate(random), a_y = coordinate(random);
+        auto b_x = coordinate(random), b_y = coordinate(random);
+        // Some lines are axis-aligned or pass exactly through grid nodes.
+        switch (line % 10)
+        {
+        case 0:
+            b_x = a_x;
+            break;
+        case 1:
+            b_y = a_y;
+            break;
+        case 2:
+            a_x = std::round(a_x / cell_size) * cell_size;
+            a_y = std::round(a_y / cell_size) * cell_size;
+            b_x = a_x + 7 * cell_size;
+            b_y = a_y - 7 * cell_size;
+            break;
+        }
+
+        const LineCellTester<rounding> tester { grid, a_x, a_y, b_x, b_y };
+
+        // Cells near the line.
+        std::array<Vec2s64, cells_per_line> cells;
+        for (size_t i = 0; i < cells.size(); ++i)
+        {
+            const auto t = exact_cast<f64>(i) / exact_cast<f64>(cells.size() - 1);
+            cells[i] = {
+                .x = column_containing_position<rounding>(grid, a_x + t * (b_x - a_x)) + offset(random),
+                .y = row_containing_position<rounding>(grid, a_y + t * (b_y - a_y)) + offset(random),
+            };
+        }
+
+        std::array<bool, cells_per_line> batch_result;
+        tester.intersects(cells, batch_result);
+
+        for (size_t i = 0; i < cells.size(); ++i)
+        {
+            const auto expected = line_intersects_cell<rounding>(grid, a_x, a_y, b_x, b_y, cells[i].x, cells[i].y);
+            const auto message =
+                fmt::format("a: {}, {}; b: {}, {}; c: {}, {}", a_x, a_y, b_x, b_y, cells[i].x, cells[i].y);
+            ASSERT_EQ(tester.intersects(cells[i].x, cells[i].y), expected) << message;
+            ASSERT_EQ(batch_result[i], expected) << message;
+        }
+    }
+}
+
+} // namespace
+
+TEST(LineCellTesterTest, same_as_line_intersects_cell)
+{
+    check_same_as_line_intersects_cell<GridRounding::Cell>(1.0);
+    check_same_as_line_intersects_cell<GridRounding::Cell>(g_embedded_grid.cell_size);
+    check_same_as_line_intersects_cell<GridRounding::NearestNode>(1.0);
+    check_same_as_line_intersects_cell<GridRounding::NearestNode>(2.0 * g_embedded_grid.cell_size);
+}
+
+} // namespace ka
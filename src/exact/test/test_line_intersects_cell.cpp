@@ -0,0 +1,178 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+
+#include <fmt/format.h>
+#include <mpfr.h>
+
+#include <ka/common/fixed.hpp>
+#include <ka/exact/ExactStatistics.hpp>
+#include <ka/exact/grid.hpp>
+
+#include "mock_grid_parameters.hpp"
+
+namespace ka
+{
+
+inline namespace
+{
+
+/// @brief Computes the sign of the determinant
+///     (a.x - size * n) * (b.y - size * m) - (a.y - size * m) * (b.x - size * n)
+/// exactly.
+[[nodiscard]] int exact_determinant_sign(
+    const f64 a_x,
+    const f64 a_y,
+    const f64 b_x,
+    const f64 b_y,
+    const s64 n,
+    const s64 m,
+    const f64 size)
+{
+    constexpr auto precision = 4096;
+    mpfr_t node_x;
+    mpfr_init2(node_x, precision);
+    mpfr_t node_y;
+    mpfr_init2(node_y, precision);
+    mpfr_t lhs;
+    mpfr_init2(lhs, precision);
+    mpfr_t rhs;
+    mpfr_init2(rhs, precision);
+    mpfr_t tmp;
+    mpfr_init2(tmp, precision);
+
+    EXPECT_EQ(0, mpfr_set_si(node_x, n, MPFR_RNDN));
+    EXPECT_EQ(0, mpfr_mul_d(node_x, node_x, size, MPFR_RNDN));
+    EXPECT_EQ(0, mpfr_set_si(node_y, m, MPFR_RNDN));
+    EXPECT_EQ(0, mpfr_mul_d(node_y, node_y, size, MPFR_RNDN));
+
+    /// (a.x - size * n) * (b.y - size * m)
+    EXPECT_EQ(0, mpfr_set_d(lhs, a_x, MPFR_RNDN));
+    EXPECT_EQ(0, mpfr_sub(lhs, lhs, node_x, MPFR_RNDN));
+    EXPECT_EQ(0, mpfr_set_d(tmp, b_y, MPFR_RNDN));
+    EXPECT_EQ(0, mpfr_sub(tmp, tmp, node_y, MPFR_RNDN));
+    EXPECT_EQ(0, mpfr_mul(lhs, lhs, tmp, MPFR_RNDN));
+
+    /// (a.y - size * m) * (b.x - size * n)
+    EXPECT_EQ(0, mpfr_set_d(rhs, a_y, MPFR_RNDN));
+    EXPECT_EQ(0, mpfr_sub(rhs, rhs, node_y, MPFR_RNDN));
+    EXPECT_EQ(0, mpfr_set_d(tmp, b_x, MPFR_RNDN));
+    EXPECT_EQ(0, mpfr_sub(tmp, tmp, node_x, MPFR_RNDN));
+    EXPECT_EQ(0, mpfr_mul(rhs, rhs, tmp, MPFR_RNDN));
+
+    const auto result = mpfr_less_p(rhs, lhs) ? 1 : mpfr_less_p(lhs, rhs) ? -1 : 0;
+
+    mpfr_clears(node_x, node_y, lhs, rhs, tmp, nullptr);
+
+    return result;
+}
+
+/// @brief Reference implementation of line_intersects_cell using exact determinant signs.
+template <GridRounding rounding>
+[[nodiscard]] bool exact_line_intersects_cell(
+    const GridParameters & grid,
+    const f64 a_x,
+    const f64 a_y,
+    const f64 b_x,
+    const f64 b_y,
+    const s64 c_x,
+    const s64 c_y)
+{
+    const bool main_diagonal = (a_x <= b_x && a_y >= b_y) || (a_x >= b_x && a_y <= b_y);
+    const bool invert_signs = main_diagonal ? a_x >= b_x && a_y <= b_y : a_x < b_x;
+
+    const auto step = rounding == GridRounding::Cell ? 1 : 2;
+    const auto size = rounding == GridRounding::Cell ? grid.cell_size : grid.cell_size / 2;
+    const auto n = rounding == GridRounding::Cell ? c_x : c_x * 2 - 1;
+    const auto m = rounding == GridRounding::Cell ? (main_diagonal ? c_y : c_y + 1)
+                                                  : (main_diagonal ? c_y * 2 - 1 : c_y * 2 + 1);
+
+    const auto first_sign = exact_determinant_sign(a_x, a_y, b_x, b_y, n, m, size);
+    if (main_diagonal && first_sign == 0)
+    {
+        return true;
+    }
+    if (invert_signs ? first_sign <= 0 : first_sign >= 0)
+    {
+        return false;
+    }
+    const auto second_sign =
+        exact_determinant_sign(a_x, a_y, b_x, b_y, n + step, main_diagonal ? m + step : m - step, size);
+    return invert_signs ? second_sign < 0 : second_sign > 0;
+}
+
+template <GridRounding rounding>
+void check_same_as_exact(const f64 cell_size, const f64 range)
+{
+    auto grid = g_embedded_grid;
+    grid.cell_size = cell_size;
+
+    std::mt19937_64 random { 42 };
+    std::uniform_real_distribution<f64> coordinate { -range, range };
+    std::uniform_int_distribution<s64> offset { -2, 2 };
+    std::uniform_int_distribution<s64> direction { -5, 5 };
+
+    for (size_t line = 0; line < 2000; ++line)
+    {
+        auto a_x = coordinate(random), a_y = coordinate(random);
+        auto b_x = coordinate(random), b_y = coordinate(random);
+        // Some lines pass exactly through grid nodes, so the floating-point filter can not decide.
+        if (line % 2 == 0)
+        {
+            a_x = std::round(a_x / cell_size) * cell_size;
+            a_y = std::round(a_y / cell_size) * cell_size;
+            b_x = a_x + exact_cast<f64>(direction(random)) * cell_size;
+            b_y = a_y + exact_cast<f64>(direction(random)) * cell_size;
+        }
+
+        for (size_t i = 0; i < 8; ++i)
+        {
+            const auto t = exact_cast<f64>(i) / 7.0;
+            const auto c_x = column_containing_position<rounding>(grid, a_x + t * (b_x - a_x)) + offset(random);
+            const auto c_y = row_containing_position<rounding>(grid, a_y + t * (b_y - a_y)) + offset(random);
+            ASSERT_EQ(
+                (line_intersects_cell<rounding>(grid, a_x, a_y, b_x, b_y, c_x, c_y)),
+                (exact_line_intersects_cell<rounding>(grid, a_x, a_y, b_x, b_y, c_x, c_y)))
+                << fmt::format("a: {}, {}; b: {}, {}; c: {}, {}", a_x, a_y, b_x, b_y, c_x, c_y);
+        }
+    }
+}
+
+} // namespace
+
+TEST(LineIntersectsCellTest, same_as_exact)
+{
+    check_same_as_exact<GridRounding::Cell>(1.0, 100.0);
+    check_same_as_exact<GridRounding::Cell>(g_embedded_grid.cell_size, 1.0);
+    check_same_as_exact<GridRounding::Cell>(g_embedded_grid.cell_size, g_embedded_grid.max_input);
+    check_same_as_exact<GridRounding::NearestNode>(1.0, 100.0);
+    check_same_as_exact<GridRounding::NearestNode>(2.0 * g_embedded_grid.cell_size, 1.0);
+    check_same_as_exact<GridRounding::NearestNode>(2.0 * g_embedded_grid.cell_size, g_embedded_grid.max_input);
+}
+
+TEST(LineIntersectsCellTest, statistics)
+{
+    if (!exact_statistics_enabled())
+    {
+        GTEST_SKIP() << "Statistics collection is disabled";
+    }
+    const auto & grid = g_embedded_grid;
+
+    reset_thread_exact_statistics();
+    EXPECT_TRUE(line_intersects_cell<GridRounding::Cell>(grid, 0.1, 0.2, 0.3, 0.5, 10, 21));
+    EXPECT_EQ(thread_exact_statistics().line_intersects_cell_filtered, 1);
+    EXPECT_EQ(thread_exact_statistics().line_intersects_cell_exact, 0);
+
+    // The line passes through the corner of the cell.
+    const auto node = 10.0 * grid.cell_size;
+    EXPECT_TRUE(line_intersects_cell<GridRounding::Cell>(grid, node, node, 2.0 * node, 0.0, 10, 10));
+    EXPECT_EQ(thread_exact_statistics().line_intersects_cell_filtered, 1);
+    EXPECT_EQ(thread_exact_statistics().line_intersects_cell_exact, 1);
+
+    reset_thread_exact_statistics();
+    EXPECT_EQ(thread_exact_statistics().line_intersects_cell_filtered, 0);
+    EXPECT_EQ(thread_exact_statistics().line_intersects_cell_exact, 0);
+}
+
+} // namespace ka
@@ -1,18 +1,126 @@
 #include <gtest/gtest.h>
 
 #include <cmath>
+#include <limits>
+#include <random>
+#include <span>
+#include <vector>
+
+#include <mpfr.h>
 
 #include <ka/exact/orientation.hpp>
+#include <ka/geometry_types/Vec2.hpp>
 
 namespace ka
 {
 
+inline namespace
+{
+
+/// @brief Computes the sign of the orientation determinant exactly.
+[[nodiscard]] int exact_orientation_sign(
+    const f64 a_x,
+    const f64 a_y,
+    const f64 b_x,
+    const f64 b_y,
+    const f64 c_x,
+    const f64 c_y)
+{
+    constexpr auto precision = 4096;
+
+    mpfr_t lhs;
+    mpfr_init2(lhs, precision);
+    mpfr_t rhs;
+    mpfr_init2(rhs, precision);
+    mpfr_t tmp;
+    mpfr_init2(tmp, precision);
+
+    /// (b_x - a_x) * (c_y - a_y)
+    EXPECT_EQ(0, mpfr_set_d(lhs, b_x, MPFR_RNDN));
+    EXPECT_EQ(0, mpfr_sub_d(lhs, lhs, a_x, MPFR_RNDN));
+    EXPECT_EQ(0, mpfr_set_d(tmp, c_y, MPFR_RNDN));
+    EXPECT_EQ(0, mpfr_sub_d(tmp, tmp, a_y, MPFR_RNDN));
+    EXPECT_EQ(0, mpfr_mul(lhs, lhs, tmp, MPFR_RNDN));
+
+    /// (b_y - a_y) * (c_x - a_x)
+    EXPECT_EQ(0, mpfr_set_d(rhs, b_y, MPFR_RNDN));
+    EXPECT_EQ(0, mpfr_sub_d(rhs, rhs, a_y, MPFR_RNDN));
+    EXPECT_EQ(0, mpfr_set_d(tmp, c_x, MPFR_RNDN));
+    EXPECT_EQ(0, mpfr_sub_d(tmp, tmp, a_x, MPFR_RNDN));
+    EXPECT_EQ(0, mpfr_mul(rhs, rhs, tmp, MPFR_RNDN));
+
+    const auto result = mpfr_less_p(rhs, lhs) ? 1 : mpfr_less_p(lhs, rhs) ? -1 : 0;
+
+    mpfr_clears(lhs, rhs, tmp, nullptr);
+
+    return result;
+}
+
+[[nodiscard]] int sign(const f64 value)
+{
+    return (value > 0) - (value < 0);
+}
+
+/// @brief Computes the sign of the orientation determinant of coordinates whose differences fit into s64.
+[[nodiscard]] s64 reference_orientation_sign(
+    const s64 a_x,
+    const s64 a_y,
+    const s64 b_x,
+    const s64 b_y,
+    const s64 c_x,
+    const s64 c_y)
+{
+    using s128 = __int128;
+    const auto determinant = s128 { b_x - a_x } * (c_y - a_y) - s128 { c_x - a_x } * (b_y - a_y);
+    return (determinant > 0) - (determinant < 0);
+}
+
+/// @brief Checks the scalar and the batch orientation of random triples against the 128-bit reference.
+template <typename I>
+void check_wide_orientation_random(const I range)
+{
+    std::mt19937_64 random { 42 };
+    std::uniform_int_distribution<I> coordinate { static_cast<I>(-range), range };
+    std::uniform_int_distribution<I> parameter { -3, 3 };
+    std::uniform_int_distribution<I> shift { -1, 1 };
+
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        const auto a_x = static_cast<I>(coordinate(random) / 2), a_y = static_cast<I>(coordinate(random) / 2);
+        const auto d_x = static_cast<I>(coordinate(random) / 8), d_y = static_cast<I>(coordinate(random) / 8);
+        const auto b_x = static_cast<I>(a_x + d_x), b_y = static_cast<I>(a_y + d_y);
+
+        // Points on the line and next to it are mixed with arbitrary points.
+        std::vector<Vec2<I>> points;
+        for (size_t j = 0; j < 16; ++j)
+        {
+            const auto t = parameter(random);
+            points.push_back({ static_cast<I>(a_x + t * d_x + shift(random)), static_cast<I>(a_y + t * d_y) });
+            points.push_back({ coordinate(random), coordinate(random) });
+        }
+
+        std::vector<s64> results(points.size());
+        orientations(a_x, a_y, b_x, b_y, std::span<const Vec2<I>>(points), std::span(results));
+        for (size_t j = 0; j < points.size(); ++j)
+        {
+            const auto [c_x, c_y] = points[j];
+            const auto expected = reference_orientation_sign(a_x, a_y, b_x, b_y, c_x, c_y);
+            ASSERT_EQ(orientation(a_x, a_y, b_x, b_y, c_x, c_y), expected) << i << ", " << j;
+            ASSERT_EQ(results[j], expected) << i << ", " << j;
+        }
+    }
+}
+
+} // namespace
+
 TEST(OrientationTest, simple_collinear)
 {
     EXPECT_EQ(orientation(f32 { 1 }, f32 { 2 }, f32 { 6 }, f32 { 10 }, f32 { 11 }, f32 { 18 }), f32 { 0 });
     EXPECT_EQ(orientation(f64 { 1 }, f64 { 2 }, f64 { 6 }, f64 { 10 }, f64 { 11 }, f64 { 18 }), f64 { 0 });
     EXPECT_EQ(orientation(u16 { 1 }, u16 { 2 }, u16 { 6 }, u16 { 10 }, u16 { 11 }, u16 { 18 }), s64 { 0 });
     EXPECT_EQ(orientation(s16 { 1 }, s16 { 2 }, s16 { 6 }, s16 { 10 }, s16 { 11 }, s16 { 18 }), s64 { 0 });
+    EXPECT_EQ(orientation(s32 { 1 }, s32 { 2 }, s32 { 6 }, s32 { 10 }, s32 { 11 }, s32 { 18 }), s64 { 0 });
+    EXPECT_EQ(orientation(s64 { 1 }, s64 { 2 }, s64 { 6 }, s64 { 10 }, s64 { 11 }, s64 { 18 }), s64 { 0 });
 }
 
 TEST(OrientationTest, simple_negative)
@@ -20,6 +128,8 @@ TEST(OrientationTest, simple_negative)
     EXPECT_GT(orientation(f32 { 1 }, f32 { -98 }, f32 { 1 }, f32 { -90 }, f32 { -100 }, f32 { -10 }), f32 { 0 });
     EXPECT_GT(orientation(f64 { 1 }, f64 { -98 }, f64 { 1 }, f64 { -90 }, f64 { -100 }, f64 { -10 }), f64 { 0 });
     EXPECT_GT(orientation(s16 { 1 }, s16 { -98 }, s16 { 1 }, s16 { -90 }, s16 { -100 }, s16 { -10 }), s64 { 0 });
+    EXPECT_GT(orientation(s32 { 1 }, s32 { -98 }, s32 { 1 }, s32 { -90 }, s32 { -100 }, s32 { -10 }), s64 { 0 });
+    EXPECT_GT(orientation(s64 { 1 }, s64 { -98 }, s64 { 1 }, s64 { -90 }, s64 { -100 }, s64 { -10 }), s64 { 0 });
 }
 
 TEST(OrientationTest, simple_right_turn)
@@ -28,6 +138,8 @@ TEST(OrientationTest, simple_right_turn)
     EXPECT_LT(orientation(f64 { 1 }, f64 { 2 }, f64 { 6 }, f64 { 10 }, f64 { 11 + 1 }, f64 { 18 }), f64 { 0 });
     EXPECT_LT(orientation(u16 { 1 }, u16 { 2 }, u16 { 6 }, u16 { 10 }, u16 { 11 + 1 }, u16 { 18 }), s64 { 0 });
     EXPECT_LT(orientation(s16 { 1 }, s16 { 2 }, s16 { 6 }, s16 { 10 }, s16 { 11 + 1 }, s16 { 18 }), s64 { 0 });
+    EXPECT_LT(orientation(s32 { 1 }, s32 { 2 }, s32 { 6 }, s32 { 10 }, s32 { 11 + 1 }, s32 { 18 }), s64 { 0 });
+    EXPECT_LT(orientation(s64 { 1 }, s64 { 2 }, s64 { 6 }, s64 { 10 }, s64 { 11 + 1 }, s64 { 18 }), s64 { 0 });
 }
 
 TEST(OrientationTest, simple_left_turn)
@@ -36,6 +148,34 @@ TEST(OrientationTest, simple_left_turn)
     EXPECT_GT(orientation(f64 { 1 }, f64 { 2 }, f64 { 6 }, f64 { 10 }, f64 { 11 - 1 }, f64 { 18 }), f64 { 0 });
     EXPECT_GT(orientation(u16 { 1 }, u16 { 2 }, u16 { 6 }, u16 { 10 }, u16 { 11 - 1 }, u16 { 18 }), s64 { 0 });
     EXPECT_GT(orientation(s16 { 1 }, s16 { 2 }, s16 { 6 }, s16 { 10 }, s16 { 11 - 1 }, s16 { 18 }), s64 { 0 });
+    EXPECT_GT(orientation(s32 { 1 }, s32 { 2 }, s32 { 6 }, s32 { 10 }, s32 { 11 - 1 }, s32 { 18 }), s64 { 0 });
+    EXPECT_GT(orientation(s64 { 1 }, s64 { 2 }, s64 { 6 }, s64 { 10 }, s64 { 11 - 1 }, s64 { 18 }), s64 { 0 });
+}
+
+TEST(OrientationTest, integer_extreme_coordinates)
+{
+    // Differences and products of these coordinates overflow the signed types of the same width.
+    constexpr auto min32 = std::numeric_limits<s32>::min(), max32 = std::numeric_limits<s32>::max();
+    EXPECT_EQ(orientation(min32, min32, max32, max32, s32 { 0 }, s32 { 0 }), s64 { 0 });
+    EXPECT_GT(orientation(min32, min32, max32, max32, s32 { -1 }, s32 { 0 }), s64 { 0 });
+    EXPECT_LT(orientation(min32, min32, max32, max32, s32 { 0 }, s32 { -2 }), s64 { 0 });
+    EXPECT_GT(orientation(max32, min32, max32, max32, min32, s32 { 0 }), s64 { 0 });
+    EXPECT_LT(orientation(min32, max32, max32, min32, min32, min32), s64 { 0 });
+
+    constexpr auto min64 = std::numeric_limits<s64>::min(), max64 = std::numeric_limits<s64>::max();
+    EXPECT_EQ(orientation(min64, min64, max64, max64, s64 { 0 }, s64 { 0 }), s64 { 0 });
+    EXPECT_GT(orientation(min64, min64, max64, max64, s64 { -1 }, s64 { 0 }), s64 { 0 });
+    EXPECT_LT(orientation(min64, min64, max64, max64, s64 { 0 }, s64 { -2 }), s64 { 0 });
+    EXPECT_GT(orientation(max64, min64, max64, max64, min64, s64 { 0 }), s64 { 0 });
+    EXPECT_LT(orientation(min64, max64, max64, min64, min64, min64), s64 { 0 });
+    // The products differ by one: max64 * (max64 - 2) versus (max64 - 1)^2.
+    EXPECT_EQ(orientation(s64 { 0 }, s64 { 0 }, max64, max64 - 1, max64 - 1, max64 - 2), s64 { -1 });
+}
+
+TEST(OrientationTest, integer_random)
+{
+    check_wide_orientation_random<s32>(std::numeric_limits<s32>::max());
+    check_wide_orientation_random<s64>(s64 { 1 } << 61);
 }
 
 TEST(OrientationTest, hard_collinear)
@@ -77,4 +217,54 @@ TEST(OrientationTest, slight_left_turn)
         0.0);
 }
 
+TEST(OrientationTest, collinear_inexact_differences)
+{
+    // Differences of the coordinates are inexact, so the exact expansion stage is required.
+    const f64 a = 0x1.9p-60, b = 0x1.3p-1, c = 0x1.7p+60;
+    EXPECT_EQ(orientation(a, a, b, b, c, c), 0.0);
+    EXPECT_EQ(orientation(c, c, a, a, b, b), 0.0);
+
+    const auto above = std::nextafter(c, std::numeric_limits<f64>::infinity());
+    EXPECT_EQ(sign(orientation(a, a, b, b, c, above)), exact_orientation_sign(a, a, b, b, c, above));
+    EXPECT_GT(orientation(a, a, b, b, c, above), 0.0);
+    const auto below = std::nextafter(a, -std::numeric_limits<f64>::infinity());
+    EXPECT_EQ(sign(orientation(a, below, b, b, c, c)), exact_orientation_sign(a, below, b, b, c, c));
+    EXPECT_LT(orientation(a, below, b, b, c, c), 0.0);
+}
+
+TEST(OrientationTest, nearly_collinear_random)
+{
+    std::mt19937_64 random { 42 };
+    std::uniform_real_distribution<f64> coordinate { -1e6, 1e6 };
+    std::uniform_real_distribution<f64> parameter { -2.0, 2.0 };
+    std::uniform_int_distribution<int> ulps { -4, 4 };
+
+    const auto perturb = [&](f64 value)
+    {
+        const auto steps = ulps(random);
+        const auto direction = steps < 0 ? -std::numeric_limits<f64>::infinity() : std::numeric_limits<f64>::infinity();
+        for (auto i = 0; i < std::abs(steps); ++i)
+        {
+            value = std::nextafter(value, direction);
+        }
+        return value;
+    };
+
+    for (size_t i = 0; i < 10000; ++i)
+    {
+        const auto a_x = coordinate(random), a_y = coordinate(random);
+        const auto b_x = coordinate(random), b_y = coordinate(random);
+        const auto t = parameter(random);
+        const auto c_x = perturb(a_x + t * (b_x - a_x));
+        const auto c_y = perturb(a_y + t * (b_y - a_y));
+
+        ASSERT_EQ(sign(orientation(a_x, a_y, b_x, b_y, c_x, c_y)), exact_orientation_sign(a_x, a_y, b_x, b_y, c_x, c_y))
+            << i;
+        ASSERT_EQ(sign(orientation(b_x, b_y, c_x, c_y, a_x, a_y)), exact_orientation_sign(b_x, b_y, c_x, c_y, a_x, a_y))
+            << i;
+        ASSERT_EQ(sign(orientation(b_x, b_y, a_x, a_y, c_x, c_y)), exact_orientation_sign(b_x, b_y, a_x, a_y, c_x, c_y))
+            << i;
+    }
+}
+
 } // namespace ka
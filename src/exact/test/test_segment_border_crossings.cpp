@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+
+#include <fmt/format.h>
+
+#include <ka/common/cast.hpp>
+#include <ka/common/fixed.hpp>
+#include <ka/exact/SegmentBorderCrossings.hpp>
+#include <ka/exact/grid.hpp>
+
+#include "mock_grid_parameters.hpp"
+
+namespace ka
+{
+
+inline namespace
+{
+
+void check_borders_range(const f64 cell_size, const f64 a, const f64 b, const std::pair<s64, s64> range)
+{
+    const auto [first, last] = range;
+    const auto message = fmt::format("a: {}, b: {}, first: {}, last: {}", a, b, first, last);
+    if (a == b)
+    {
+        ASSERT_GT(first, last) << message;
+        return;
+    }
+    if (first > last)
+    {
+        // No borders between the coordinates.
+        ASSERT_EQ(first, last + 1) << message;
+        ASSERT_FALSE(border_between_coordinates(cell_size, a, b, first)) << message;
+        ASSERT_FALSE(border_between_coordinates(cell_size, a, b, last)) << message;
+        return;
+    }
+    ASSERT_TRUE(border_between_coordinates(cell_size, a, b, first)) << message;
+    ASSERT_TRUE(border_between_coordinates(cell_size, a, b, last)) << message;
+    ASSERT_FALSE(border_between_coordinates(cell_size, a, b, first - 1)) << message;
+    ASSERT_FALSE(border_between_coordinates(cell_size, a, b, last + 1)) << message;
+}
+
+[[nodiscard]] bool valid_input(const GridParameters & grid, const f64 value)
+{
+    return value == 0.0 || (std::abs(value) >= grid.min_input && std::abs(value) <= grid.max_input);
+}
+
+template <GridRounding rounding>
+void check_same_as_single_border(const f64 cell_size, const f64 range)
+{
+    auto grid = g_embedded_grid;
+    grid.cell_size = cell_size;
+
+    std::mt19937_64 random { 42 };
+    std::uniform_real_distribution<f64> coordinate { -range, range };
+    std::uniform_real_distribution<f64> length { 0.0, 40.0 * cell_size };
+
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        auto a_x = coordinate(random), a_y = coordinate(random);
+        auto b_x = a_x + length(random) - 20.0 * cell_size, b_y = a_y + length(random) - 20.0 * cell_size;
+        switch (i % 4)
+        {
+        case 0:
+            // Endpoints lie exactly on the borders.
+            a_x = std::round(a_x / cell_size) * cell_size;
+            b_y = std::round(b_y / cell_size) * cell_size;
+            break;
+        case 1:
+            b_x = a_x;
+            break;
+        case 2:
+            b_y = a_y;
+            break;
+        }
+        if ((a_x == b_x && a_y == b_y) || !valid_input(grid, a_x) || !valid_input(grid, a_y) ||
+            !valid_input(grid, b_x) || !valid_input(grid, b_y))
+        {
+            continue;
+        }
+
+        const SegmentBorderCrossings<rounding> crossings { grid, a_x, a_y, b_x, b_y };
+        check_borders_range(cell_size, a_x, b_x, crossings.column_borders());
+        check_borders_range(cell_size, a_y, b_y, crossings.row_borders());
+
+        const auto message = fmt::format("a: {}, {}; b: {}, {}", a_x, a_y, b_x, b_y);
+        for (auto x = crossings.column_borders().first; x <= crossings.column_borders().second; ++x)
+        {
+            ASSERT_EQ(
+                crossings.column_border_intersection(x),
+                column_border_intersection<rounding>(grid, a_x, a_y, b_x, b_y, x))
+                << message << "; x: " << x;
+        }
+        for (auto y = crossings.row_borders().first; y <= crossings.row_borders().second; ++y)
+        {
+            ASSERT_EQ(
+                crossings.row_border_intersection(y),
+                row_border_intersection<rounding>(grid, a_x, a_y, b_x, b_y, y))
+                << message << "; y: " << y;
+        }
+    }
+}
+
+} // namespace
+
+TEST(SegmentBorderCrossingsTest, same_as_single_border)
+{
+    check_same_as_single_border<GridRounding::Cell>(1.0, 100.0);
+    check_same_as_single_border<GridRounding::Cell>(g_embedded_grid.cell_size, 1.0);
+    check_same_as_single_border<GridRounding::Cell>(g_embedded_grid.cell_size, g_embedded_grid.max_input / 2.0);
+    check_same_as_single_border<GridRounding::NearestNode>(1.0, 100.0);
+    check_same_as_single_border<GridRounding::NearestNode>(2.0 * g_embedded_grid.cell_size, 1.0);
+    check_same_as_single_border<GridRounding::NearestNode>(
+        2.0 * g_embedded_grid.cell_size,
+        g_embedded_grid.max_input / 2.0);
+}
+
+} // namespace ka
@@ -0,0 +1,211 @@
+#pragma once
+
+#include <concepts>
+#include <ranges>
+#include <span>
+#include <vector>
+
+#include <ka/common/assert.hpp>
+#include <ka/common/fixed.hpp>
+#include <ka/geometry_types/Vec2.hpp>
+
+namespace ka
+{
+
+/// @brief Multipolygon stored in flat arrays.
+/// Coordinates of all points are stored in two separate arrays of x and y. Rings are ranges of points and parts are
+/// ranges of rings, both are defined by offsets like in the compressed sparse row format. So the whole geometry takes
+/// a fixed number of allocations regardless of the number of rings.
+/// @note Rings are not required to be closed, so a multilinestring is stored with one polyline per part.
+template <typename T>
+class MultiPolygon2 final
+{
+public:
+    using CoordinateType = T;
+
+    /// @brief Creates a point from its index in the coordinate arrays.
+    class PointAt final
+    {
+    public:
+        PointAt() noexcept = default;
+
+        PointAt(const T * xs, const T * ys) noexcept
+            : xs_ { xs }
+            , ys_ { ys }
+        {
+        }
+
+    public:
+        [[nodiscard]] Vec2<T> operator()(const size_t i) const noexcept
+        {
+            return { xs_[i], ys_[i] };
+        }
+
+    private:
+        const T * xs_ = nullptr;
+        const T * ys_ = nullptr;
+    };
+
+    /// @brief Random access range of the points of a ring.
+    /// Points are created on access, so the ranges of the ring coordinates should be used to read them in bulk.
+    using RingView = std::ranges::transform_view<std::ranges::iota_view<size_t, size_t>, PointAt>;
+
+public:
+    /// @note The offset arrays always contain the leading zero offset, so even an empty multipolygon allocates them.
+    MultiPolygon2()
+        : ring_offsets_ { 0 }
+        , part_offsets_ { 0 }
+    {
+    }
+
+public:
+    /// @brief Removes all parts. Allocated memory is kept for reuse.
+    void clear() noexcept
+    {
+        xs_.clear();
+        ys_.clear();
+        ring_offsets_.resize(1);
+        part_offsets_.resize(1);
+    }
+
+    void reserve(const size_t points, const size_t rings, const size_t parts)
+    {
+        xs_.reserve(points);
+        ys_.reserve(points);
+        ring_offsets_.reserve(rings + 1);
+        part_offsets_.reserve(parts + 1);
+    }
+
+    /// @brief Starts a new empty part. The following rings are added to it.
+    void add_part()
+    {
+        part_offsets_.push_back(part_offsets_.back());
+    }
+
+    /// @brief Starts a new empty ring of the last part. The following points are added to it.
+    /// @pre There is at least one part.
+    void add_ring()
+    {
+        AR_PRE(part_count() > 0);
+        ring_offsets_.push_back(ring_offsets_.back());
+        ++part_offsets_.back();
+    }
+
+    /// @brief Adds the ring consisting of the given points to the last part.
+    /// @pre There is at least one part.
+    template <std::ranges::input_range R>
+        requires std::convertible_to<std::ranges::range_reference_t<R>, Vec2<T>>
+    void add_ring(R && ring)
+    {
+        add_ring();
+        for (const Vec2<T> point : ring)
+        {
+            add_point(point);
+        }
+    }
+
+    /// @brief Adds the point to the last ring.
+    /// @pre There is at least one ring in the last part.
+    void add_point(const Vec2<T> & point)
+    {
+        AR_PRE(part_count() > 0);
+        AR_PRE(ring_count() > part_offsets_[part_count() - 1]);
+        xs_.push_back(point.x);
+        ys_.push_back(point.y);
+        ++ring_offsets_.back();
+    }
+
+public:
+    [[nodiscard]] size_t part_count() const noexcept
+    {
+        return part_offsets_.size() - 1;
+    }
+
+    [[nodiscard]] size_t ring_count() const noexcept
+    {
+        return ring_offsets_.size() - 1;
+    }
+
+    [[nodiscard]] size_t point_count() const noexcept
+    {
+        return xs_.size();
+    }
+
+    /// @brief Returns the x coordinates of all points, the points of every ring are adjacent.
+    [[nodiscard]] std::span<const T> xs() const noexcept
+    {
+        return xs_;
+    }
+
+    /// @brief Returns the y coordinates of all points, the points of every ring are adjacent.
+    [[nodiscard]] std::span<const T> ys() const noexcept
+    {
+        return ys_;
+    }
+
+    /// @brief Returns the ring_count() + 1 offsets of the first points of the rings in the coordinate arrays.
+    /// The last offset is point_count().
+    [[nodiscard]] std::span<const size_t> ring_offsets() const noexcept
+    {
+        return ring_offsets_;
+    }
+
+    /// @brief Returns the part_count() + 1 indices of the first rings of the parts.
+    /// The last index is ring_count().
+    [[nodiscard]] std::span<const size_t> part_offsets() const noexcept
+    {
+        return part_offsets_;
+    }
+
+    /// @brief Returns the indices of the rings of the part.
+    [[nodiscard]] std::ranges::iota_view<size_t, size_t> part_rings(const size_t part) const noexcept
+    {
+        AR_PRE(part < part_count());
+        return { part_offsets_[part], part_offsets_[part + 1] };
+    }
+
+    [[nodiscard]] std::span<const T> ring_xs(const size_t ring) const noexcept
+    {
+        AR_PRE(ring < ring_count());
+        return std::span(xs_).subspan(ring_offsets_[ring], ring_offsets_[ring + 1] - ring_offsets_[ring]);
+    }
+
+    [[nodiscard]] std::span<const T> ring_ys(const size_t ring) const noexcept
+    {
+        AR_PRE(ring < ring_count());
+        return std::span(ys_).subspan(ring_offsets_[ring], ring_offsets_[ring + 1] - ring_offsets_[ring]);
+    }
+
+    /// @brief Returns the points of the ring.
+    /// @note The view is invalidated when points are added.
+    [[nodiscard]] RingView ring(const size_t ring) const noexcept
+    {
+        AR_PRE(ring < ring_count());
+        return {
+            std::views::iota(ring_offsets_[ring], ring_offsets_[ring + 1]),
+            PointAt { xs_.data(), ys_.data() },
+        };
+    }
+
+    /// @brief Returns the range of the points of all rings of all parts.
+    [[nodiscard]] auto rings() const noexcept
+    {
+        return std::views::iota(size_t { 0 }, ring_count()) |
+               std::views::transform(
+                   [this](const size_t i)
+                   {
+                       return ring(i);
+                   });
+    }
+
+private:
+    std::vector<T> xs_;
+    std::vector<T> ys_;
+    std::vector<size_t> ring_offsets_;
+    std::vector<size_t> part_offsets_;
+};
+
+using MultiPolygon2s64 = MultiPolygon2<s64>;
+using MultiPolygon2f64 = MultiPolygon2<f64>;
+
+} // namespace ka
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <algorithm>
+#include <compare>
+#include <concepts>
+#include <functional>
+#include <iterator>
+#include <ranges>
+#include <utility>
+#include <vector>
+
+#include <ka/common/assert.hpp>
+#include <ka/common/fixed.hpp>
+#include <ka/geometry_types/Vec2.hpp>
+
+namespace ka
+{
+
+enum class SpaceFillingCurve
+{
+    /// @brief Z-order curve. Keys are cheap to compute, but the curve jumps between quadrants.
+    Morton,
+    /// @brief Hilbert curve. Consecutive points of the curve are always neighbours, so the locality is better.
+    Hilbert,
+};
+
+/// @brief Position of a point along a space-filling curve covering the whole range of Vec2s64.
+/// Two coordinates of 64 bits give a key of 128 bits, it is stored as two words compared lexicographically.
+struct CurveKey final
+{
+    u64 high;
+    u64 low;
+
+    [[nodiscard]] constexpr auto operator<=>(const CurveKey &) const noexcept = default;
+};
+
+namespace detail
+{
+
+/// @brief Maps signed coordinate to unsigned one preserving the order.
+[[nodiscard]] constexpr u64 curve_coordinate(const s64 coordinate) noexcept
+{
+    return static_cast<u64>(coordinate) ^ (u64 { 1 } << 63);
+}
+
+/// @brief Moves bit i of the lower half of the value to bit 2i.
+[[nodiscard]] constexpr u64 spread_bits(u64 value) noexcept
+{
+    value &= 0x0000'0000'ffff'ffff;
+    value = (value | value << 16) & 0x0000'ffff'0000'ffff;
+    value = (value | value << 8) & 0x00ff'00ff'00ff'00ff;
+    value = (value | value << 4) & 0x0f0f'0f0f'0f0f'0f0f;
+    value = (value | value << 2) & 0x3333'3333'3333'3333;
+    value = (value | value << 1) & 0x5555'5555'5555'5555;
+    return value;
+}
+
+/// @brief Appends the Hilbert curve digits of the given levels to the key word.
+/// The state of the curve is kept in the coordinates, they are rotated in place.
+[[nodiscard]] constexpr u64 hilbert_digits(u64 & x, u64 & y, const int first_level, const int last_level) noexcept
+{
+    u64 key = 0;
+    for (auto level = first_level; level >= last_level; --level)
+    {
+        const auto rx = (x >> level) & 1;
+        const auto ry = (y >> level) & 1;
+        key = key << 2 | ((3 * rx) ^ ry);
+        if (ry == 0)
+        {
+            if (rx == 1)
+            {
+                // Higher bits are already processed, so the reflection can be applied to the whole word.
+                x = ~x;
+                y = ~y;
+            }
+            std::swap(x, y);
+        }
+    }
+    return key;
+}
+
+} // namespace detail
+
+/// @brief Returns the position of the point along the Z-order curve.
+/// Bits of x and y are interleaved, x takes the lower bit of every pair.
+[[nodiscard]] constexpr CurveKey morton_key(const Vec2s64 & point) noexcept
+{
+    const auto x = detail::curve_coordinate(point.x);
+    const auto y = detail::curve_coordinate(point.y);
+    return {
+        .high = detail::spread_bits(x >> 32) | detail::spread_bits(y >> 32) << 1,
+        .low = detail::spread_bits(x) | detail::spread_bits(y) << 1,
+    };
+}
+
+/// @brief Returns the position of the point along the Hilbert curve.
+[[nodiscard]] constexpr CurveKey hilbert_key(const Vec2s64 & point) noexcept
+{
+    auto x = detail::curve_coordinate(point.x);
+    auto y = detail::curve_coordinate(point.y);
+    const auto high = detail::hilbert_digits(x, y, 63, 32);
+    const auto low = detail::hilbert_digits(x, y, 31, 0);
+    return { .high = high, .low = low };
+}
+
+[[nodiscard]] constexpr CurveKey curve_key(const SpaceFillingCurve curve, const Vec2s64 & point) noexcept
+{
+    switch (curve)
+    {
+    case SpaceFillingCurve::Morton:
+        return morton_key(point);
+    case SpaceFillingCurve::Hilbert:
+        return hilbert_key(point);
+    }
+    AR_UNREACHABLE;
+}
+
+/// @brief Reorders the range along the space-filling curve by the points returned by the projection.
+/// Keys are computed once per element, elements with equal keys keep their relative order.
+template <std::ranges::random_access_range R, typename Proj = std::identity>
+    requires std::convertible_to<std::indirect_result_t<Proj &, std::ranges::iterator_t<R>>, Vec2s64> &&
+             std::movable<std::ranges::range_value_t<R>>
+void sort_along_curve(R && range, const SpaceFillingCurve curve, Proj proj = {})
+{
+    const auto size = static_cast<size_t>(std::ranges::distance(range));
+    const auto first = std::ranges::begin(range);
+
+    std::vector<std::pair<CurveKey, size_t>> order;
+    order.reserve(size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        order.emplace_back(curve_key(curve, std::invoke(proj, first[i])), i);
+    }
+    std::ranges::sort(order);
+
+    std::vector<std::ranges::range_value_t<R>> sorted;
+    sorted.reserve(size);
+    for (const auto & [key, i] : order)
+    {
+        sorted.push_back(std::ranges::iter_move(first + i));
+    }
+    std::ranges::move(sorted, first);
+}
+
+} // namespace ka
@@ -0,0 +1,89 @@
+#include <benchmark/benchmark.h>
+
+#include <iterator>
+#include <random>
+#include <vector>
+
+#include <ka/common/cast.hpp>
+#include <ka/common/fixed.hpp>
+#include <ka/exact/GridParameters.hpp>
+#include <ka/exact/GridRounding.hpp>
+#include <ka/exact/compute_grid_parameters.hpp>
+#include <ka/geometry_types/Segment2.hpp>
+#include <ka/geometry_types/Vec2.hpp>
+#include <ka/tilecut/TileCellGrid.hpp>
+
+namespace ka
+{
+
+inline namespace
+{
+
+/// @brief Number of segments cycled through by every benchmark.
+constexpr size_t g_input_count = 4096;
+
+/// @brief Number of cells along a side of a tile.
+constexpr u16 g_tile_size = 4096;
+
+/// @brief Parameters of the grid for EPSG:3857 computed like ka_generate_grid does for production grids.
+[[nodiscard]] GridParameters production_grid() noexcept
+{
+    auto grid = compute_grid_parameters({
+        .world_cells = 0x1p32,
+        .world_size = 40075016.68,
+        .min_world_coordinate = 0.005,
+        .max_world_coordinate = 0x1p25,
+    });
+    // Nearest node rounding requires the cell size to be at least twice the minimal one.
+    grid.cell_size *= 2.0;
+    return grid;
+}
+
+/// @brief The argument of the benchmark is the number of tile columns crossed by every segment.
+/// The segments are nearly horizontal, so they rarely cross tile rows.
+template <GridRounding rounding>
+void bench_tile_boundary_intersection_cells(benchmark::State & state)
+{
+    const TileCellGrid<rounding> grid { production_grid(), {}, g_tile_size };
+    const auto tile_length = exact_cast<f64>(g_tile_size) * grid.cell_size();
+    const auto length = exact_cast<f64>(state.range(0)) * tile_length;
+
+    std::mt19937_64 random { 42 };
+    std::uniform_real_distribution<f64> coordinate { -20037508.34, 20037508.34 };
+    std::uniform_real_distribution<f64> offset { 0.0, 100.0 * grid.cell_size() };
+
+    std::vector<Segment2f64> segments;
+    std::vector<Segment2s64> segments_cells;
+    for (size_t i = 0; i < g_input_count; ++i)
+    {
+        const Vec2f64 a { coordinate(random), coordinate(random) };
+        const Segment2f64 segment { a, { a.x + length, a.y + offset(random) } };
+        segments.push_back(segment);
+        segments_cells.push_back({ grid.cell_of(segment.a), grid.cell_of(segment.b) });
+    }
+
+    std::vector<Vec2s64> cells;
+    size_t crossings = 0;
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        const auto input = i++ % g_input_count;
+        cells.clear();
+        grid.tile_boundary_intersection_cells(segments[input], segments_cells[input], std::back_inserter(cells));
+        benchmark::DoNotOptimize(cells.data());
+        crossings += cells.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["crossings"] = benchmark::Counter(exact_cast<f64>(crossings), benchmark::Counter::kIsRate);
+}
+
+using enum GridRounding;
+
+// A single crossing measures the fixed cost per segment, longer segments the cost per crossed boundary.
+
+BENCHMARK_TEMPLATE(bench_tile_boundary_intersection_cells, Cell)->Arg(1)->Arg(16)->Arg(256);
+BENCHMARK_TEMPLATE(bench_tile_boundary_intersection_cells, NearestNode)->Arg(1)->Arg(16)->Arg(256);
+
+} // namespace
+
+} // namespace ka
@@ -0,0 +1,266 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <span>
+#include <vector>
+
+#include <ka/common/assert.hpp>
+#include <ka/common/fixed.hpp>
+#include <ka/geometry_types/Segment2.hpp>
+#include <ka/geometry_types/Vec2.hpp>
+
+/// Segments are encoded one after another as differences of coordinates, so a segment takes from 2 to 12 bytes
+/// instead of 8. The difference is taken modulo 2^16, so it fits into s16, then it is zigzag encoded, so that small
+/// negative values become small unsigned values, and is written as a varint, seven bits per byte.
+///
+/// Every segment starts with a varint of the zigzag encoded difference of x doubled, its lowest bit is the jump flag.
+/// - Without the jump the segment starts at the end of the previous one, and the varints are the differences b - a.
+/// - With the jump the first two varints are the differences between a and the end of the previous segment,
+///   and two more varints follow with the differences b - a.
+/// The end of the imaginary segment preceding the first one is the origin of the tile.
+
+namespace ka
+{
+
+namespace detail
+{
+
+/// @brief Maximum number of bytes of a varint of the jump flag and a zigzag encoded difference.
+constexpr size_t g_max_varint_size = 3;
+
+[[nodiscard]] constexpr u32 zigzag_difference(const u16 to, const u16 from) noexcept
+{
+    const auto difference = static_cast<s16>(static_cast<u16>(to - from));
+    return static_cast<u16>((static_cast<u16>(difference) << 1) ^ static_cast<u16>(difference >> 15));
+}
+
+[[nodiscard]] constexpr u16 add_zigzag_difference(const u16 from, const u32 zigzag) noexcept
+{
+    const auto difference = static_cast<u16>((zigzag >> 1) ^ (0u - (zigzag & 1)));
+    return static_cast<u16>(from + difference);
+}
+
+[[nodiscard]] constexpr size_t varint_size(const u32 value) noexcept
+{
+    return value < (1u << 7) ? 1 : value < (1u << 14) ? 2 : 3;
+}
+
+inline void write_varint(std::vector<u8> & bytes, u32 value)
+{
+    AR_PRE(value < (1u << 7 * g_max_varint_size));
+    while (value >= 0x80)
+    {
+        bytes.push_back(static_cast<u8>(value | 0x80));
+        value >>= 7;
+    }
+    bytes.push_back(static_cast<u8>(value));
+}
+
+[[nodiscard]] inline u32 read_varint(const u8 *& position) noexcept
+{
+    u32 value = 0;
+    for (u32 shift = 0;; shift += 7)
+    {
+        const auto byte = *position++;
+        value |= u32 { byte & 0x7fu } << shift;
+        if (byte < 0x80)
+        {
+            return value;
+        }
+        AR_ASSERT(shift + 7 < 7 * g_max_varint_size);
+    }
+}
+
+} // namespace detail
+
+/// @brief Range of segments stored by CompactSegmentsEncoder.
+/// Segments are decoded on the fly by the forward iterator, so the range can be passed to find_cuts directly.
+class CompactSegments final
+{
+public:
+    class Iterator final
+    {
+    public:
+        /// @brief Segments are returned by value, so the iterator is a forward iterator only for the ranges library.
+        using iterator_concept = std::forward_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Segment2u16;
+        using difference_type = std::ptrdiff_t;
+
+    public:
+        Iterator() noexcept = default;
+
+        Iterator(const u8 * position, const size_t remaining) noexcept
+            : position_ { position }
+            , remaining_ { remaining }
+        {
+            if (remaining_ > 0)
+            {
+                decode();
+            }
+        }
+
+    public:
+        [[nodiscard]] Segment2u16 operator*() const noexcept
+        {
+            AR_PRE(remaining_ > 0);
+            return segment_;
+        }
+
+        Iterator & operator++() noexcept
+        {
+            AR_PRE(remaining_ > 0);
+            if (--remaining_ > 0)
+            {
+                decode();
+            }
+            return *this;
+        }
+
+        Iterator operator++(int) noexcept
+        {
+            auto result = *this;
+            ++*this;
+            return result;
+        }
+
+        /// @brief Iterators of the same range are equal when the same number of segments remains.
+        [[nodiscard]] bool operator==(const Iterator & other) const noexcept
+        {
+            return remaining_ == other.remaining_;
+        }
+
+    private:
+        void decode() noexcept
+        {
+            const auto header = detail::read_varint(position_);
+            const auto jump = (header & 1) != 0;
+            Vec2u16 a = segment_.b;
+            Vec2u16 b {
+                .x = detail::add_zigzag_difference(a.x, header >> 1),
+                .y = detail::add_zigzag_difference(a.y, detail::read_varint(position_)),
+            };
+            if (jump)
+            {
+                a = b;
+                b.x = detail::add_zigzag_difference(a.x, detail::read_varint(position_));
+                b.y = detail::add_zigzag_difference(a.y, detail::read_varint(position_));
+            }
+            segment_ = { a, b };
+        }
+
+    private:
+        const u8 * position_ = nullptr;
+        size_t remaining_ = 0;
+        Segment2u16 segment_ {};
+    };
+
+public:
+    CompactSegments() noexcept = default;
+
+    CompactSegments(const std::span<const u8> bytes, const size_t size) noexcept
+        : bytes_ { bytes }
+        , size_ { size }
+    {
+    }
+
+public:
+    [[nodiscard]] Iterator begin() const noexcept
+    {
+        return { bytes_.data(), size_ };
+    }
+
+    [[nodiscard]] Iterator end() const noexcept
+    {
+        return { bytes_.data() + bytes_.size(), 0 };
+    }
+
+    [[nodiscard]] size_t size() const noexcept
+    {
+        return size_;
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return size_ == 0;
+    }
+
+    /// @brief Returns the encoded segments, e.g. to store or to copy them.
+    [[nodiscard]] std::span<const u8> bytes() const noexcept
+    {
+        return bytes_;
+    }
+
+private:
+    std::span<const u8> bytes_;
+    size_t size_ = 0;
+};
+
+/// @brief Appends segments to the byte buffer in the compact form.
+/// It has push_back, so std::back_inserter can be used to write segments, e.g. the result of find_cuts.
+class CompactSegmentsEncoder final
+{
+public:
+    using value_type = Segment2u16;
+
+public:
+    /// @param bytes buffer to append segments to. Previous contents of the buffer are kept.
+    explicit CompactSegmentsEncoder(std::vector<u8> & bytes) noexcept
+        : bytes_ { &bytes }
+        , first_byte_ { bytes.size() }
+    {
+    }
+
+public:
+    /// @brief Returns the number of bytes taken by the segment following a segment ending at last_point.
+    [[nodiscard]] static size_t encoded_size(const Vec2u16 & last_point, const Segment2u16 & segment) noexcept
+    {
+        const auto size = detail::varint_size(detail::zigzag_difference(segment.b.y, segment.a.y));
+        if (segment.a == last_point)
+        {
+            return size + detail::varint_size(detail::zigzag_difference(segment.b.x, segment.a.x) << 1);
+        }
+        return size + detail::varint_size(detail::zigzag_difference(segment.a.x, last_point.x) << 1 | 1) +
+               detail::varint_size(detail::zigzag_difference(segment.a.y, last_point.y)) +
+               detail::varint_size(detail::zigzag_difference(segment.b.x, segment.a.x));
+    }
+
+    void push_back(const Segment2u16 & segment)
+    {
+        if (segment.a == last_point_)
+        {
+            detail::write_varint(*bytes_, detail::zigzag_difference(segment.b.x, segment.a.x) << 1);
+        }
+        else
+        {
+            detail::write_varint(*bytes_, detail::zigzag_difference(segment.a.x, last_point_.x) << 1 | 1);
+            detail::write_varint(*bytes_, detail::zigzag_difference(segment.a.y, last_point_.y));
+            detail::write_varint(*bytes_, detail::zigzag_difference(segment.b.x, segment.a.x));
+        }
+        detail::write_varint(*bytes_, detail::zigzag_difference(segment.b.y, segment.a.y));
+        last_point_ = segment.b;
+        ++size_;
+    }
+
+    /// @brief Returns the number of appended segments.
+    [[nodiscard]] size_t size() const noexcept
+    {
+        return size_;
+    }
+
+    /// @brief Returns the appended segments.
+    /// @note The range is invalidated when the buffer is reallocated.
+    [[nodiscard]] CompactSegments segments() const noexcept
+    {
+        return { std::span<const u8>(*bytes_).subspan(first_byte_), size_ };
+    }
+
+private:
+    std::vector<u8> * bytes_;
+    size_t first_byte_;
+    size_t size_ = 0;
+    Vec2u16 last_point_ {};
+};
+
+} // namespace ka
@@ -1,13 +1,23 @@
 #pragma once
 
 #include <concepts>
+#include <iterator>
+#include <limits>
 #include <ranges>
+#include <span>
+#include <utility>
 #include <vector>
 
+#include <ka/exact/GridParameters.hpp>
 #include <ka/exact/GridRounding.hpp>
+#include <ka/geometry_types/Segment2.hpp>
 #include <ka/geometry_types/Vec2.hpp>
 #include <ka/tilecut/HotPixelIndex.hpp>
+#include <ka/tilecut/IntegerTileCellGrid.hpp>
 #include <ka/tilecut/TileCellGrid.hpp>
+#include <ka/tilecut/TileGrid.hpp>
+#include <ka/tilecut/TiledHotPixelIndex.hpp>
+#include <ka/tilecut/radix_sort.hpp>
 
 namespace ka
 {
@@ -15,6 +25,8 @@ namespace ka
 /// @brief Collects hot pixels to index.
 class HotPixelCollector final
 {
+    friend class ParallelHotPixelCollector;
+
 public:
     /// @brief Resets the collector to its original state. Clears all accumulated hot pixels.
     void reset() noexcept
@@ -22,14 +34,125 @@ public:
         hot_pixels_.clear();
     }
 
+    /// @brief Frees the memory of the collected hot pixels, e.g. once all required indexes are built.
+    /// The built indexes stay valid, since they keep their own copies of the hot pixels.
+    void release_hot_pixels() noexcept
+    {
+        hot_pixels_ = std::vector<Vec2s64> {};
+    }
+
     /// @brief Adds hot pixels corresponding to vertices and intersections with tile boundaries of the polyline.
     /// @param grid defines the tile grid and cell grid sizes.
     /// @param polyline vertices of the polyline.
-    template <GridRounding rounding, std::ranges::input_range In>
+    template <GridRounding rounding, GridParameters static_grid, std::ranges::input_range In>
         requires std::same_as<std::ranges::range_value_t<In>, Vec2f64>
-    void add_tile_snapped_polyline(const TileCellGrid<rounding> & grid, In && polyline) noexcept
+    void add_tile_snapped_polyline(const TileCellGrid<rounding, static_grid> & grid, In && polyline) noexcept
+    {
+        if constexpr (std::ranges::contiguous_range<In> && std::ranges::sized_range<In>)
+        {
+            add_contiguous_polyline(grid, std::span<const Vec2f64>(polyline));
+        }
+        else
+        {
+            add_polyline<Vec2f64>(grid, std::forward<In>(polyline));
+        }
+    }
+
+    /// @brief Same as add_tile_snapped_polyline, but for fixed-point integer coordinates.
+    template <GridRounding rounding, std::ranges::input_range In>
+        requires std::same_as<std::ranges::range_value_t<In>, Vec2s64>
+    void add_tile_snapped_polyline(const IntegerTileCellGrid<rounding> & grid, In && polyline) noexcept
+    {
+        add_polyline<Vec2s64>(grid, std::forward<In>(polyline));
+    }
+
+    /// @brief Builds the index of the collected hot pixels.
+    /// The index is invalidated on HotPixelCollector modifications other than release_hot_pixels.
+    /// @param sort_policy algorithm used to sort hot pixels.
+    [[nodiscard]] const HotPixelIndex & build_index(const SortPolicy sort_policy = SortPolicy::Comparison) noexcept
+    {
+        AR_PRE(!hot_pixels_.empty());
+
+        sort_by_key(hot_pixels_, radix_key, sort_policy);
+        const auto to_remove = std::ranges::unique(hot_pixels_);
+        hot_pixels_.erase(to_remove.begin(), to_remove.end());
+
+        AR_PRE(hot_pixels_.size() <= std::numeric_limits<u32>::max());
+        index_.xs_.clear();
+        index_.offsets_.clear();
+        index_.ys_.clear();
+        index_.ys_.reserve(hot_pixels_.size());
+        for (const auto & pixel : hot_pixels_)
+        {
+            if (index_.xs_.empty() || index_.xs_.back() != pixel.x)
+            {
+                index_.xs_.push_back(pixel.x);
+                index_.offsets_.push_back(static_cast<u32>(index_.ys_.size()));
+            }
+            index_.ys_.push_back(pixel.y);
+        }
+        index_.offsets_.push_back(static_cast<u32>(index_.ys_.size()));
+        return index_;
+    }
+
+    /// @brief Builds the index of hot pixels grouped by the tiles of the grid.
+    /// The index is invalidated on HotPixelCollector modifications other than release_hot_pixels.
+    /// @param tile_grid tile grid of the cell grid used to snap polylines.
+    /// @param sort_policy algorithm used to sort hot pixels.
+    [[nodiscard]] const TiledHotPixelIndex & build_tiled_index(
+        const TileGrid & tile_grid,
+        const SortPolicy sort_policy = SortPolicy::Comparison) noexcept
     {
-        Vec2f64 prev_vertex {};
+        AR_PRE(!hot_pixels_.empty());
+
+        sort_by_key(
+            hot_pixels_,
+            [&](const Vec2s64 & pixel)
+            {
+                const auto tile = tile_grid.tile_of(pixel);
+                return RadixKey<4> { tile.x, tile.y, pixel.x, pixel.y };
+            },
+            sort_policy);
+        const auto to_remove = std::ranges::unique(hot_pixels_);
+        hot_pixels_.erase(to_remove.begin(), to_remove.end());
+
+        AR_PRE(hot_pixels_.size() <= std::numeric_limits<u32>::max());
+
+        auto & index = tiled_index_;
+        index.tile_grid_ = tile_grid;
+        index.tiles_.clear();
+        index.tile_columns_.clear();
+        index.column_xs_.clear();
+        index.column_rows_.clear();
+        index.ys_.clear();
+        index.ys_.reserve(hot_pixels_.size());
+        for (const auto & pixel : hot_pixels_)
+        {
+            const auto tile = tile_grid.tile_of(pixel);
+            const auto local = tile_grid.local_coordinates(tile, pixel);
+            const bool new_tile = index.tiles_.empty() || index.tiles_.back() != tile;
+            if (new_tile)
+            {
+                index.tiles_.push_back(tile);
+                index.tile_columns_.push_back(static_cast<u32>(index.column_xs_.size()));
+            }
+            if (new_tile || index.column_xs_.back() != local.x)
+            {
+                index.column_xs_.push_back(local.x);
+                index.column_rows_.push_back(static_cast<u32>(index.ys_.size()));
+            }
+            index.ys_.push_back(local.y);
+        }
+        index.tile_columns_.push_back(static_cast<u32>(index.column_xs_.size()));
+        index.column_rows_.push_back(static_cast<u32>(index.ys_.size()));
+        return index;
+    }
+
+private:
+    template <typename Vertex, typename Grid, std::ranges::input_range In>
+    void add_polyline(const Grid & grid, In && polyline) noexcept
+    {
+        Vertex prev_vertex {};
         Vec2s64 prev_pixel {};
         bool first = true;
 
@@ -52,35 +175,30 @@ public:
         }
     }
 
-    /// @brief The index is invalidated on HotPixelCollector modifications.
-    [[nodiscard]] const HotPixelIndex & build_index() noexcept
+    /// @brief Same as add_tile_snapped_polyline, but rounds all vertices of the polyline at once.
+    template <GridRounding rounding, GridParameters static_grid>
+    void add_contiguous_polyline(
+        const TileCellGrid<rounding, static_grid> & grid,
+        const std::span<const Vec2f64> polyline) noexcept
     {
-        AR_PRE(!hot_pixels_.empty());
+        const auto first_pixel = hot_pixels_.size();
+        hot_pixels_.resize(first_pixel + polyline.size());
+        grid.cell_of(polyline, std::span(hot_pixels_).subspan(first_pixel));
 
-        std::ranges::sort(hot_pixels_);
-        const auto to_remove = std::ranges::unique(hot_pixels_);
-        hot_pixels_.erase(to_remove.begin(), to_remove.end());
-
-        index_.columns_.clear();
-
-        size_t span_start = 0;
-        auto current_x = hot_pixels_.front().x;
-        for (size_t i = 0; i < hot_pixels_.size(); ++i)
+        for (size_t i = 1; i < polyline.size(); ++i)
         {
-            if (hot_pixels_[i].x != current_x)
-            {
-                index_.columns_.push_back({ current_x, std::span(hot_pixels_).subspan(span_start, i - span_start) });
-                current_x = hot_pixels_[i].x;
-                span_start = i;
-            }
+            const Segment2s64 segment_cells { hot_pixels_[first_pixel + i - 1], hot_pixels_[first_pixel + i] };
+            grid.tile_boundary_intersection_cells(
+                { polyline[i - 1], polyline[i] },
+                segment_cells,
+                std::back_inserter(hot_pixels_));
         }
-        index_.columns_.push_back({ current_x, std::span(hot_pixels_).subspan(span_start) });
-        return index_;
     }
 
 private:
     std::vector<Vec2s64> hot_pixels_;
     HotPixelIndex index_;
+    TiledHotPixelIndex tiled_index_;
 };
 
 } // namespace ka
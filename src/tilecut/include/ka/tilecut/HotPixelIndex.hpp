@@ -3,25 +3,114 @@
 #include <algorithm>
 #include <concepts>
 #include <iterator>
-#include <limits>
+#include <ranges>
 #include <span>
+#include <utility>
 #include <vector>
 
 #include <ka/common/assert.hpp>
 #include <ka/common/fixed.hpp>
+#include <ka/geometry_types/Segment2.hpp>
 #include <ka/geometry_types/Vec2.hpp>
 #include <ka/tilecut/HotPixelOrder.hpp>
 
 namespace ka
 {
 
+namespace detail
+{
+
+/// @brief Returns the index of the first value not satisfying the predicate.
+/// Unlike std::partition_point, the loop has no data-dependent branches, so the compiler emits conditional moves and
+/// the search does not suffer from branch mispredictions.
+template <std::ranges::contiguous_range R, std::predicate<std::ranges::range_value_t<R>> Predicate>
+[[nodiscard]] size_t partition_point(const R & values, Predicate predicate) noexcept
+{
+    if (std::ranges::empty(values))
+    {
+        return 0;
+    }
+    const auto * const data = std::ranges::data(values);
+    const auto * base = data;
+    for (auto size = std::ranges::size(values); size > 1;)
+    {
+        const auto half = size / 2;
+        base += predicate(base[half]) ? half : 0;
+        size -= half;
+    }
+    return static_cast<size_t>(base - data) + (predicate(*base) ? 1 : 0);
+}
+
+/// @brief Returns the index of the first value not satisfying the predicate, like partition_point.
+/// The search gallops from the hint with exponentially growing steps, so it takes O(log d) steps, where d is the
+/// distance from the hint to the result.
+template <std::ranges::contiguous_range R, std::predicate<std::ranges::range_value_t<R>> Predicate>
+[[nodiscard]] size_t gallop_partition_point(const R & values, const size_t hint, Predicate predicate) noexcept
+{
+    const auto size = std::ranges::size(values);
+    const auto * const data = std::ranges::data(values);
+    const auto start = std::min(hint, size);
+    // The result is searched in [first, last).
+    size_t first = 0;
+    size_t last = 0;
+    size_t step = 1;
+    if (start < size && predicate(data[start]))
+    {
+        while (start + step < size && predicate(data[start + step]))
+        {
+            step *= 2;
+        }
+        first = start + step / 2 + 1;
+        last = std::min(start + step, size);
+    }
+    else
+    {
+        while (step <= start && !predicate(data[start - step]))
+        {
+            step *= 2;
+        }
+        first = step <= start ? start - step + 1 : 0;
+        last = start - step / 2;
+    }
+    return first + partition_point(std::span(data + first, last - first), predicate);
+}
+
+/// @brief Positions of the last query of HotPixelIndex::Cursor.
+struct HotPixelSearchHint final
+{
+    /// @brief Index of the column where the last query stopped.
+    size_t column = 0;
+    /// @brief Index of the pixel in the last visited column where the last query stopped.
+    size_t row = 0;
+};
+
+/// @brief Calls partition_point or gallop_partition_point from the hint if it is given.
+template <std::ranges::contiguous_range R, std::predicate<std::ranges::range_value_t<R>> Predicate>
+[[nodiscard]] size_t partition_point(const R & values, const size_t * const hint, Predicate predicate) noexcept
+{
+    return hint == nullptr ? partition_point(values, predicate) : gallop_partition_point(values, *hint, predicate);
+}
+
+/// @brief Returns the range of rows within the Chebyshev distance of one from the segment in the given columns.
+/// Bounds are computed exactly using 128-bit arithmetic.
+/// @pre The columns intersect the horizontal range of the segment.
+/// @pre Differences of the cell coordinates are less than 2^63 in magnitude.
+[[nodiscard]] std::pair<s64, s64> corridor_rows(const Segment2s64 & cells, s64 first_column, s64 last_column) noexcept;
+
+} // namespace detail
+
 //! A simple data structure for querying hot pixels within a given region.
 //! Lifetime is bound to parent HotPixelCollector. The index is invalidated on HotPixelCollector modifications.
+//! Hot pixels are stored in the compressed sparse row format: sorted x coordinates of the columns, offsets of the
+//! columns and y coordinates of the pixels of all columns. So a pixel takes 8 bytes plus 12 bytes per column.
 class HotPixelIndex final
 {
     friend class HotPixelCollector;
+    friend class ParallelHotPixelCollector;
 
 public:
+    class Cursor;
+
     /// @brief Retrieves all hot_pixels within the given rectangle.
     /// Pixels are returned in the order defined by ka::hot_pixel_less<horizontal_order, vertical_order>.
     template <HotPixelOrder horizontal_order, HotPixelOrder vertical_order, std::output_iterator<Vec2s64> Out>
@@ -32,97 +121,233 @@ public:
         const s64 max_y,
         Out output,
         std::predicate<Vec2s64> auto predicate) const
+    {
+        return find_if<horizontal_order, vertical_order>(min_x, max_x, min_y, max_y, output, predicate, nullptr);
+    }
+
+    /// @brief Retrieves hot pixels that may intersect a segment with the endpoints in the given cells.
+    /// Unlike find_if over the bounding box of the segment, only the pixels within the Chebyshev distance of one cell
+    /// from the segment connecting the cell centers are checked. Every cell intersected by the original segment is
+    /// among them, so the result is the same, but the work is proportional to the length of the segment rather than
+    /// to the area of its bounding box.
+    /// Pixels are returned in the order defined by ka::hot_pixel_less<horizontal_order, vertical_order>.
+    /// @pre Differences of the cell coordinates are less than 2^63 in magnitude.
+    template <HotPixelOrder horizontal_order, HotPixelOrder vertical_order, std::output_iterator<Vec2s64> Out>
+    [[nodiscard]] Out find_if_along(const Segment2s64 & cells, Out output, std::predicate<Vec2s64> auto predicate) const
+    {
+        return find_if_along<horizontal_order, vertical_order>(cells, output, predicate, nullptr);
+    }
+
+    /// @brief Returns a cursor for a sequence of nearby queries, see Cursor.
+    [[nodiscard]] Cursor cursor() const noexcept;
+
+private:
+    template <HotPixelOrder horizontal_order, HotPixelOrder vertical_order, std::output_iterator<Vec2s64> Out>
+    [[nodiscard]] Out find_if(
+        const s64 min_x,
+        const s64 max_x,
+        const s64 min_y,
+        const s64 max_y,
+        Out output,
+        std::predicate<Vec2s64> auto predicate,
+        detail::HotPixelSearchHint * const hint) const
     {
         AR_PRE(min_x <= max_x);
 
+        for_each_column<horizontal_order>(
+            min_x,
+            max_x,
+            hint,
+            [&](const size_t column)
+            {
+                output = find_if<vertical_order>(column, min_y, max_y, output, predicate, hint);
+            });
+        return output;
+    }
+
+    template <HotPixelOrder horizontal_order, HotPixelOrder vertical_order, std::output_iterator<Vec2s64> Out>
+    [[nodiscard]] Out find_if_along(
+        const Segment2s64 & cells,
+        Out output,
+        std::predicate<Vec2s64> auto predicate,
+        detail::HotPixelSearchHint * const hint) const
+    {
+        const auto [min_x, max_x] = std::minmax(cells.a.x, cells.b.x);
+        const auto [min_y, max_y] = std::minmax(cells.a.y, cells.b.y);
+        for_each_column<horizontal_order>(
+            min_x,
+            max_x,
+            hint,
+            [&](const size_t column)
+            {
+                const auto [first_row, last_row] = detail::corridor_rows(cells, xs_[column], xs_[column]);
+                output = find_if<vertical_order>(
+                    column,
+                    std::max(first_row, min_y),
+                    std::min(last_row, max_y),
+                    output,
+                    predicate,
+                    hint);
+            });
+        return output;
+    }
+
+    /// @brief Calls the function for the indices of the columns within the range in the given order.
+    /// The hint, if given, is used to start the search and is moved to the column where the iteration stops.
+    template <HotPixelOrder horizontal_order, std::invocable<size_t> F>
+    void for_each_column(const s64 min_x, const s64 max_x, detail::HotPixelSearchHint * const hint, F && f) const
+    {
+        const auto * const column_hint = hint == nullptr ? nullptr : &hint->column;
+        size_t column = 0;
         if constexpr (horizontal_order == HotPixelOrder::Ascending)
         {
-            const auto first = std::lower_bound(
-                columns_.cbegin(),
-                columns_.cend(),
-                min_x,
-                [&](const auto & lhs, const auto & rhs_x)
+            column = detail::partition_point(
+                xs_,
+                column_hint,
+                [&](const s64 x)
                 {
-                    return lhs.x < rhs_x;
+                    return x < min_x;
                 });
-            for (auto it = first; it != columns_.cend() && it->x <= max_x; ++it)
+            for (; column < xs_.size() && xs_[column] <= max_x; ++column)
             {
-                output = it->template find_if<vertical_order>(min_y, max_y, output, predicate);
+                f(column);
             }
-            return output;
         }
         else
         {
-            const auto first = std::lower_bound(
-                columns_.crbegin(),
-                columns_.crend(),
-                max_x,
-                [&](const auto & lhs, const auto & rhs_x)
+            column = detail::partition_point(
+                xs_,
+                column_hint,
+                [&](const s64 x)
                 {
-                    return lhs.x > rhs_x;
+                    return x <= max_x;
                 });
-            for (auto it = first; it != columns_.crend() && it->x >= min_x; ++it)
+            for (; column > 0 && xs_[column - 1] >= min_x; --column)
             {
-                output = it->template find_if<vertical_order>(min_y, max_y, output, predicate);
+                f(column - 1);
             }
-            return output;
+        }
+        if (hint != nullptr)
+        {
+            hint->column = column;
         }
     }
 
-private:
-    struct Column final
+    /// @brief Retrieves hot pixels of the column within the range of rows.
+    /// The hint, if given, is used to start the search and is moved to the pixel where the iteration stops.
+    template <HotPixelOrder vertical_order, std::output_iterator<Vec2s64> Out>
+    [[nodiscard]] Out find_if(
+        const size_t column,
+        const s64 min_y,
+        const s64 max_y,
+        Out output,
+        std::predicate<Vec2s64> auto predicate,
+        detail::HotPixelSearchHint * const hint) const
     {
-        s64 x;
-        std::span<const Vec2s64> pixels;
+        AR_PRE(min_y <= max_y);
 
-        template <HotPixelOrder vertical_order, std::output_iterator<Vec2s64> Out>
-        [[nodiscard]] Out find_if(const s64 min_y, const s64 max_y, Out output, std::predicate<Vec2s64> auto predicate)
-            const
+        const auto x = xs_[column];
+        const size_t offset = offsets_[column];
+        const auto ys = std::span(ys_).subspan(offset, offsets_[column + 1] - offset);
+        // The hint points to a pixel of the previously visited column, which may be another one.
+        const auto local_row = hint == nullptr ? 0 : std::clamp(hint->row, offset, offset + ys.size()) - offset;
+        const auto * const row_hint = hint == nullptr ? nullptr : &local_row;
+        size_t i = 0;
+        if constexpr (vertical_order == HotPixelOrder::Ascending)
         {
-            AR_PRE(min_y <= max_y);
-            if constexpr (vertical_order == HotPixelOrder::Ascending)
+            i = detail::partition_point(
+                ys,
+                row_hint,
+                [&](const s64 y)
+                {
+                    return y < min_y;
+                });
+            for (; i < ys.size() && ys[i] <= max_y; ++i)
             {
-                const auto first = std::lower_bound(
-                    pixels.begin(),
-                    pixels.end(),
-                    min_y,
-                    [&](const auto & lhs, const auto & rhs_y)
-                    {
-                        return lhs.y < rhs_y;
-                    });
-                for (auto it = first; it != pixels.end() && it->y <= max_y; ++it)
+                const Vec2s64 pixel { x, ys[i] };
+                if (predicate(pixel))
                 {
-                    if (predicate(*it))
-                    {
-                        *output++ = *it;
-                    }
+                    *output++ = pixel;
                 }
             }
-            else
+        }
+        else
+        {
+            i = detail::partition_point(
+                ys,
+                row_hint,
+                [&](const s64 y)
+                {
+                    return y <= max_y;
+                });
+            for (; i > 0 && ys[i - 1] >= min_y; --i)
             {
-                const auto first = std::lower_bound(
-                    pixels.rbegin(),
-                    pixels.rend(),
-                    max_y,
-                    [&](const auto & lhs, const auto & rhs_y)
-                    {
-                        return lhs.y > rhs_y;
-                    });
-                for (auto it = first; it != pixels.rend() && it->y >= min_y; ++it)
+                const Vec2s64 pixel { x, ys[i - 1] };
+                if (predicate(pixel))
                 {
-                    if (predicate(*it))
-                    {
-                        *output++ = *it;
-                    }
+                    *output++ = pixel;
                 }
             }
-            return output;
         }
-    };
+        if (hint != nullptr)
+        {
+            hint->row = offset + i;
+        }
+        return output;
+    }
 
 private:
-    //! Contains x-ordered columns, each containing y-ordered hot pixels. Populated by HotPixelCollector.
-    std::vector<Column> columns_;
+    //! Ordered x coordinates of the columns. Populated by HotPixelCollector.
+    std::vector<s64> xs_;
+    //! Offsets of the first pixels of the columns in ys_, the last offset is ys_.size().
+    std::vector<u32> offsets_;
+    //! Ordered y coordinates of the pixels of every column.
+    std::vector<s64> ys_;
 };
 
+//! Stateful access to HotPixelIndex for a sequence of queries touching nearby pixels, e.g. along a contour.
+//! The cursor remembers the column and the pixel where the previous query stopped and finds the start of the next
+//! query by galloping search from there. So queries of consecutive segments of a contour, which share endpoints, take
+//! nearly constant time to locate instead of two binary searches over the whole index.
+//! Results are the same as of the corresponding queries of HotPixelIndex.
+//! Lifetime is bound to the index. The cursor is invalidated with the index.
+class HotPixelIndex::Cursor final
+{
+public:
+    explicit Cursor(const HotPixelIndex & index) noexcept
+        : index_(&index)
+    {
+    }
+
+public:
+    /// @brief Same as HotPixelIndex::find_if.
+    template <HotPixelOrder horizontal_order, HotPixelOrder vertical_order, std::output_iterator<Vec2s64> Out>
+    [[nodiscard]] Out find_if(
+        const s64 min_x,
+        const s64 max_x,
+        const s64 min_y,
+        const s64 max_y,
+        Out output,
+        std::predicate<Vec2s64> auto predicate)
+    {
+        return index_->find_if<horizontal_order, vertical_order>(min_x, max_x, min_y, max_y, output, predicate, &hint_);
+    }
+
+    /// @brief Same as HotPixelIndex::find_if_along.
+    template <HotPixelOrder horizontal_order, HotPixelOrder vertical_order, std::output_iterator<Vec2s64> Out>
+    [[nodiscard]] Out find_if_along(const Segment2s64 & cells, Out output, std::predicate<Vec2s64> auto predicate)
+    {
+        return index_->find_if_along<horizontal_order, vertical_order>(cells, output, predicate, &hint_);
+    }
+
+private:
+    const HotPixelIndex * index_;
+    detail::HotPixelSearchHint hint_;
+};
+
+inline HotPixelIndex::Cursor HotPixelIndex::cursor() const noexcept
+{
+    return Cursor { *this };
+}
+
 } // namespace ka
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <iterator>
+#include <optional>
+
+#include <ka/common/assert.hpp>
+#include <ka/common/fixed.hpp>
+#include <ka/exact/GridRounding.hpp>
+#include <ka/exact/IntegerGridParameters.hpp>
+#include <ka/exact/integer_grid.hpp>
+#include <ka/geometry_types/Segment2.hpp>
+#include <ka/geometry_types/Vec2.hpp>
+#include <ka/tilecut/TileGrid.hpp>
+
+namespace ka
+{
+
+/// @brief Same as TileCellGrid, but for fixed-point integer input coordinates.
+/// All computations are exact integer computations, so the input does not have to be converted to floating-point.
+template <GridRounding rounding_>
+class IntegerTileCellGrid final
+{
+public:
+    constexpr static auto rounding = rounding_;
+
+    /// @brief Checks a single line for intersection with many cells.
+    class LineCellTester final
+    {
+    public:
+        LineCellTester(const IntegerGridParameters & grid, const Segment2s64 & segment_on_line) noexcept
+            : grid_ { grid }
+            , segment_on_line_ { segment_on_line }
+        {
+        }
+
+    public:
+        /// @brief Checks the line for intersection with the cell.
+        [[nodiscard]] bool intersects(const s64 c_x, const s64 c_y) const noexcept
+        {
+            return ka::line_intersects_cell<rounding>(
+                grid_,
+                segment_on_line_.a.x,
+                segment_on_line_.a.y,
+                segment_on_line_.b.x,
+                segment_on_line_.b.y,
+                c_x,
+                c_y);
+        }
+
+    private:
+        IntegerGridParameters grid_;
+        Segment2s64 segment_on_line_;
+    };
+
+public:
+    IntegerTileCellGrid(const IntegerGridParameters & grid, const Vec2s64 & tiles_origin, const u16 tile_size) noexcept
+        : grid_ { grid }
+        , tile_grid_ { tiles_origin, tile_size }
+    {
+        AR_PRE(grid.cell_size_numerator > 0);
+        AR_PRE(grid.cell_size_denominator > 0);
+    }
+
+public:
+    /// @brief Returns the coordinates of the grid cell containing the given point.
+    [[nodiscard]] Vec2s64 cell_of(const Vec2s64 point) const noexcept
+    {
+        return {
+            .x = column_containing_position<rounding>(grid_, point.x),
+            .y = row_containing_position<rounding>(grid_, point.y),
+        };
+    }
+
+    /// @brief Finds all grid cells where the given segment intersects tile boundaries.
+    /// @param segment Original segment.
+    /// @param segment_cells Original segment snapped to grid. Used for optimization, usually this value is already
+    /// calculated by the caller.
+    /// @param out_it Output iterator to the beginning of the destination.
+    /// @return Output iterator to the end of destination.
+    template <std::output_iterator<Vec2s64> Out>
+    Out tile_boundary_intersection_cells(const Segment2s64 segment, const Segment2s64 segment_cells, Out out_it) const
+    {
+        AR_PRE(cell_of(segment.a) == segment_cells.a);
+        AR_PRE(cell_of(segment.b) == segment_cells.b);
+        return tiles().boundary_crossing_cells(
+            tiles().intersected_boundaries_ranges(segment_cells),
+            [&](const s64 x) -> std::optional<s64>
+            {
+                if (segment.a.x == segment.b.x || !border_between_coordinates(grid_, segment.a.x, segment.b.x, x))
+                {
+                    return std::nullopt;
+                }
+                return column_border_intersection<rounding>(
+                    grid_,
+                    segment.a.x,
+                    segment.a.y,
+                    segment.b.x,
+                    segment.b.y,
+                    x);
+            },
+            [&](const s64 y) -> std::optional<s64>
+            {
+                if (segment.a.y == segment.b.y || !border_between_coordinates(grid_, segment.a.y, segment.b.y, y))
+                {
+                    return std::nullopt;
+                }
+                return row_border_intersection<rounding>(
+                    grid_,
+                    segment.a.x,
+                    segment.a.y,
+                    segment.b.x,
+                    segment.b.y,
+                    y);
+            },
+            out_it);
+    }
+
+    /// @brief Checks line for intersection with the given cell.
+    /// @param segment_on_line a segment defining a line through two points.
+    /// @param cell the cell whose intersection needs to be checked.
+    /// @returns True iff the line intersects the cell.
+    [[nodiscard]] bool line_intersects_cell(const Segment2s64 & segment_on_line, const Vec2s64 & cell) const noexcept
+    {
+        return line_cell_tester(segment_on_line).intersects(cell.x, cell.y);
+    }
+
+    /// @brief Creates an object for checking the line for intersection with many cells.
+    /// @param segment_on_line a segment defining a line through two points.
+    [[nodiscard]] LineCellTester line_cell_tester(const Segment2s64 & segment_on_line) const noexcept
+    {
+        return { grid_, segment_on_line };
+    }
+
+public:
+    [[nodiscard]] const IntegerGridParameters & grid() const noexcept
+    {
+        return grid_;
+    }
+
+    [[nodiscard]] const TileGrid & tiles() const noexcept
+    {
+        return tile_grid_;
+    }
+
+private:
+    IntegerGridParameters grid_;
+    TileGrid tile_grid_;
+};
+
+} // namespace ka
@@ -7,6 +7,7 @@
 #include <vector>
 
 #include <ka/common/fixed.hpp>
+#include <ka/exact/GridParameters.hpp>
 #include <ka/exact/GridRounding.hpp>
 #include <ka/geometry_types/Vec2.hpp>
 #include <ka/tilecut/LineSnapperCoordinateHandler.hpp>
@@ -28,11 +29,12 @@ public:
     /// @param out beginning of the destination points container.
     template <
         GridRounding rounding,
+        GridParameters static_grid,
         LineSnapperCoordinateHandler H,
         std::ranges::input_range In,
         std::output_iterator<typename H::OutputVertex> Out>
         requires std::same_as<typename H::InputVertex, std::ranges::range_value_t<In>>
-    void snap_line(const TileCellGrid<rounding> & grid, const H & handler, In && line, Out out)
+    void snap_line(const TileCellGrid<rounding, static_grid> & grid, const H & handler, In && line, Out out)
     {
         static_assert(
             std::assignable_from<typename H::InputVertex &, std::ranges::range_reference_t<In>> &&
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <vector>
+
+#include <ka/common/assert.hpp>
+#include <ka/tilecut/HotPixelCollector.hpp>
+#include <ka/tilecut/HotPixelIndex.hpp>
+#include <ka/tilecut/radix_sort.hpp>
+
+namespace ka
+{
+
+/// @brief Collects hot pixels to index from several threads.
+/// Every thread fills its own shard through the usual HotPixelCollector API, then the shards are sorted and merged
+/// into a single HotPixelIndex in parallel. The index is the same as if all polylines were added to one collector.
+class ParallelHotPixelCollector final
+{
+public:
+    /// @param shard_count number of shards, it is also the number of threads used to build the index.
+    explicit ParallelHotPixelCollector(const size_t shard_count)
+        : shards_(shard_count)
+    {
+        AR_PRE(shard_count > 0);
+    }
+
+public:
+    [[nodiscard]] size_t shard_count() const noexcept
+    {
+        return shards_.size();
+    }
+
+    /// @brief Returns the collector of the shard.
+    /// Different shards may be filled concurrently, but a single shard must be used by one thread at a time.
+    /// @note The index built by the shard itself is not related to the index built by ParallelHotPixelCollector.
+    [[nodiscard]] HotPixelCollector & shard(const size_t shard) noexcept
+    {
+        AR_PRE(shard < shards_.size());
+        return shards_[shard];
+    }
+
+    /// @brief Resets all shards to their original state.
+    void reset() noexcept
+    {
+        for (auto & shard : shards_)
+        {
+            shard.reset();
+        }
+    }
+
+    /// @brief Frees the memory of the hot pixels collected by all shards, e.g. once the index is built.
+    /// The built index stays valid, since it keeps its own copy of the hot pixels.
+    void release_hot_pixels() noexcept
+    {
+        for (auto & shard : shards_)
+        {
+            shard.release_hot_pixels();
+        }
+    }
+
+    /// @brief Builds the index of hot pixels of all shards using one thread per shard.
+    /// The index is invalidated on modifications of ParallelHotPixelCollector or any of its shards
+    /// other than release_hot_pixels.
+    /// @param sort_policy algorithm used to sort hot pixels of every shard.
+    /// @pre At least one hot pixel is collected.
+    [[nodiscard]] const HotPixelIndex & build_index(SortPolicy sort_policy = SortPolicy::Comparison);
+
+private:
+    std::vector<HotPixelCollector> shards_;
+    HotPixelIndex index_;
+};
+
+} // namespace ka
@@ -2,9 +2,14 @@
 
 #include <algorithm>
 #include <iterator>
+#include <optional>
+#include <span>
+#include <type_traits>
 
 #include <ka/exact/GridParameters.hpp>
 #include <ka/exact/GridRounding.hpp>
+#include <ka/exact/LineCellTester.hpp>
+#include <ka/exact/SegmentBorderCrossings.hpp>
 #include <ka/exact/grid.hpp>
 #include <ka/geometry_types/Segment2.hpp>
 #include <ka/geometry_types/Vec2.hpp>
@@ -14,14 +19,25 @@ namespace ka
 {
 
 /// @brief A helper class that provides methods for mapping geometry to the grid cells it passes through.
-template <GridRounding rounding_>
+/// @tparam rounding_ coordinates rounding mode.
+/// @tparam static_grid_ grid parameters known at compile time, e.g. the constants generated by ka_generate_grid.
+/// By default the parameters are passed to the constructor.
+/// When the cell size of the static grid is a power of two, points are rounded without division.
+template <GridRounding rounding_, GridParameters static_grid_ = GridParameters {}>
 class TileCellGrid final
 {
 public:
     constexpr static auto rounding = rounding_;
 
+    /// @brief True if the grid parameters are known at compile time.
+    constexpr static bool has_static_grid = static_grid_.desired_cell_size > 0.0;
+
+    /// @brief True if the points are rounded by scaling them by the inverse of the cell size.
+    constexpr static bool power_of_two_cell_size = has_static_grid && has_power_of_two_cell_size(static_grid_);
+
 public:
     TileCellGrid(const GridParameters & grid, const Vec2s64 & tiles_origin, const u16 tile_size) noexcept
+        requires(!has_static_grid)
         : grid_ { grid }
         , tile_grid_ { tiles_origin, tile_size }
     {
@@ -29,14 +45,46 @@ public:
         AR_PRE(grid.cell_size >= grid.desired_cell_size);
     }
 
+    TileCellGrid(const Vec2s64 & tiles_origin, const u16 tile_size) noexcept
+        requires has_static_grid
+        : tile_grid_ { tiles_origin, tile_size }
+    {
+        static_assert(static_grid_.cell_size >= static_grid_.desired_cell_size);
+    }
+
 public:
     /// @brief Returns the coordinates of the grid cell containing the given point.
     [[nodiscard]] Vec2s64 cell_of(const Vec2f64 point) const noexcept
     {
-        return {
-            .x = column_containing_position<rounding>(grid_, point.x),
-            .y = row_containing_position<rounding>(grid_, point.y),
-        };
+        if constexpr (power_of_two_cell_size)
+        {
+            return {
+                .x = column_containing_position_power_of_two<rounding>(grid(), point.x),
+                .y = row_containing_position_power_of_two<rounding>(grid(), point.y),
+            };
+        }
+        else
+        {
+            return {
+                .x = column_containing_position<rounding>(grid(), point.x),
+                .y = row_containing_position<rounding>(grid(), point.y),
+            };
+        }
+    }
+
+    /// @brief Writes the coordinates of the grid cells containing the given points.
+    /// @param points points to round.
+    /// @param cells destination for the cells, must have the same size as points.
+    void cell_of(const std::span<const Vec2f64> points, const std::span<Vec2s64> cells) const noexcept
+    {
+        if constexpr (power_of_two_cell_size)
+        {
+            cells_containing_points_power_of_two<rounding>(grid(), points, cells);
+        }
+        else
+        {
+            cells_containing_points<rounding>(grid(), points, cells);
+        }
     }
 
     /// @brief Finds all grid cells where the given segment intersects tile boundaries.
@@ -50,47 +98,36 @@ public:
     {
         AR_PRE(cell_of(segment.a) == segment_cells.a);
         AR_PRE(cell_of(segment.b) == segment_cells.b);
-        const auto [min_x, max_x, min_y, max_y] = tiles().intersected_boundaries_ranges(segment_cells);
-
-        if (segment.a.x != segment.b.x)
+        const auto ranges = tiles().intersected_boundaries_ranges(segment_cells);
+        if (ranges.min_x > ranges.max_x && ranges.min_y > ranges.max_y)
         {
-            for (auto x = min_x; x <= max_x; x += tiles().tile_size())
+            return out_it;
+        }
+
+        // Terms depending only on the segment are computed once for all the crossed boundaries.
+        const SegmentBorderCrossings<rounding> crossings { grid(), segment.a.x, segment.a.y, segment.b.x, segment.b.y };
+
+        const auto [first_column, last_column] = crossings.column_borders();
+        const auto [first_row, last_row] = crossings.row_borders();
+        return tiles().boundary_crossing_cells(
+            ranges,
+            [&](const s64 x) -> std::optional<s64>
             {
-                if (border_between_coordinates(grid_.cell_size, segment.a.x, segment.b.x, x))
+                if (x < first_column || x > last_column)
                 {
-                    // clang-format off
-                    const auto y = column_border_intersection<rounding>(
-                        grid_,
-                        segment.a.x,
-                        segment.a.y,
-                        segment.b.x,
-                        segment.b.y,
-                        x);
-                    // clang-format on
-                    *out_it++ = { x, y };
+                    return std::nullopt;
                 }
-            }
-        }
-        if (segment.a.y != segment.b.y)
-        {
-            for (auto y = min_y; y <= max_y; y += tiles().tile_size())
+                return crossings.column_border_intersection(x);
+            },
+            [&](const s64 y) -> std::optional<s64>
             {
-                if (border_between_coordinates(grid_.cell_size, segment.a.y, segment.b.y, y))
+                if (y < first_row || y > last_row)
                 {
-                    // clang-format off
-                    const auto x = row_border_intersection<rounding>(
-                        grid_,
-                        segment.a.x,
-                        segment.a.y,
-                        segment.b.x,
-                        segment.b.y,
-                        y);
-                    // clang-format on
-                    *out_it++ = { x, y };
+                    return std::nullopt;
                 }
-            }
-        }
-        return out_it;
+                return crossings.row_border_intersection(y);
+            },
+            out_it);
     }
 
     /// @brief Checks line for intersection with the given cell.
@@ -100,7 +137,7 @@ public:
     [[nodiscard]] bool line_intersects_cell(const Segment2f64 & segment_on_line, const Vec2s64 & cell) const noexcept
     {
         return ka::line_intersects_cell<rounding>(
-            grid_,
+            grid(),
             segment_on_line.a.x,
             segment_on_line.a.y,
             segment_on_line.b.x,
@@ -109,10 +146,24 @@ public:
             cell.y);
     }
 
+    /// @brief Creates an object for checking the line for intersection with many cells.
+    /// @param segment_on_line a segment defining a line through two points.
+    [[nodiscard]] LineCellTester<rounding> line_cell_tester(const Segment2f64 & segment_on_line) const noexcept
+    {
+        return { grid(), segment_on_line.a.x, segment_on_line.a.y, segment_on_line.b.x, segment_on_line.b.y };
+    }
+
 public:
     [[nodiscard]] const GridParameters & grid() const noexcept
     {
-        return grid_;
+        if constexpr (has_static_grid)
+        {
+            return static_grid_;
+        }
+        else
+        {
+            return grid_;
+        }
     }
 
     [[nodiscard]] const TileGrid & tiles() const noexcept
@@ -122,11 +173,17 @@ public:
 
     [[nodiscard]] f64 cell_size() const noexcept
     {
-        return grid_.cell_size;
+        return grid().cell_size;
     }
 
 private:
-    GridParameters grid_;
+    /// @brief Placeholder for the grid parameters known at compile time.
+    struct StaticGrid final
+    {
+    };
+
+private:
+    [[no_unique_address]] std::conditional_t<has_static_grid, StaticGrid, GridParameters> grid_;
     TileGrid tile_grid_;
 };
 
@@ -2,7 +2,9 @@
 
 #include <algorithm>
 #include <array>
+#include <concepts>
 #include <iterator>
+#include <optional>
 #include <utility>
 
 #include <ka/common/assert.hpp>
@@ -151,6 +153,39 @@ public:
         return { min_x, max_x, min_y, max_y };
     }
 
+    /// @brief Writes the cells where a segment crosses the tile boundaries within the given ranges.
+    /// Column boundaries are visited first, then row boundaries, both in the ascending order.
+    /// @param ranges ranges of the boundaries, see intersected_boundaries_ranges.
+    /// @param column_crossing returns the row of the cell where the segment crosses the column boundary with the given
+    /// X coordinate, or std::nullopt if the segment does not cross it.
+    /// @param row_crossing same as column_crossing, but returns the column for the row boundary with the given Y.
+    template <
+        std::output_iterator<Vec2s64> Out,
+        std::invocable<s64> ColumnCrossing,
+        std::invocable<s64> RowCrossing>
+    Out boundary_crossing_cells(
+        const BoundariesRanges & ranges,
+        ColumnCrossing column_crossing,
+        RowCrossing row_crossing,
+        Out out_it) const
+    {
+        for (auto x = ranges.min_x; x <= ranges.max_x; x += tile_size_)
+        {
+            if (const std::optional<s64> y = column_crossing(x))
+            {
+                *out_it++ = { x, *y };
+            }
+        }
+        for (auto y = ranges.min_y; y <= ranges.max_y; y += tile_size_)
+        {
+            if (const std::optional<s64> x = row_crossing(y))
+            {
+                *out_it++ = { *x, y };
+            }
+        }
+        return out_it;
+    }
+
     /// @brief Returns the coordinates of the first and last tile boundaries between the given cell coordinates
     /// (inclusive, unordered).
     /// @return A pair of minimum and maximum boundary coordinates.
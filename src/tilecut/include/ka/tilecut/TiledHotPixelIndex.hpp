@@ -0,0 +1,400 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <iterator>
+#include <limits>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <ka/common/assert.hpp>
+#include <ka/common/fixed.hpp>
+#include <ka/geometry_types/Segment2.hpp>
+#include <ka/geometry_types/Vec2.hpp>
+#include <ka/tilecut/HotPixelIndex.hpp>
+#include <ka/tilecut/HotPixelOrder.hpp>
+#include <ka/tilecut/TileGrid.hpp>
+
+namespace ka
+{
+
+//! Same as HotPixelIndex, but hot pixels are grouped by tiles and stored in tile-local coordinates.
+//! Lifetime is bound to parent HotPixelCollector. The index is invalidated on HotPixelCollector modifications.
+//! Every tile is stored in the compressed sparse row format with 16-bit local coordinates, so a pixel takes 2 bytes
+//! plus 6 bytes per column of a tile. A query finds the few tiles it touches and then searches only their small
+//! arrays, which mostly stay in cache.
+class TiledHotPixelIndex final
+{
+    friend class HotPixelCollector;
+
+public:
+    TiledHotPixelIndex() noexcept
+        : tile_grid_ { {}, 1 }
+    {
+    }
+
+public:
+    /// @brief Returns the tile grid used to group hot pixels.
+    [[nodiscard]] const TileGrid & tiles() const noexcept
+    {
+        return tile_grid_;
+    }
+
+    /// @brief Retrieves all hot_pixels within the given rectangle.
+    /// Pixels are returned in the order defined by ka::hot_pixel_less<horizontal_order, vertical_order>.
+    template <HotPixelOrder horizontal_order, HotPixelOrder vertical_order, std::output_iterator<Vec2s64> Out>
+    [[nodiscard]] Out find_if(
+        const s64 min_x,
+        const s64 max_x,
+        const s64 min_y,
+        const s64 max_y,
+        Out output,
+        std::predicate<Vec2s64> auto predicate) const
+    {
+        AR_PRE(min_x <= max_x);
+        AR_PRE(min_y <= max_y);
+
+        const Rectangle rectangle { min_x, max_x, min_y, max_y };
+        const auto rows = [&](s64, s64)
+        {
+            return std::pair { min_y, max_y };
+        };
+        return find_if<horizontal_order, vertical_order>(rectangle, rows, output, predicate);
+    }
+
+    /// @brief Retrieves hot pixels that may intersect a segment with the endpoints in the given cells.
+    /// See HotPixelIndex::find_if_along.
+    template <HotPixelOrder horizontal_order, HotPixelOrder vertical_order, std::output_iterator<Vec2s64> Out>
+    [[nodiscard]] Out find_if_along(const Segment2s64 & cells, Out output, std::predicate<Vec2s64> auto predicate) const
+    {
+        const auto [min_x, max_x] = std::minmax(cells.a.x, cells.b.x);
+        const auto [min_y, max_y] = std::minmax(cells.a.y, cells.b.y);
+        const Rectangle rectangle { min_x, max_x, min_y, max_y };
+        const auto rows = [&](const s64 first_column, const s64 last_column)
+        {
+            return detail::corridor_rows(cells, first_column, last_column);
+        };
+        return find_if<horizontal_order, vertical_order>(rectangle, rows, output, predicate);
+    }
+
+private:
+    struct Rectangle final
+    {
+        s64 min_x;
+        s64 max_x;
+        s64 min_y;
+        s64 max_y;
+    };
+
+    /// @brief Searches the pixels of the rectangle lying in the rows returned by the function for a range of columns.
+    template <
+        HotPixelOrder horizontal_order,
+        HotPixelOrder vertical_order,
+        typename Rows,
+        std::output_iterator<Vec2s64> Out>
+    [[nodiscard]] Out find_if(
+        const Rectangle & rectangle,
+        const Rows & rows,
+        Out output,
+        std::predicate<Vec2s64> auto predicate) const
+    {
+        const auto first_tile_x = tile_grid_.tile_of(Vec2s64 { rectangle.min_x, 0 }).x;
+        const auto last_tile_x = tile_grid_.tile_of(Vec2s64 { rectangle.max_x, 0 }).x;
+        if constexpr (horizontal_order == HotPixelOrder::Ascending)
+        {
+            auto first = detail::partition_point(
+                tiles_,
+                [&](const Vec2s64 & tile)
+                {
+                    return tile.x < first_tile_x;
+                });
+            while (first < tiles_.size() && tiles_[first].x <= last_tile_x)
+            {
+                const auto tile_x = tiles_[first].x;
+                const auto last = first + detail::partition_point(
+                                              std::span(tiles_).subspan(first),
+                                              [&](const Vec2s64 & tile)
+                                              {
+                                                  return tile.x <= tile_x;
+                                              });
+                output = find_in_tile_column<horizontal_order, vertical_order>(
+                    first,
+                    last,
+                    rectangle,
+                    rows,
+                    output,
+                    predicate);
+                first = last;
+            }
+        }
+        else
+        {
+            auto last = detail::partition_point(
+                tiles_,
+                [&](const Vec2s64 & tile)
+                {
+                    return tile.x <= last_tile_x;
+                });
+            while (last > 0 && tiles_[last - 1].x >= first_tile_x)
+            {
+                const auto tile_x = tiles_[last - 1].x;
+                const auto first = detail::partition_point(
+                    std::span(tiles_).first(last),
+                    [&](const Vec2s64 & tile)
+                    {
+                        return tile.x < tile_x;
+                    });
+                output = find_in_tile_column<horizontal_order, vertical_order>(
+                    first,
+                    last,
+                    rectangle,
+                    rows,
+                    output,
+                    predicate);
+                last = first;
+            }
+        }
+        return output;
+    }
+
+    /// @brief Searches the tiles of the same column with indices from first to last.
+    /// Pixel columns of all tiles are merged, so the pixels are returned in the required order.
+    template <
+        HotPixelOrder horizontal_order,
+        HotPixelOrder vertical_order,
+        typename Rows,
+        std::output_iterator<Vec2s64> Out>
+    [[nodiscard]] Out find_in_tile_column(
+        size_t first,
+        size_t last,
+        const Rectangle & rectangle,
+        const Rows & rows,
+        Out output,
+        std::predicate<Vec2s64> auto predicate) const
+    {
+        const s64 tile_size = tile_grid_.tile_size();
+        const auto origin_x = tile_grid_.tile_origin(tiles_[first]).x;
+        const auto first_x = std::max(rectangle.min_x, origin_x);
+        const auto last_x = std::min(rectangle.max_x, origin_x + tile_size - 1);
+        AR_ASSERT(first_x <= last_x);
+
+        // Only tiles crossed by the rows of the query within the tile column are searched.
+        const auto [first_row, last_row] = clamp_rows(rows(first_x, last_x), rectangle);
+        if (first_row > last_row)
+        {
+            return output;
+        }
+        const auto first_tile_y = tile_grid_.tile_of(Vec2s64 { 0, first_row }).y;
+        const auto last_tile_y = tile_grid_.tile_of(Vec2s64 { 0, last_row }).y;
+        const auto group = std::span(tiles_).subspan(first, last - first);
+        last = first + detail::partition_point(
+                           group,
+                           [&](const Vec2s64 & tile)
+                           {
+                               return tile.y <= last_tile_y;
+                           });
+        first += detail::partition_point(
+            group,
+            [&](const Vec2s64 & tile)
+            {
+                return tile.y < first_tile_y;
+            });
+
+        const auto first_local_x = static_cast<u16>(first_x - origin_x);
+        const auto last_local_x = static_cast<u16>(last_x - origin_x);
+        if constexpr (horizontal_order == HotPixelOrder::Ascending)
+        {
+            // The next column is the leftmost column of all tiles following the previous one.
+            for (s64 next = first_local_x; next <= last_local_x;)
+            {
+                s64 column_x = std::numeric_limits<s64>::max();
+                for (auto tile = first; tile < last; ++tile)
+                {
+                    const auto xs = column_xs(tile);
+                    const auto i = detail::partition_point(
+                        xs,
+                        [&](const u16 x)
+                        {
+                            return x < next;
+                        });
+                    if (i < xs.size())
+                    {
+                        column_x = std::min<s64>(column_x, xs[i]);
+                    }
+                }
+                if (column_x > last_local_x)
+                {
+                    break;
+                }
+                output = find_in_column<vertical_order>(
+                    first,
+                    last,
+                    static_cast<u16>(column_x),
+                    rectangle,
+                    rows,
+                    output,
+                    predicate);
+                next = column_x + 1;
+            }
+        }
+        else
+        {
+            // The next column is the rightmost column of all tiles preceding the previous one.
+            for (s64 next = last_local_x; next >= first_local_x;)
+            {
+                s64 column_x = -1;
+                for (auto tile = first; tile < last; ++tile)
+                {
+                    const auto xs = column_xs(tile);
+                    const auto i = detail::partition_point(
+                        xs,
+                        [&](const u16 x)
+                        {
+                            return x <= next;
+                        });
+                    if (i > 0)
+                    {
+                        column_x = std::max<s64>(column_x, xs[i - 1]);
+                    }
+                }
+                if (column_x < first_local_x)
+                {
+                    break;
+                }
+                output = find_in_column<vertical_order>(
+                    first,
+                    last,
+                    static_cast<u16>(column_x),
+                    rectangle,
+                    rows,
+                    output,
+                    predicate);
+                next = column_x - 1;
+            }
+        }
+        return output;
+    }
+
+    /// @brief Searches the pixel column with the given local x in the tiles with indices from first to last.
+    template <HotPixelOrder vertical_order, typename Rows, std::output_iterator<Vec2s64> Out>
+    [[nodiscard]] Out find_in_column(
+        const size_t first,
+        const size_t last,
+        const u16 local_x,
+        const Rectangle & rectangle,
+        const Rows & rows,
+        Out output,
+        std::predicate<Vec2s64> auto predicate) const
+    {
+        const auto x = tile_grid_.tile_origin(tiles_[first]).x + local_x;
+        const auto [first_row, last_row] = clamp_rows(rows(x, x), rectangle);
+        if (first_row > last_row)
+        {
+            return output;
+        }
+
+        const auto search_tile = [&](const size_t tile)
+        {
+            const s64 origin_y = tile_grid_.tile_origin(tiles_[tile]).y;
+            const auto first_local_y = std::max<s64>(first_row - origin_y, 0);
+            const auto last_local_y = std::min<s64>(last_row - origin_y, tile_grid_.tile_size() - 1);
+            if (first_local_y > last_local_y)
+            {
+                return;
+            }
+
+            const auto xs = column_xs(tile);
+            const auto i = detail::partition_point(
+                xs,
+                [&](const u16 column_x)
+                {
+                    return column_x < local_x;
+                });
+            if (i == xs.size() || xs[i] != local_x)
+            {
+                return;
+            }
+            const auto column = tile_columns_[tile] + i;
+            const auto first_pixel = column_rows_[column];
+            const auto ys = std::span(ys_).subspan(first_pixel, column_rows_[column + 1] - first_pixel);
+            if constexpr (vertical_order == HotPixelOrder::Ascending)
+            {
+                const auto first_y = detail::partition_point(
+                    ys,
+                    [&](const u16 y)
+                    {
+                        return y < first_local_y;
+                    });
+                for (auto j = first_y; j < ys.size() && ys[j] <= last_local_y; ++j)
+                {
+                    const Vec2s64 pixel { x, origin_y + ys[j] };
+                    if (predicate(pixel))
+                    {
+                        *output++ = pixel;
+                    }
+                }
+            }
+            else
+            {
+                const auto last_y = detail::partition_point(
+                    ys,
+                    [&](const u16 y)
+                    {
+                        return y <= last_local_y;
+                    });
+                for (auto j = last_y; j > 0 && ys[j - 1] >= first_local_y; --j)
+                {
+                    const Vec2s64 pixel { x, origin_y + ys[j - 1] };
+                    if (predicate(pixel))
+                    {
+                        *output++ = pixel;
+                    }
+                }
+            }
+        };
+
+        if constexpr (vertical_order == HotPixelOrder::Ascending)
+        {
+            for (auto tile = first; tile < last; ++tile)
+            {
+                search_tile(tile);
+            }
+        }
+        else
+        {
+            for (auto tile = last; tile > first; --tile)
+            {
+                search_tile(tile - 1);
+            }
+        }
+        return output;
+    }
+
+    [[nodiscard]] static std::pair<s64, s64> clamp_rows(const std::pair<s64, s64> & rows, const Rectangle & rectangle)
+        noexcept
+    {
+        return { std::max(rows.first, rectangle.min_y), std::min(rows.second, rectangle.max_y) };
+    }
+
+    /// @brief Returns the ordered local x coordinates of the pixel columns of the tile.
+    [[nodiscard]] std::span<const u16> column_xs(const size_t tile) const noexcept
+    {
+        return std::span(column_xs_).subspan(tile_columns_[tile], tile_columns_[tile + 1] - tile_columns_[tile]);
+    }
+
+private:
+    TileGrid tile_grid_;
+    //! Ordered coordinates of the tiles containing hot pixels. Populated by HotPixelCollector.
+    std::vector<Vec2s64> tiles_;
+    //! Offsets of the first pixel columns of the tiles in column_xs_, the last offset is column_xs_.size().
+    std::vector<u32> tile_columns_;
+    //! Ordered local x coordinates of the pixel columns of every tile.
+    std::vector<u16> column_xs_;
+    //! Offsets of the first pixels of the columns in ys_, the last offset is ys_.size().
+    std::vector<u32> column_rows_;
+    //! Ordered local y coordinates of the pixels of every column.
+    std::vector<u16> ys_;
+};
+
+} // namespace ka
@@ -5,24 +5,46 @@
 
 #include <ka/geometry_types/Segment2.hpp>
 #include <ka/geometry_types/Vec2.hpp>
+#include <ka/geometry_types/space_filling_curve.hpp>
+#include <ka/tilecut/CompactSegments.hpp>
 #include <ka/tilecut/TileGrid.hpp>
+#include <ka/tilecut/radix_sort.hpp>
 
 namespace ka
 {
 
+/// @brief Order of tiles returned by collect_tiles.
+enum class TileOrder
+{
+    /// @brief Tiles are sorted by x, then by y.
+    Coordinates,
+    /// @brief Tiles are sorted along the Z-order curve.
+    Morton,
+    /// @brief Tiles are sorted along the Hilbert curve, so neighbouring tiles are mostly close in the output.
+    Hilbert,
+};
+
 struct Tile final
 {
     Vec2s64 tile;
     std::span<const Segment2u16> segments;
 };
 
+struct CompactTile final
+{
+    Vec2s64 tile;
+    CompactSegments segments;
+};
+
 /// @brief Groups segments by tile coordinates and abtains the sorted list of tile coordinates.
 /// @note Vector unique_segments is modified by grouping segments by tile coordinates.
 /// @param tile_grid tile grid.
 /// @param unique_segments unique segments of multipolygon.
 /// @param tile_segments container for segments in tile coordinates. Subranges of `tile_segments` are referenced by
 /// items of `tiles` container.
-/// @param tiles container for found tiles. Tiles are sorted by coordinates.
+/// @param tiles container for found tiles. Tiles are sorted in the given order.
+/// @param order order of tiles. Segments in `tile_segments` are stored in the same order.
+/// @param sort_policy algorithm used to sort segments by tiles when tiles are ordered by coordinates.
 /// @note Segments that lie entirely on the boundary of a tile are considered to belong to the tile that is in the left
 /// half-plane relative to that segment.
 /// Thanks to this property, a tile will never contain a 2D part of a polygon.
@@ -31,6 +53,19 @@ void collect_tiles(
     const TileGrid & tile_grid,
     std::vector<Segment2s64> & unique_segments,
     std::vector<Segment2u16> & tile_segments,
-    std::vector<Tile> & tiles) noexcept;
+    std::vector<Tile> & tiles,
+    TileOrder order = TileOrder::Coordinates,
+    SortPolicy sort_policy = SortPolicy::Comparison) noexcept;
+
+/// @brief Same as collect_tiles, but stores segments in the compact form, see CompactSegments.hpp.
+/// Segments of every tile are encoded starting from the tile origin, so tiles can be decoded independently.
+/// @param tile_bytes storage for encoded segments. Subranges of `tile_bytes` are referenced by items of `tiles`.
+void collect_tiles(
+    const TileGrid & tile_grid,
+    std::vector<Segment2s64> & unique_segments,
+    std::vector<u8> & tile_bytes,
+    std::vector<CompactTile> & tiles,
+    TileOrder order = TileOrder::Coordinates,
+    SortPolicy sort_policy = SortPolicy::Comparison) noexcept;
 
 } // namespace ka
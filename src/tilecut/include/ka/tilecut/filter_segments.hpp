@@ -2,12 +2,41 @@
 
 #include <vector>
 
+#include <ka/common/fixed.hpp>
 #include <ka/geometry_types/Segment2.hpp>
+#include <ka/tilecut/radix_sort.hpp>
 
 namespace ka
 {
 
 /// @brief Removes all repeated and zero length segments.
-void filter_segments(std::vector<Segment2s64> & segments) noexcept;
+/// Opposite segments cancel each other out.
+/// @note The remaining segments are sorted by their undirected representation.
+/// @param sort_policy algorithm used to sort segments.
+void filter_segments(std::vector<Segment2s64> & segments, SortPolicy sort_policy = SortPolicy::Comparison) noexcept;
+
+/// @brief Same as filter_segments, but counts segments in a hash table instead of sorting them,
+/// so it takes expected linear time.
+/// The table is kept between calls, so the filter should be reused to avoid allocations.
+class HashSegmentFilter final
+{
+public:
+    /// @brief Removes all repeated and zero length segments like filter_segments.
+    /// @note The remaining segments are not sorted, they keep the order of the first occurrences in the input.
+    /// @pre segments.size() < 2^31.
+    void filter(std::vector<Segment2s64> & segments) noexcept;
+
+private:
+    struct Slot final
+    {
+        /// @brief Index of the first occurrence of the segment in the input, or empty_slot.
+        u32 first;
+        /// @brief Number of segments oriented like the undirected representation minus the number of opposite ones.
+        s32 balance;
+    };
+
+private:
+    std::vector<Slot> slots_;
+};
 
 } // namespace ka
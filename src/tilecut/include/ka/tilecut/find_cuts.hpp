@@ -4,6 +4,7 @@
 #include <vector>
 
 #include <ka/geometry_types/Segment2.hpp>
+#include <ka/tilecut/CompactSegments.hpp>
 #include <ka/tilecut/TileGrid.hpp>
 
 namespace ka
@@ -18,6 +19,12 @@ void find_cuts(
     std::span<const Segment2u16> segments,
     std::vector<Segment2u16> & result) noexcept;
 
+/// @brief Same as find_cuts, but decodes the segments stored in the compact form on the fly.
+void find_cuts(
+    const TileGrid & tile_grid,
+    const CompactSegments & segments,
+    std::vector<Segment2u16> & result) noexcept;
+
 /// @brief Checks that the interior of the tile below the current tile contains some points of the same multipolygon.
 /// One can use this info to find tiles completely covered by the multipolygon.
 /// @param cut_segments tile border parts that belongs to the interior of a multipolygon.
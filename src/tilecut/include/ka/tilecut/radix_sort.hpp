@@ -0,0 +1,144 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <ka/common/assert.hpp>
+#include <ka/common/fixed.hpp>
+#include <ka/geometry_types/Vec2.hpp>
+
+namespace ka
+{
+
+/// @brief Algorithm used to sort large arrays of records with integer keys.
+/// Comparison is the default everywhere, Radix is opt-in.
+enum class SortPolicy
+{
+    /// @brief std::ranges::sort, it takes no additional memory.
+    Comparison,
+    /// @brief radix_sort, it takes a buffer of the size of the array and up to one pass per key byte.
+    /// It may pay off on large arrays with narrow keys, measure before choosing it.
+    Radix,
+};
+
+/// @brief Sort key consisting of several signed words compared lexicographically.
+template <size_t size>
+using RadixKey = std::array<s64, size>;
+
+namespace detail
+{
+
+template <typename Key>
+struct RadixKeySize;
+
+template <size_t size>
+struct RadixKeySize<RadixKey<size>> final
+{
+    static constexpr size_t value = size;
+};
+
+/// @brief Returns the byte of the word, the sign bit is flipped, so unsigned order of bytes matches signed order.
+[[nodiscard]] constexpr u8 radix_byte(const s64 word, const size_t byte) noexcept
+{
+    return static_cast<u8>((static_cast<u64>(word) ^ (u64 { 1 } << 63)) >> (8 * byte));
+}
+
+} // namespace detail
+
+/// @brief Sorts values by the keys in the ascending lexicographic order of the key words.
+/// The least significant digit radix sort takes one pass per byte of the key and a buffer of the size of the array.
+/// Passes for bytes that are equal in all keys are skipped, e.g. the high bytes of small coordinates.
+/// The sort is stable. The key is evaluated once to compute the histograms and once per performed pass.
+template <typename T, std::invocable<const T &> KeyFn>
+    requires std::movable<T> && std::default_initializable<T>
+void radix_sort(std::vector<T> & values, KeyFn key)
+{
+    using Key = std::remove_cvref_t<std::invoke_result_t<KeyFn &, const T &>>;
+    constexpr size_t word_count = detail::RadixKeySize<Key>::value;
+    constexpr size_t byte_count = word_count * sizeof(s64);
+
+    const auto size = values.size();
+    if (size < 2)
+    {
+        return;
+    }
+
+    // Digits are numbered from the least significant one, i.e. the lowest byte of the last word.
+    std::vector<std::array<size_t, 256>> histograms(byte_count);
+    for (const auto & value : values)
+    {
+        const Key words = std::invoke(key, value);
+        for (size_t word = 0; word < word_count; ++word)
+        {
+            for (size_t byte = 0; byte < sizeof(s64); ++byte)
+            {
+                ++histograms[(word_count - 1 - word) * sizeof(s64) + byte][detail::radix_byte(words[word], byte)];
+            }
+        }
+    }
+
+    std::vector<T> buffer(size);
+    auto * from = values.data();
+    auto * to = buffer.data();
+    for (size_t digit = 0; digit < byte_count; ++digit)
+    {
+        const auto word = word_count - 1 - digit / sizeof(s64);
+        const auto byte = digit % sizeof(s64);
+        auto & offsets = histograms[digit];
+        if (offsets[detail::radix_byte(std::invoke(key, *from)[word], byte)] == size)
+        {
+            continue;
+        }
+
+        size_t offset = 0;
+        for (auto & count : offsets)
+        {
+            offset += std::exchange(count, offset);
+        }
+        for (size_t i = 0; i < size; ++i)
+        {
+            to[offsets[detail::radix_byte(std::invoke(key, from[i])[word], byte)]++] = std::move(from[i]);
+        }
+        std::swap(from, to);
+    }
+    if (from != values.data())
+    {
+        std::ranges::move(buffer, values.begin());
+    }
+}
+
+/// @brief Returns the key ordering points lexicographically, like the default comparison of Vec2s64.
+[[nodiscard]] constexpr RadixKey<2> radix_key(const Vec2s64 & point) noexcept
+{
+    return { point.x, point.y };
+}
+
+/// @brief Sorts points lexicographically, like std::ranges::sort with the default comparison.
+inline void radix_sort(std::vector<Vec2s64> & points)
+{
+    radix_sort(points, radix_key);
+}
+
+/// @brief Sorts values by the keys using the given algorithm.
+/// Both algorithms give the same order of values with different keys.
+template <typename T, std::invocable<const T &> KeyFn>
+void sort_by_key(std::vector<T> & values, KeyFn key, const SortPolicy policy)
+{
+    switch (policy)
+    {
+    case SortPolicy::Comparison:
+        std::ranges::sort(values, {}, key);
+        return;
+    case SortPolicy::Radix:
+        radix_sort(values, key);
+        return;
+    }
+    AR_UNREACHABLE;
+}
+
+} // namespace ka
@@ -1,21 +1,52 @@
 #pragma once
 
+#include <concepts>
 #include <ranges>
+#include <utility>
 
+#include <ka/exact/GridParameters.hpp>
 #include <ka/exact/GridRounding.hpp>
 #include <ka/exact/grid.hpp>
+#include <ka/geometry_types/Segment2.hpp>
 #include <ka/geometry_types/Vec2.hpp>
 #include <ka/tilecut/HotPixelIndex.hpp>
+#include <ka/tilecut/IntegerTileCellGrid.hpp>
 #include <ka/tilecut/TileCellGrid.hpp>
+#include <ka/tilecut/TiledHotPixelIndex.hpp>
 
 namespace ka
 {
 
-//! Performs countour snap rounding using specified hot pixels.
-template <GridRounding rounding, std::ranges::input_range In, std::output_iterator<Vec2s64> Out>
-Out snap_round(const TileCellGrid<rounding> & grid, const HotPixelIndex & hot_pixels, In && line, Out output)
+namespace detail
+{
+
+/// @brief Indices of hot pixels supported by snap_round.
+template <typename Index>
+concept SnapRoundIndex = std::same_as<Index, HotPixelIndex> || std::same_as<Index, TiledHotPixelIndex>;
+
+/// @brief HotPixelIndex is queried through a cursor, since consecutive segments of a line touch nearly the same
+/// columns.
+[[nodiscard]] inline HotPixelIndex::Cursor query_cursor(const HotPixelIndex & index) noexcept
+{
+    return index.cursor();
+}
+
+/// @brief TiledHotPixelIndex is queried directly.
+[[nodiscard]] inline const TiledHotPixelIndex & query_cursor(const TiledHotPixelIndex & index) noexcept
+{
+    return index;
+}
+
+template <
+    typename Vertex,
+    typename Grid,
+    SnapRoundIndex Index,
+    std::ranges::input_range In,
+    std::output_iterator<Vec2s64> Out>
+Out snap_round(const Grid & grid, const Index & hot_pixels, In && line, Out output)
 {
-    Vec2f64 prev_vertex;
+    auto && cursor = query_cursor(hot_pixels);
+    Vertex prev_vertex {};
     Vec2s64 prev_pixel;
 
     bool first = true;
@@ -31,6 +62,7 @@ Out snap_round(const TileCellGrid<rounding> & grid, const HotPixelIndex & hot_pi
             continue;
         }
 
+        const auto line_cell_tester = grid.line_cell_tester({ prev_vertex, vertex });
         const auto predicate = [&](const auto & hot_pixel)
         {
             AR_PRE(std::min(prev_pixel.x, pixel.x) <= hot_pixel.x);
@@ -43,19 +75,20 @@ Out snap_round(const TileCellGrid<rounding> & grid, const HotPixelIndex & hot_pi
                 // Endpoints are added explicitly to reduce the amount of pixel repetitions.
                 return false;
             }
-            return grid.line_intersects_cell({ prev_vertex, vertex }, hot_pixel);
+            return line_cell_tester.intersects(hot_pixel.x, hot_pixel.y);
         };
+        const Segment2s64 cells { prev_pixel, pixel };
         const bool horizontal_ascending = prev_pixel.x <= pixel.x;
         const bool vertical_ascending = prev_pixel.y <= pixel.y;
         // clang-format off
         using enum HotPixelOrder;
         output = horizontal_ascending
             ? vertical_ascending
-                ? hot_pixels.find_if<Ascending, Ascending>(prev_pixel.x, pixel.x, prev_pixel.y, pixel.y, output, predicate)
-                : hot_pixels.find_if<Ascending, Descending>(prev_pixel.x, pixel.x, pixel.y, prev_pixel.y, output, predicate)
+                ? cursor.template find_if_along<Ascending, Ascending>(cells, output, predicate)
+                : cursor.template find_if_along<Ascending, Descending>(cells, output, predicate)
             : vertical_ascending
-                ? hot_pixels.find_if<Descending, Ascending>(pixel.x, prev_pixel.x, prev_pixel.y, pixel.y, output, predicate)
-                : hot_pixels.find_if<Descending, Descending>(pixel.x, prev_pixel.x, pixel.y, prev_pixel.y, output, predicate);
+                ? cursor.template find_if_along<Descending, Ascending>(cells, output, predicate)
+                : cursor.template find_if_along<Descending, Descending>(cells, output, predicate);
         // clang-format on
         *output++ = pixel;
         prev_vertex = vertex;
@@ -64,4 +97,30 @@ Out snap_round(const TileCellGrid<rounding> & grid, const HotPixelIndex & hot_pi
     return output;
 }
 
+} // namespace detail
+
+//! Performs countour snap rounding using specified hot pixels.
+//! Hot pixels are given by HotPixelIndex or by TiledHotPixelIndex built for the tiles of the grid.
+template <
+    GridRounding rounding,
+    GridParameters static_grid,
+    detail::SnapRoundIndex Index,
+    std::ranges::input_range In,
+    std::output_iterator<Vec2s64> Out>
+Out snap_round(const TileCellGrid<rounding, static_grid> & grid, const Index & hot_pixels, In && line, Out output)
+{
+    return detail::snap_round<Vec2f64>(grid, hot_pixels, std::forward<In>(line), output);
+}
+
+//! Performs countour snap rounding of the line with fixed-point integer coordinates using specified hot pixels.
+template <
+    GridRounding rounding,
+    detail::SnapRoundIndex Index,
+    std::ranges::input_range In,
+    std::output_iterator<Vec2s64> Out>
+Out snap_round(const IntegerTileCellGrid<rounding> & grid, const Index & hot_pixels, In && line, Out output)
+{
+    return detail::snap_round<Vec2s64>(grid, hot_pixels, std::forward<In>(line), output);
+}
+
 } // namespace ka
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <ranges>
+#include <utility>
+
+#include <ka/geometry_types/Vec2.hpp>
+#include <ka/geometry_types/space_filling_curve.hpp>
+
+namespace ka
+{
+
+/// @brief Returns the tile containing the center of the bounding box of the feature cells.
+/// @param grid TileCellGrid or IntegerTileCellGrid.
+/// @param feature vertices of the feature. The tile of an empty feature is the tile with zero coordinates.
+template <typename Grid, std::ranges::input_range In>
+[[nodiscard]] Vec2s64 feature_tile(const Grid & grid, In && feature) noexcept
+{
+    auto it = std::ranges::begin(feature);
+    const auto end = std::ranges::end(feature);
+    if (it == end)
+    {
+        return {};
+    }
+
+    auto min = grid.cell_of(*it);
+    auto max = min;
+    for (++it; it != end; ++it)
+    {
+        const Vec2s64 cell = grid.cell_of(*it);
+        min = { std::min(min.x, cell.x), std::min(min.y, cell.y) };
+        max = { std::max(max.x, cell.x), std::max(max.y, cell.y) };
+    }
+    return grid.tiles().tile_of(Vec2s64 { std::midpoint(min.x, max.x), std::midpoint(min.y, max.y) });
+}
+
+/// @brief Reorders features along the space-filling curve by the tiles of their bounding boxes.
+/// Features lying close to each other are processed one after another, so the hot pixel lookups and the produced
+/// tiles stay in cache.
+/// @param grid TileCellGrid or IntegerTileCellGrid.
+/// @param features range of features to reorder.
+/// @param proj returns the vertices of the feature, e.g. the ring of a MultiPolygon2 by its index.
+template <typename Grid, std::ranges::random_access_range R, typename Proj = std::identity>
+void sort_features_along_curve(const Grid & grid, R && features, const SpaceFillingCurve curve, Proj proj = {})
+{
+    sort_along_curve(
+        std::forward<R>(features),
+        curve,
+        [&](const auto & feature)
+        {
+            return feature_tile(grid, std::invoke(proj, feature));
+        });
+}
+
+} // namespace ka
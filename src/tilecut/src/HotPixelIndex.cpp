@@ -0,0 +1,70 @@
+#include <algorithm>
+#include <utility>
+
+#include <ka/common/assert.hpp>
+#include <ka/common/fixed.hpp>
+#include <ka/tilecut/HotPixelIndex.hpp>
+
+namespace ka
+{
+
+inline namespace
+{
+
+/// Differences of the cell coordinates are required to be less than 2^63, so their products are less than 2^126 and
+/// 128-bit arithmetic is exact.
+using s128 = __int128;
+
+constexpr s128 g_max_difference = s128 { 1 } << 63;
+
+/// @brief Rounds the quotient towards negative infinity.
+/// @pre The denominator is positive.
+[[nodiscard]] constexpr s128 floor_div(const s128 numerator, const s128 denominator) noexcept
+{
+    AR_PRE(denominator > 0);
+    const auto quotient = numerator / denominator;
+    return numerator % denominator < 0 ? quotient - 1 : quotient;
+}
+
+/// @brief Rounds the quotient towards positive infinity.
+/// @pre The denominator is positive.
+[[nodiscard]] constexpr s128 ceil_div(const s128 numerator, const s128 denominator) noexcept
+{
+    AR_PRE(denominator > 0);
+    const auto quotient = numerator / denominator;
+    return numerator % denominator > 0 ? quotient + 1 : quotient;
+}
+
+} // namespace
+
+namespace detail
+{
+
+std::pair<s64, s64> corridor_rows(const Segment2s64 & cells, const s64 first_column, const s64 last_column) noexcept
+{
+    const auto & [a, b] = cells.a.x <= cells.b.x ? cells : Segment2s64 { cells.b, cells.a };
+    AR_PRE(first_column <= last_column);
+    AR_PRE(first_column <= b.x && a.x <= last_column);
+
+    if (a.x == b.x)
+    {
+        return { std::min(a.y, b.y) - 1, std::max(a.y, b.y) + 1 };
+    }
+
+    // The segment is monotone, so its rows within the columns first_column - 1 .. last_column + 1 are bounded by its
+    // points at the ends of this range.
+    const s128 dx = s128 { b.x } - a.x;
+    const s128 dy = s128 { b.y } - a.y;
+    AR_PRE(dx < g_max_difference);
+    AR_PRE(-g_max_difference < dy && dy < g_max_difference);
+    const s128 first_x = std::max(s128 { a.x }, s128 { first_column } - 1) - a.x;
+    const s128 last_x = std::min(s128 { b.x }, s128 { last_column } + 1) - a.x;
+    const auto [low_x, high_x] = dy >= 0 ? std::pair { first_x, last_x } : std::pair { last_x, first_x };
+    const auto first_row = a.y + ceil_div(low_x * dy, dx) - 1;
+    const auto last_row = a.y + floor_div(high_x * dy, dx) + 1;
+    return { static_cast<s64>(first_row), static_cast<s64>(last_row) };
+}
+
+} // namespace detail
+
+} // namespace ka
@@ -0,0 +1,236 @@
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <thread>
+#include <vector>
+
+#include <ka/common/assert.hpp>
+#include <ka/common/fixed.hpp>
+#include <ka/geometry_types/Vec2.hpp>
+#include <ka/tilecut/ParallelHotPixelCollector.hpp>
+#include <ka/tilecut/radix_sort.hpp>
+
+namespace ka
+{
+
+inline namespace
+{
+
+/// @brief Calls the function for every index from 0 to count - 1, each call runs on its own thread.
+template <std::invocable<size_t> F>
+void run_parallel(const size_t count, const F & f)
+{
+    std::vector<std::jthread> threads;
+    threads.reserve(count);
+    for (size_t i = 1; i < count; ++i)
+    {
+        threads.emplace_back(std::cref(f), i);
+    }
+    f(0);
+}
+
+/// @brief Sorted range of unique hot pixels of a shard.
+struct Cursor final
+{
+    const Vec2s64 * position;
+    const Vec2s64 * end;
+};
+
+/// @brief Numbers of unique hot pixels and columns of all shards within a range of x coordinates.
+struct PartSize final
+{
+    size_t pixel_count = 0;
+    size_t column_count = 0;
+};
+
+/// @brief Chooses the x coordinates splitting the pixels of all shards into parts of nearly the same size.
+/// Whole columns belong to a single part, so the parts can be indexed independently.
+[[nodiscard]] std::vector<s64> choose_splitters(
+    const std::vector<const std::vector<Vec2s64> *> & shards,
+    const size_t part_count)
+{
+    std::vector<s64> samples;
+    samples.reserve(shards.size() * part_count);
+    for (const auto * pixels : shards)
+    {
+        for (size_t i = 0; i < part_count && !pixels->empty(); ++i)
+        {
+            samples.push_back((*pixels)[pixels->size() * i / part_count].x);
+        }
+    }
+    std::ranges::sort(samples);
+
+    std::vector<s64> splitters;
+    splitters.reserve(part_count - 1);
+    for (size_t i = 1; i < part_count; ++i)
+    {
+        splitters.push_back(samples[samples.size() * i / part_count]);
+    }
+    return splitters;
+}
+
+/// @brief Merges the pixels of all shards with x in the range [min_x, max_x) removing duplicates.
+/// The function is called for every unique pixel in the ascending order.
+template <std::invocable<const Vec2s64 &> F>
+void merge_part(
+    const std::vector<const std::vector<Vec2s64> *> & shards,
+    const s64 * min_x,
+    const s64 * max_x,
+    F && f)
+{
+    const auto greater = [](const Cursor & lhs, const Cursor & rhs)
+    {
+        return *lhs.position > *rhs.position;
+    };
+
+    std::vector<Cursor> heap;
+    for (const auto * pixels : shards)
+    {
+        const auto x_bound = [&](const s64 * x, const Vec2s64 * fallback)
+        {
+            if (x == nullptr)
+            {
+                return fallback;
+            }
+            return std::ranges::lower_bound(pixels->data(), pixels->data() + pixels->size(), *x, {}, &Vec2s64::x);
+        };
+        const Cursor cursor {
+            .position = x_bound(min_x, pixels->data()),
+            .end = x_bound(max_x, pixels->data() + pixels->size()),
+        };
+        if (cursor.position != cursor.end)
+        {
+            heap.push_back(cursor);
+        }
+    }
+    std::ranges::make_heap(heap, greater);
+
+    const Vec2s64 * last = nullptr;
+    while (!heap.empty())
+    {
+        std::ranges::pop_heap(heap, greater);
+        auto & cursor = heap.back();
+        const auto * const pixel = cursor.position++;
+        if (last == nullptr || *last != *pixel)
+        {
+            f(*pixel);
+            last = pixel;
+        }
+        if (cursor.position == cursor.end)
+        {
+            heap.pop_back();
+        }
+        else
+        {
+            std::ranges::push_heap(heap, greater);
+        }
+    }
+}
+
+} // namespace
+
+const HotPixelIndex & ParallelHotPixelCollector::build_index(const SortPolicy sort_policy)
+{
+    const auto thread_count = shards_.size();
+
+    std::vector<const std::vector<Vec2s64> *> shards;
+    shards.reserve(thread_count);
+    for (const auto & shard : shards_)
+    {
+        shards.push_back(&shard.hot_pixels_);
+    }
+
+    run_parallel(
+        thread_count,
+        [&](const size_t i)
+        {
+            auto & pixels = shards_[i].hot_pixels_;
+            sort_by_key(pixels, radix_key, sort_policy);
+            const auto to_remove = std::ranges::unique(pixels);
+            pixels.erase(to_remove.begin(), to_remove.end());
+        });
+
+    AR_PRE(std::ranges::any_of(
+        shards,
+        [](const auto * pixels)
+        {
+            return !pixels->empty();
+        }));
+    const auto splitters = choose_splitters(shards, thread_count);
+    const auto min_x = [&](const size_t part)
+    {
+        return part == 0 ? nullptr : &splitters[part - 1];
+    };
+    const auto max_x = [&](const size_t part)
+    {
+        return part + 1 == thread_count ? nullptr : &splitters[part];
+    };
+
+    // The parts are merged twice: first to size the index, then to write the pixels directly to their places,
+    // so the merged pixels are never stored in between.
+    std::vector<PartSize> sizes(thread_count);
+    run_parallel(
+        thread_count,
+        [&](const size_t i)
+        {
+            auto & size = sizes[i];
+            s64 last_x = 0;
+            merge_part(
+                shards,
+                min_x(i),
+                max_x(i),
+                [&](const Vec2s64 & pixel)
+                {
+                    if (size.pixel_count == 0 || last_x != pixel.x)
+                    {
+                        ++size.column_count;
+                        last_x = pixel.x;
+                    }
+                    ++size.pixel_count;
+                });
+        });
+
+    std::vector<size_t> first_pixels;
+    std::vector<size_t> first_columns;
+    size_t pixel_count = 0;
+    size_t column_count = 0;
+    for (const auto & size : sizes)
+    {
+        first_pixels.push_back(pixel_count);
+        first_columns.push_back(column_count);
+        pixel_count += size.pixel_count;
+        column_count += size.column_count;
+    }
+    AR_PRE(pixel_count <= std::numeric_limits<u32>::max());
+
+    index_.xs_.resize(column_count);
+    index_.offsets_.resize(column_count + 1);
+    index_.ys_.resize(pixel_count);
+    run_parallel(
+        thread_count,
+        [&](const size_t i)
+        {
+            auto pixel = first_pixels[i];
+            auto column = first_columns[i];
+            merge_part(
+                shards,
+                min_x(i),
+                max_x(i),
+                [&](const Vec2s64 & point)
+                {
+                    if (column == first_columns[i] || index_.xs_[column - 1] != point.x)
+                    {
+                        index_.xs_[column] = point.x;
+                        index_.offsets_[column] = static_cast<u32>(pixel);
+                        ++column;
+                    }
+                    index_.ys_[pixel++] = point.y;
+                });
+            AR_POST(pixel == first_pixels[i] + sizes[i].pixel_count);
+            AR_POST(column == first_columns[i] + sizes[i].column_count);
+        });
+    index_.offsets_.back() = static_cast<u32>(pixel_count);
+    return index_;
+}
+
+} // namespace ka
@@ -1,16 +1,59 @@
 #include <algorithm>
 
+#include <ka/common/assert.hpp>
 #include <ka/geometry_types/Vec2.hpp>
+#include <ka/geometry_types/space_filling_curve.hpp>
 #include <ka/tilecut/collect_tiles.hpp>
+#include <ka/tilecut/radix_sort.hpp>
 
 namespace ka
 {
 
+inline namespace
+{
+
+/// @brief Sorts segments, so that the segments of every tile are adjacent and tiles go in the given order.
+void sort_by_tiles(
+    const TileGrid & tile_grid,
+    std::vector<Segment2s64> & segments,
+    const TileOrder order,
+    const SortPolicy sort_policy) noexcept
+{
+    const auto tile_of = [&](const auto & segment)
+    {
+        return tile_grid.tile_of(segment);
+    };
+    switch (order)
+    {
+    case TileOrder::Coordinates:
+        sort_by_key(
+            segments,
+            [&](const auto & segment)
+            {
+                const auto tile = tile_of(segment);
+                return RadixKey<2> { tile.x, tile.y };
+            },
+            sort_policy);
+        return;
+    case TileOrder::Morton:
+        sort_along_curve(segments, SpaceFillingCurve::Morton, tile_of);
+        return;
+    case TileOrder::Hilbert:
+        sort_along_curve(segments, SpaceFillingCurve::Hilbert, tile_of);
+        return;
+    }
+    AR_UNREACHABLE;
+}
+
+} // namespace
+
 void collect_tiles(
     const TileGrid & tile_grid,
     std::vector<Segment2s64> & unique_segments,
     std::vector<Segment2u16> & tile_segments,
-    std::vector<Tile> & tiles) noexcept
+    std::vector<Tile> & tiles,
+    const TileOrder order,
+    const SortPolicy sort_policy) noexcept
 {
     tile_segments.clear();
     tiles.clear();
@@ -19,13 +62,7 @@ void collect_tiles(
         return;
     }
 
-    std::ranges::sort(
-        unique_segments,
-        {},
-        [&](const auto & segment)
-        {
-            return tile_grid.tile_of(segment);
-        });
+    sort_by_tiles(tile_grid, unique_segments, order, sort_policy);
 
     tile_segments.reserve(unique_segments.size());
 
@@ -50,4 +87,56 @@ void collect_tiles(
     flush_tile(prev_tile);
 }
 
+void collect_tiles(
+    const TileGrid & tile_grid,
+    std::vector<Segment2s64> & unique_segments,
+    std::vector<u8> & tile_bytes,
+    std::vector<CompactTile> & tiles,
+    const TileOrder order,
+    const SortPolicy sort_policy) noexcept
+{
+    tile_bytes.clear();
+    tiles.clear();
+    if (unique_segments.empty())
+    {
+        return;
+    }
+
+    sort_by_tiles(tile_grid, unique_segments, order, sort_policy);
+
+    // The exact size is reserved, so the spans of the tiles are not invalidated by reallocation.
+    size_t byte_count = 0;
+    Vec2s64 size_tile = tile_grid.tile_of(unique_segments.front());
+    Vec2u16 last_point {};
+    for (const auto & segment : unique_segments)
+    {
+        const auto tile = tile_grid.tile_of(segment);
+        if (tile != size_tile)
+        {
+            size_tile = tile;
+            last_point = {};
+        }
+        const auto local_segment = tile_grid.local_coordinates(tile, segment);
+        byte_count += CompactSegmentsEncoder::encoded_size(last_point, local_segment);
+        last_point = local_segment.b;
+    }
+    tile_bytes.reserve(byte_count);
+
+    auto encoder = CompactSegmentsEncoder { tile_bytes };
+    auto prev_tile = tile_grid.tile_of(unique_segments.front());
+    for (const auto & segment : unique_segments)
+    {
+        const auto tile = tile_grid.tile_of(segment);
+        if (tile != prev_tile)
+        {
+            tiles.push_back({ .tile = prev_tile, .segments = encoder.segments() });
+            encoder = CompactSegmentsEncoder { tile_bytes };
+            prev_tile = tile;
+        }
+        encoder.push_back(tile_grid.local_coordinates(tile, segment));
+    }
+    tiles.push_back({ .tile = prev_tile, .segments = encoder.segments() });
+    AR_POST(tile_bytes.size() == byte_count);
+}
+
 } // namespace ka
@@ -1,6 +1,9 @@
 #include <algorithm>
+#include <bit>
+#include <limits>
 
 #include <ka/common/assert.hpp>
+#include <ka/common/fixed.hpp>
 #include <ka/tilecut/filter_segments.hpp>
 
 namespace ka
@@ -19,25 +22,42 @@ inline namespace
     return segment.a < segment.b ? segment : flipped(segment);
 }
 
+[[nodiscard]] bool degenerate(const Segment2s64 & segment) noexcept
+{
+    return segment.a == segment.b;
+}
+
+constexpr u32 g_empty_slot = std::numeric_limits<u32>::max();
+
+/// @brief Hashes the coordinates of the undirected segment, the highest bits are the best mixed.
+[[nodiscard]] u64 undirected_hash(const Segment2s64 & undirected) noexcept
+{
+    u64 hash = 0;
+    for (const auto value : { undirected.a.x, undirected.a.y, undirected.b.x, undirected.b.y })
+    {
+        hash = (std::rotl(hash, 23) ^ static_cast<u64>(value)) * 0x9e3779b97f4a7c15;
+    }
+    return hash;
+}
+
 } // namespace
 
-void filter_segments(std::vector<Segment2s64> & segments) noexcept
+void filter_segments(std::vector<Segment2s64> & segments, const SortPolicy sort_policy) noexcept
 {
-    segments.erase(
-        std::remove_if(
-            segments.begin(),
-            segments.end(),
-            [](const auto & segment)
-            {
-                return segment.a == segment.b;
-            }),
-        segments.end());
+    segments.erase(std::remove_if(segments.begin(), segments.end(), degenerate), segments.end());
 
     if (segments.empty())
     {
         return;
     }
-    std::ranges::sort(segments, {}, unoriented);
+    sort_by_key(
+        segments,
+        [](const Segment2s64 & segment)
+        {
+            const auto undirected = unoriented(segment);
+            return RadixKey<4> { undirected.a.x, undirected.a.y, undirected.b.x, undirected.b.y };
+        },
+        sort_policy);
     auto out_it = segments.begin();
     s64 counter = 0;
     const auto orient_and_push_segment = [&](const auto & segment)
@@ -76,4 +96,55 @@ void filter_segments(std::vector<Segment2s64> & segments) noexcept
     segments.erase(out_it, segments.end());
 }
 
+void HashSegmentFilter::filter(std::vector<Segment2s64> & segments) noexcept
+{
+    AR_PRE(segments.size() < (size_t { 1 } << 31));
+
+    // The load factor of the table does not exceed 1/2, so linear probing takes expected constant time.
+    const auto bits = std::bit_width(2 * std::max<size_t>(segments.size(), 8) - 1);
+    const auto mask = (size_t { 1 } << bits) - 1;
+    slots_.assign(size_t { 1 } << bits, { .first = g_empty_slot, .balance = 0 });
+
+    // The first occurrence of every segment is kept intact and represents it in the table,
+    // all other occurrences are only counted and then marked for removal by making them zero length.
+    for (size_t i = 0; i < segments.size(); ++i)
+    {
+        const auto segment = segments[i];
+        if (degenerate(segment))
+        {
+            continue;
+        }
+        const auto undirected = unoriented(segment);
+        const auto orientation = segment == undirected ? 1 : -1;
+        for (auto slot = undirected_hash(undirected) >> (64 - bits);; slot = (slot + 1) & mask)
+        {
+            auto & [first, balance] = slots_[slot];
+            if (first == g_empty_slot)
+            {
+                first = static_cast<u32>(i);
+                balance = orientation;
+                break;
+            }
+            if (unoriented(segments[first]) == undirected)
+            {
+                balance += orientation;
+                segments[i].b = segment.a;
+                break;
+            }
+        }
+    }
+
+    for (const auto & [first, balance] : slots_)
+    {
+        if (first == g_empty_slot)
+        {
+            continue;
+        }
+        AR_ASSERT(-1 <= balance && balance <= 1);
+        const auto undirected = unoriented(segments[first]);
+        segments[first] = balance > 0 ? undirected : balance < 0 ? flipped(undirected) : Segment2s64 {};
+    }
+    segments.erase(std::remove_if(segments.begin(), segments.end(), degenerate), segments.end());
+}
+
 } // namespace ka
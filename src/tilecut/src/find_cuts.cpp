@@ -1,5 +1,7 @@
 #include <algorithm>
+#include <concepts>
 #include <optional>
+#include <ranges>
 #include <utility>
 
 #include <ka/common/assert.hpp>
@@ -96,9 +98,10 @@ void add_cut(
 /// @brief Checks that all maximum inclusion contours are oriented counter-clockwise.
 /// @param segments a collection of non-intersecting oriented segments, none of which touches the boundary of a tile,
 /// that form a set of contours.
-[[nodiscard]] bool outermost_contour_is_inner(const std::span<const Segment2u16> segments) noexcept
+template <std::ranges::forward_range R>
+[[nodiscard]] bool outermost_contour_is_inner(const R & segments) noexcept
 {
-    AR_PRE(!segments.empty());
+    AR_PRE(!std::ranges::empty(segments));
     const auto segment_it = std::ranges::min_element(
         segments,
         [](const auto & lhs, const auto & rhs) noexcept
@@ -113,8 +116,9 @@ void add_cut(
         {
             return { std::min(segment.a, segment.b), std::max(segment.a, segment.b) };
         });
-    AR_ASSERT(segment_it != segments.end());
-    return segment_it->a > segment_it->b;
+    AR_ASSERT(segment_it != std::ranges::end(segments));
+    const Segment2u16 segment = *segment_it;
+    return segment.a > segment.b;
 }
 
 struct TouchingSegment final
@@ -164,20 +168,17 @@ struct TouchingSegment final
     return true;
 }
 
-} // namespace
-
-void find_cuts(
-    const TileGrid & tile_grid,
-    const std::span<const Segment2u16> segments,
-    std::vector<Segment2u16> & result) noexcept
+template <std::ranges::forward_range R>
+    requires std::same_as<std::ranges::range_value_t<R>, Segment2u16>
+void find_cuts_impl(const TileGrid & tile_grid, const R & segments, std::vector<Segment2u16> & result) noexcept
 {
-    if (segments.empty())
+    if (std::ranges::empty(segments))
     {
         return;
     }
     // TODO: Reuse vector.
     std::vector<TouchingSegment> touching_segments;
-    touching_segments.reserve(segments.size() * 2);
+    touching_segments.reserve(std::ranges::size(segments) * 2);
     for (const auto & segment : segments)
     {
         const auto begin_param = make_parameter(tile_grid.tile_size(), segment.a);
@@ -293,6 +294,21 @@ void find_cuts(
     }
 }
 
+} // namespace
+
+void find_cuts(
+    const TileGrid & tile_grid,
+    const std::span<const Segment2u16> segments,
+    std::vector<Segment2u16> & result) noexcept
+{
+    find_cuts_impl(tile_grid, segments, result);
+}
+
+void find_cuts(const TileGrid & tile_grid, const CompactSegments & segments, std::vector<Segment2u16> & result) noexcept
+{
+    find_cuts_impl(tile_grid, segments, result);
+}
+
 bool open_on_the_bottom(const std::span<const Segment2u16> cut_segments) noexcept
 {
     return std::ranges::any_of(
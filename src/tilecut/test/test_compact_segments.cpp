@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <iterator>
+#include <limits>
+#include <random>
+#include <ranges>
+#include <vector>
+
+#include <ka/common/fixed.hpp>
+#include <ka/geometry_types/Segment2.hpp>
+#include <ka/geometry_types/Vec2.hpp>
+#include <ka/tilecut/CompactSegments.hpp>
+#include <ka/tilecut/HotPixelCollector.hpp>
+#include <ka/tilecut/collect_tiles.hpp>
+#include <ka/tilecut/filter_segments.hpp>
+#include <ka/tilecut/find_cuts.hpp>
+#include <ka/tilecut/snap_round.hpp>
+
+#include "debug_output.hpp"
+#include "mock_grid_parameters.hpp"
+
+namespace ka
+{
+
+using ::testing::ElementsAreArray;
+
+static_assert(std::ranges::forward_range<CompactSegments>);
+static_assert(std::ranges::sized_range<CompactSegments>);
+static_assert(std::same_as<std::ranges::range_value_t<CompactSegments>, Segment2u16>);
+
+inline namespace
+{
+
+[[nodiscard]] std::vector<Segment2u16> decode(const CompactSegments & segments)
+{
+    return { segments.begin(), segments.end() };
+}
+
+} // namespace
+
+TEST(CompactSegmentsTest, round_trip)
+{
+    constexpr u16 max = std::numeric_limits<u16>::max();
+
+    std::mt19937_64 random { 42 };
+    std::uniform_int_distribution<u16> coordinate { 0, max };
+    std::uniform_int_distribution<int> step { -3, 3 };
+    std::bernoulli_distribution jump { 0.1 };
+
+    std::vector<Segment2u16> segments {
+        { { 0, 0 }, { max, max } },
+        { { max, max }, { 0, 0 } },
+        { { max, 0 }, { 0, max } },
+        { { 0, max }, { max / 2, max / 2 + 1 } },
+    };
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        const auto a = jump(random) ? Vec2u16 { coordinate(random), coordinate(random) } : segments.back().b;
+        const Vec2u16 b { static_cast<u16>(a.x + step(random)), static_cast<u16>(a.y + step(random)) };
+        segments.push_back({ a, b });
+    }
+
+    std::vector<u8> bytes { 1, 2, 3 };
+    CompactSegmentsEncoder encoder { bytes };
+    size_t expected_size = 0;
+    Vec2u16 last_point {};
+    for (const auto & segment : segments)
+    {
+        expected_size += CompactSegmentsEncoder::encoded_size(last_point, segment);
+        encoder.push_back(segment);
+        last_point = segment.b;
+    }
+
+    const auto compact = encoder.segments();
+    EXPECT_EQ(compact.size(), segments.size());
+    EXPECT_EQ(compact.bytes().size(), expected_size);
+    EXPECT_EQ(bytes.size(), expected_size + 3);
+    EXPECT_THAT(decode(compact), ElementsAreArray(segments));
+}
+
+TEST(CompactSegmentsTest, chained_segments_take_two_bytes)
+{
+    const std::vector<Segment2u16> segments {
+        { { 0, 0 }, { 10, 0 } },
+        { { 10, 0 }, { 10, 10 } },
+        { { 10, 10 }, { 0, 10 } },
+        { { 0, 10 }, { 0, 0 } },
+    };
+
+    std::vector<u8> bytes;
+    CompactSegmentsEncoder encoder { bytes };
+    std::ranges::copy(segments, std::back_inserter(encoder));
+    EXPECT_EQ(bytes.size(), 2 * segments.size());
+    EXPECT_THAT(decode(encoder.segments()), ElementsAreArray(segments));
+    EXPECT_TRUE(decode(CompactSegments {}).empty());
+}
+
+TEST(CompactSegmentsTest, same_tiles_and_cuts_as_plain_segments)
+{
+    const auto grid = make_grid<GridRounding::NearestNode>(1.0, {}, 16);
+
+    std::mt19937_64 random { 42 };
+    std::uniform_real_distribution<f64> coordinate { -100.0, 100.0 };
+
+    // Random triangles of both orientations crossing many tiles.
+    std::vector<std::vector<Vec2f64>> contours;
+    for (size_t i = 0; i < 20; ++i)
+    {
+        const Vec2f64 a { coordinate(random), coordinate(random) };
+        const Vec2f64 b { coordinate(random), coordinate(random) };
+        const Vec2f64 c { coordinate(random), coordinate(random) };
+        contours.push_back({ a, b, c, a });
+    }
+
+    for (const auto & contour : contours)
+    {
+        HotPixelCollector collector;
+        collector.add_tile_snapped_polyline(grid, contour);
+        const auto & hot_pixels = collector.build_index();
+
+        std::vector<Vec2s64> points;
+        snap_round(grid, hot_pixels, contour, std::back_inserter(points));
+        std::vector<Segment2s64> segments;
+        for (size_t i = 1; i < points.size(); ++i)
+        {
+            segments.push_back({ points[i - 1], points[i] });
+        }
+        filter_segments(segments);
+        if (segments.empty())
+        {
+            continue;
+        }
+
+        auto compact_segments = segments;
+        std::vector<Segment2u16> tile_segments;
+        std::vector<Tile> tiles;
+        collect_tiles(grid.tiles(), segments, tile_segments, tiles);
+        std::vector<u8> tile_bytes;
+        std::vector<CompactTile> compact_tiles;
+        collect_tiles(grid.tiles(), compact_segments, tile_bytes, compact_tiles);
+
+        ASSERT_EQ(compact_tiles.size(), tiles.size());
+        EXPECT_LT(tile_bytes.size(), tile_segments.size() * sizeof(Segment2u16));
+        std::vector<Segment2u16> cuts;
+        std::vector<Segment2u16> compact_cuts;
+        for (size_t i = 0; i < tiles.size(); ++i)
+        {
+            ASSERT_EQ(compact_tiles[i].tile, tiles[i].tile);
+            ASSERT_THAT(decode(compact_tiles[i].segments), ElementsAreArray(tiles[i].segments));
+
+            cuts.clear();
+            compact_cuts.clear();
+            find_cuts(grid.tiles(), tiles[i].segments, cuts);
+            find_cuts(grid.tiles(), compact_tiles[i].segments, compact_cuts);
+            ASSERT_THAT(compact_cuts, ElementsAreArray(cuts));
+        }
+    }
+}
+
+} // namespace ka
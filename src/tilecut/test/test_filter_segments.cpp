@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <span>
+#include <vector>
+
+#include <ka/common/fixed.hpp>
+#include <ka/geometry_types/Segment2.hpp>
+#include <ka/geometry_types/Vec2.hpp>
+#include <ka/tilecut/filter_segments.hpp>
+
+#include "debug_output.hpp"
+
+namespace ka
+{
+
+using ::testing::ElementsAreArray;
+
+inline namespace
+{
+
+/// @brief Generates segments whose repetitions cancel out to at most one segment in every direction.
+[[nodiscard]] std::vector<Segment2s64> random_segments(std::mt19937_64 & random, const size_t count)
+{
+    // Every pattern lists the orientations of the repetitions of the same segment.
+    const std::array<std::vector<bool>, 6> patterns { {
+        { true },
+        { false },
+        { true, false },
+        { true, false, true },
+        { false, true, false, false, true },
+        { true, true, false, false },
+    } };
+    std::uniform_int_distribution<s64> coordinate { -20, 20 };
+    std::uniform_int_distribution<size_t> pattern { 0, patterns.size() - 1 };
+
+    std::vector<Segment2s64> result;
+    std::vector<Segment2s64> keys;
+    while (keys.size() < count)
+    {
+        const Vec2s64 a { coordinate(random), coordinate(random) };
+        const Vec2s64 b { coordinate(random), coordinate(random) };
+        const Segment2s64 segment { a, b };
+        const auto undirected = segment.to_undirected();
+        if (std::ranges::find(keys, undirected) != keys.end())
+        {
+            continue;
+        }
+        keys.push_back(undirected);
+        for (const auto forward : patterns[pattern(random)])
+        {
+            result.push_back(forward ? segment : Segment2s64 { segment.b, segment.a });
+        }
+    }
+    result.push_back({ { 1, 1 }, { 1, 1 } });
+    std::ranges::shuffle(result, random);
+    return result;
+}
+
+} // namespace
+
+TEST(FilterSegmentsTest, cancel_opposite)
+{
+    const Segment2s64 a { { 0, 0 }, { 1, 0 } };
+    const Segment2s64 b { { 1, 0 }, { 1, 1 } };
+    const Segment2s64 c { { 1, 1 }, { 0, 0 } };
+    const Segment2s64 flipped_b { b.b, b.a };
+    const Segment2s64 flipped_a { a.b, a.a };
+    const Segment2s64 point { { 5, 5 }, { 5, 5 } };
+    const std::vector<Segment2s64> input { c, b, a, flipped_b, point, b, flipped_a, a };
+
+    auto sorted = input;
+    filter_segments(sorted);
+    EXPECT_THAT(sorted, ElementsAreArray({ a, c, b }));
+
+    auto hashed = input;
+    HashSegmentFilter filter;
+    filter.filter(hashed);
+    EXPECT_THAT(hashed, ElementsAreArray({ c, b, a }));
+}
+
+TEST(FilterSegmentsTest, hash_same_as_sort)
+{
+    std::mt19937_64 random { 42 };
+    HashSegmentFilter filter;
+    for (const size_t count : { 0, 1, 2, 10, 100, 1000, 10 })
+    {
+        const auto input = random_segments(random, count);
+
+        auto sorted = input;
+        filter_segments(sorted);
+        auto hashed = input;
+        filter.filter(hashed);
+
+        // The segments keep the order of their first occurrences.
+        const auto first_occurrence = [&](const Segment2s64 & segment)
+        {
+            return std::ranges::find_if(
+                input,
+                [&](const Segment2s64 & other)
+                {
+                    return other.to_undirected() == segment.to_undirected();
+                });
+        };
+        EXPECT_TRUE(std::ranges::is_sorted(hashed, {}, first_occurrence)) << count;
+
+        std::ranges::sort(hashed, {}, &Segment2s64::to_undirected);
+        EXPECT_THAT(hashed, ElementsAreArray(sorted)) << count;
+    }
+}
+
+TEST(FilterSegmentsTest, radix_same_as_comparison)
+{
+    std::mt19937_64 random { 42 };
+    for (const size_t count : { 0, 1, 2, 10, 100, 1000 })
+    {
+        const auto input = random_segments(random, count);
+
+        auto comparison = input;
+        filter_segments(comparison, SortPolicy::Comparison);
+        auto radix = input;
+        filter_segments(radix, SortPolicy::Radix);
+        EXPECT_THAT(radix, ElementsAreArray(comparison)) << count;
+    }
+}
+
+} // namespace ka
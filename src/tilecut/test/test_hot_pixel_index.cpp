@@ -0,0 +1,368 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <numeric>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include <ka/common/fixed.hpp>
+#include <ka/geometry_types/Segment2.hpp>
+#include <ka/geometry_types/Vec2.hpp>
+#include <ka/tilecut/HotPixelCollector.hpp>
+#include <ka/tilecut/HotPixelIndex.hpp>
+#include <ka/tilecut/HotPixelOrder.hpp>
+#include <ka/tilecut/TiledHotPixelIndex.hpp>
+#include <ka/tilecut/hot_pixel_less.hpp>
+#include <ka/tilecut/snap_round.hpp>
+
+#include "debug_output.hpp"
+#include "mock_grid_parameters.hpp"
+
+namespace ka
+{
+
+using ::testing::ElementsAreArray;
+
+inline namespace
+{
+
+struct Rectangle final
+{
+    s64 min_x;
+    s64 max_x;
+    s64 min_y;
+    s64 max_y;
+};
+
+template <HotPixelOrder horizontal_order, HotPixelOrder vertical_order, typename Index>
+void expect_same_as_brute_force(
+    const Index & index,
+    const std::vector<Vec2s64> & pixels,
+    const Rectangle & rectangle)
+{
+    const auto predicate = [](const Vec2s64 & pixel)
+    {
+        return (pixel.x + pixel.y) % 3 != 0;
+    };
+
+    std::vector<Vec2s64> expected;
+    std::ranges::copy_if(
+        pixels,
+        std::back_inserter(expected),
+        [&](const Vec2s64 & pixel)
+        {
+            return rectangle.min_x <= pixel.x && pixel.x <= rectangle.max_x && rectangle.min_y <= pixel.y &&
+                   pixel.y <= rectangle.max_y && predicate(pixel);
+        });
+    std::ranges::sort(expected, hot_pixel_less<horizontal_order, vertical_order> {});
+
+    std::vector<Vec2s64> result;
+    std::ignore = index.template find_if<horizontal_order, vertical_order>(
+        rectangle.min_x,
+        rectangle.max_x,
+        rectangle.min_y,
+        rectangle.max_y,
+        std::back_inserter(result),
+        predicate);
+    EXPECT_THAT(result, ElementsAreArray(expected))
+        << rectangle.min_x << ' ' << rectangle.max_x << ' ' << rectangle.min_y << ' ' << rectangle.max_y;
+}
+
+template <HotPixelOrder horizontal_order, HotPixelOrder vertical_order, typename Index>
+void expect_corridor(const Index & index, const std::vector<Vec2s64> & pixels, const Segment2s64 & cells)
+{
+    // The square of the pixel expanded by one cell is not separated from the segment by its line.
+    const auto near = [&](const Vec2s64 & pixel)
+    {
+        if (pixel.x < std::min(cells.a.x, cells.b.x) || pixel.x > std::max(cells.a.x, cells.b.x) ||
+            pixel.y < std::min(cells.a.y, cells.b.y) || pixel.y > std::max(cells.a.y, cells.b.y))
+        {
+            return false;
+        }
+        bool left = false;
+        bool right = false;
+        for (const auto dx : { -1, 1 })
+        {
+            for (const auto dy : { -1, 1 })
+            {
+                const Vec2s64 corner { pixel.x + dx, pixel.y + dy };
+                const auto orientation = (cells.b.x - cells.a.x) * (corner.y - cells.a.y) -
+                                         (cells.b.y - cells.a.y) * (corner.x - cells.a.x);
+                left = left || orientation >= 0;
+                right = right || orientation <= 0;
+            }
+        }
+        return left && right;
+    };
+
+    std::vector<Vec2s64> expected;
+    std::ranges::copy_if(pixels, std::back_inserter(expected), near);
+    std::ranges::sort(expected, hot_pixel_less<horizontal_order, vertical_order> {});
+
+    std::vector<Vec2s64> result;
+    std::ignore = index.template find_if_along<horizontal_order, vertical_order>(
+        cells,
+        std::back_inserter(result),
+        [](const Vec2s64 &)
+        {
+            return true;
+        });
+    EXPECT_THAT(result, ElementsAreArray(expected)) << cells;
+}
+
+template <HotPixelOrder horizontal_order, HotPixelOrder vertical_order>
+void expect_cursor_same_as_index(
+    const HotPixelIndex & index,
+    HotPixelIndex::Cursor & cursor,
+    const Rectangle & rectangle,
+    const Segment2s64 & cells)
+{
+    const auto predicate = [](const Vec2s64 & pixel)
+    {
+        return (pixel.x + pixel.y) % 3 != 0;
+    };
+
+    std::vector<Vec2s64> expected;
+    std::vector<Vec2s64> result;
+    std::ignore = index.find_if<horizontal_order, vertical_order>(
+        rectangle.min_x,
+        rectangle.max_x,
+        rectangle.min_y,
+        rectangle.max_y,
+        std::back_inserter(expected),
+        predicate);
+    std::ignore = cursor.find_if<horizontal_order, vertical_order>(
+        rectangle.min_x,
+        rectangle.max_x,
+        rectangle.min_y,
+        rectangle.max_y,
+        std::back_inserter(result),
+        predicate);
+    EXPECT_THAT(result, ElementsAreArray(expected))
+        << rectangle.min_x << ' ' << rectangle.max_x << ' ' << rectangle.min_y << ' ' << rectangle.max_y;
+
+    expected.clear();
+    result.clear();
+    std::ignore = index.find_if_along<horizontal_order, vertical_order>(cells, std::back_inserter(expected), predicate);
+    std::ignore = cursor.find_if_along<horizontal_order, vertical_order>(cells, std::back_inserter(result), predicate);
+    EXPECT_THAT(result, ElementsAreArray(expected)) << cells;
+}
+
+} // namespace
+
+TEST(HotPixelIndexTest, gallop_partition_point)
+{
+    for (const size_t size : { 0, 1, 2, 3, 10, 33 })
+    {
+        std::vector<s64> values(size);
+        std::iota(values.begin(), values.end(), 0);
+        for (s64 bound = -1; bound <= static_cast<s64>(size) + 1; ++bound)
+        {
+            const auto predicate = [&](const s64 value)
+            {
+                return value < bound;
+            };
+            const auto expected = detail::partition_point(values, predicate);
+            for (size_t hint = 0; hint <= size + 2; ++hint)
+            {
+                EXPECT_EQ(detail::gallop_partition_point(values, hint, predicate), expected)
+                    << size << ' ' << bound << ' ' << hint;
+            }
+        }
+    }
+}
+
+TEST(HotPixelIndexTest, same_as_brute_force)
+{
+    const auto grid = make_grid<GridRounding::NearestNode>(1.0, {}, 8);
+
+    std::mt19937_64 random { 42 };
+    std::uniform_int_distribution<s64> coordinate { -30, 30 };
+
+    HotPixelCollector collector;
+    std::vector<Vec2s64> pixels;
+    for (size_t i = 0; i < 500; ++i)
+    {
+        const Vec2s64 pixel { coordinate(random), coordinate(random) };
+        const std::array<Vec2f64, 1> point { { { static_cast<f64>(pixel.x), static_cast<f64>(pixel.y) } } };
+        collector.add_tile_snapped_polyline(grid, point);
+        if (std::ranges::find(pixels, pixel) == pixels.end())
+        {
+            pixels.push_back(pixel);
+        }
+    }
+    const auto & index = collector.build_index();
+    const auto & tiled_index = collector.build_tiled_index(grid.tiles());
+
+    using enum HotPixelOrder;
+    for (size_t i = 0; i < 200; ++i)
+    {
+        const Vec2s64 a { coordinate(random) * 2, coordinate(random) * 2 };
+        const Vec2s64 b { coordinate(random) * 2, coordinate(random) * 2 };
+        const Rectangle rectangle { std::min(a.x, b.x), std::max(a.x, b.x), std::min(a.y, b.y), std::max(a.y, b.y) };
+        expect_same_as_brute_force<Ascending, Ascending>(index, pixels, rectangle);
+        expect_same_as_brute_force<Ascending, Descending>(index, pixels, rectangle);
+        expect_same_as_brute_force<Descending, Ascending>(index, pixels, rectangle);
+        expect_same_as_brute_force<Descending, Descending>(index, pixels, rectangle);
+        expect_same_as_brute_force<Ascending, Ascending>(tiled_index, pixels, rectangle);
+        expect_same_as_brute_force<Ascending, Descending>(tiled_index, pixels, rectangle);
+        expect_same_as_brute_force<Descending, Ascending>(tiled_index, pixels, rectangle);
+        expect_same_as_brute_force<Descending, Descending>(tiled_index, pixels, rectangle);
+    }
+}
+
+TEST(HotPixelIndexTest, corridor_same_as_brute_force)
+{
+    const auto grid = make_grid<GridRounding::NearestNode>(1.0, {}, 8);
+
+    std::mt19937_64 random { 42 };
+    std::uniform_int_distribution<s64> coordinate { -30, 30 };
+
+    HotPixelCollector collector;
+    std::vector<Vec2s64> pixels;
+    for (s64 y = -30; y <= 30; ++y)
+    {
+        for (s64 x = -30; x <= 30; ++x)
+        {
+            if ((x * 7 + y * 13) % 5 != 0)
+            {
+                continue;
+            }
+            const std::array<Vec2f64, 1> point { { { static_cast<f64>(x), static_cast<f64>(y) } } };
+            collector.add_tile_snapped_polyline(grid, point);
+            pixels.push_back({ x, y });
+        }
+    }
+    const auto & index = collector.build_index();
+    const auto & tiled_index = collector.build_tiled_index(grid.tiles());
+
+    using enum HotPixelOrder;
+    for (size_t i = 0; i < 200; ++i)
+    {
+        const Segment2s64 cells {
+            { coordinate(random), coordinate(random) },
+            { coordinate(random), coordinate(random) },
+        };
+        expect_corridor<Ascending, Ascending>(index, pixels, cells);
+        expect_corridor<Ascending, Descending>(index, pixels, cells);
+        expect_corridor<Descending, Ascending>(index, pixels, cells);
+        expect_corridor<Descending, Descending>(index, pixels, cells);
+        expect_corridor<Ascending, Ascending>(tiled_index, pixels, cells);
+        expect_corridor<Ascending, Descending>(tiled_index, pixels, cells);
+        expect_corridor<Descending, Ascending>(tiled_index, pixels, cells);
+        expect_corridor<Descending, Descending>(tiled_index, pixels, cells);
+    }
+    expect_corridor<Ascending, Ascending>(index, pixels, { { 5, -20 }, { 5, 20 } });
+    expect_corridor<Descending, Ascending>(index, pixels, { { 20, 5 }, { -20, 5 } });
+    expect_corridor<Ascending, Ascending>(index, pixels, { { 0, 0 }, { 0, 0 } });
+    expect_corridor<Ascending, Descending>(tiled_index, pixels, { { 16, -20 }, { 16, 20 } });
+    expect_corridor<Descending, Ascending>(tiled_index, pixels, { { 20, -16 }, { -20, -16 } });
+    expect_corridor<Ascending, Ascending>(tiled_index, pixels, { { 0, 0 }, { 0, 0 } });
+}
+
+TEST(HotPixelIndexTest, cursor_same_as_index)
+{
+    const auto grid = make_grid<GridRounding::NearestNode>(1.0, {}, 8);
+
+    std::mt19937_64 random { 42 };
+    std::uniform_int_distribution<s64> coordinate { -30, 30 };
+    std::uniform_int_distribution<s64> step { -3, 3 };
+
+    HotPixelCollector collector;
+    for (size_t i = 0; i < 500; ++i)
+    {
+        const std::array<Vec2f64, 1> point { {
+            { static_cast<f64>(coordinate(random)), static_cast<f64>(coordinate(random)) },
+        } };
+        collector.add_tile_snapped_polyline(grid, point);
+    }
+    const auto & index = collector.build_index();
+
+    using enum HotPixelOrder;
+    auto cursor = index.cursor();
+    Vec2s64 prev { 0, 0 };
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        // Alternate short steps along a contour with jumps to check that stale positions are handled.
+        const Vec2s64 next = i % 50 == 0 ? Vec2s64 { coordinate(random), coordinate(random) }
+                                         : Vec2s64 { prev.x + step(random), prev.y + step(random) };
+        const Rectangle rectangle {
+            std::min(prev.x, next.x) - 1,
+            std::max(prev.x, next.x) + 1,
+            std::min(prev.y, next.y) - 1,
+            std::max(prev.y, next.y) + 1,
+        };
+        const Segment2s64 cells { prev, next };
+        expect_cursor_same_as_index<Ascending, Ascending>(index, cursor, rectangle, cells);
+        expect_cursor_same_as_index<Ascending, Descending>(index, cursor, rectangle, cells);
+        expect_cursor_same_as_index<Descending, Ascending>(index, cursor, rectangle, cells);
+        expect_cursor_same_as_index<Descending, Descending>(index, cursor, rectangle, cells);
+        prev = next;
+    }
+}
+
+TEST(HotPixelIndexTest, tiled_snap_round)
+{
+    const auto grid = make_grid<GridRounding::Cell>(1.1, { 3, -5 }, 8);
+
+    std::mt19937_64 random { 42 };
+    std::uniform_real_distribution<f64> coordinate { -100.0, 100.0 };
+    std::vector<std::vector<Vec2f64>> polylines(20);
+    HotPixelCollector collector;
+    for (auto & polyline : polylines)
+    {
+        for (size_t i = 0; i < 10; ++i)
+        {
+            polyline.push_back({ coordinate(random), coordinate(random) });
+        }
+        collector.add_tile_snapped_polyline(grid, polyline);
+    }
+    const auto & index = collector.build_index();
+    const auto & tiled_index = collector.build_tiled_index(grid.tiles());
+
+    for (const auto & polyline : polylines)
+    {
+        std::vector<Vec2s64> expected;
+        std::vector<Vec2s64> result;
+        snap_round(grid, index, polyline, std::back_inserter(expected));
+        snap_round(grid, tiled_index, polyline, std::back_inserter(result));
+        EXPECT_THAT(result, ElementsAreArray(expected));
+    }
+}
+
+TEST(HotPixelIndexTest, rebuild_keeps_collected_pixels)
+{
+    const auto grid = make_grid<GridRounding::NearestNode>(1.0, {}, 8);
+    const Rectangle rectangle { -100, 100, -100, 100 };
+
+    HotPixelCollector collector;
+    std::vector<Vec2s64> pixels;
+    const auto add = [&](const std::vector<Vec2s64> & new_pixels)
+    {
+        for (const auto & pixel : new_pixels)
+        {
+            const std::array<Vec2f64, 1> point { { { static_cast<f64>(pixel.x), static_cast<f64>(pixel.y) } } };
+            collector.add_tile_snapped_polyline(grid, point);
+            pixels.push_back(pixel);
+        }
+    };
+
+    using enum HotPixelOrder;
+    add({ { 1, 2 }, { 5, -3 }, { 20, 7 }, { -9, 0 } });
+    expect_same_as_brute_force<Ascending, Ascending>(collector.build_index(), pixels, rectangle);
+    add({ { 4, 4 }, { -30, 11 }, { 17, -50 } });
+    expect_same_as_brute_force<Ascending, Ascending>(collector.build_tiled_index(grid.tiles()), pixels, rectangle);
+    expect_same_as_brute_force<Ascending, Ascending>(collector.build_index(), pixels, rectangle);
+
+    const auto & index = collector.build_index();
+    const auto & tiled_index = collector.build_tiled_index(grid.tiles());
+    collector.release_hot_pixels();
+    expect_same_as_brute_force<Ascending, Ascending>(index, pixels, rectangle);
+    expect_same_as_brute_force<Ascending, Ascending>(tiled_index, pixels, rectangle);
+}
+
+} // namespace ka
@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <iterator>
+#include <random>
+#include <ranges>
+#include <vector>
+
+#include <ka/common/fixed.hpp>
+#include <ka/geometry_types/MultiPolygon2.hpp>
+#include <ka/geometry_types/Vec2.hpp>
+#include <ka/tilecut/HotPixelCollector.hpp>
+#include <ka/tilecut/TileCellGrid.hpp>
+#include <ka/tilecut/snap_round.hpp>
+
+#include "debug_output.hpp"
+#include "mock_grid_parameters.hpp"
+
+namespace ka
+{
+
+using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
+
+inline namespace
+{
+
+template <std::ranges::input_range R>
+[[nodiscard]] std::vector<std::ranges::range_value_t<R>> to_vector(R && range)
+{
+    return { std::ranges::begin(range), std::ranges::end(range) };
+}
+
+} // namespace
+
+static_assert(std::ranges::random_access_range<MultiPolygon2f64::RingView>);
+static_assert(std::ranges::sized_range<MultiPolygon2f64::RingView>);
+static_assert(std::same_as<std::ranges::range_value_t<MultiPolygon2f64::RingView>, Vec2f64>);
+
+TEST(MultiPolygonTest, offsets)
+{
+    MultiPolygon2s64 geometry;
+    geometry.add_part();
+    geometry.add_ring(std::vector<Vec2s64> { { 0, 0 }, { 4, 0 }, { 0, 4 }, { 0, 0 } });
+    geometry.add_ring(std::vector<Vec2s64> { { 1, 1 }, { 1, 2 }, { 2, 1 }, { 1, 1 } });
+    geometry.add_part();
+    geometry.add_part();
+    geometry.add_ring();
+    geometry.add_point({ 10, 10 });
+    geometry.add_point({ 11, 12 });
+
+    EXPECT_EQ(geometry.part_count(), 3);
+    EXPECT_EQ(geometry.ring_count(), 3);
+    EXPECT_EQ(geometry.point_count(), 10);
+    EXPECT_THAT(to_vector(geometry.part_offsets()), ElementsAre(0, 2, 2, 3));
+    EXPECT_THAT(to_vector(geometry.ring_offsets()), ElementsAre(0, 4, 8, 10));
+    EXPECT_THAT(to_vector(geometry.part_rings(0)), ElementsAre(0, 1));
+    EXPECT_TRUE(geometry.part_rings(1).empty());
+    EXPECT_THAT(to_vector(geometry.ring_xs(1)), ElementsAre(1, 1, 2, 1));
+    EXPECT_THAT(to_vector(geometry.ring_ys(2)), ElementsAre(10, 12));
+    EXPECT_THAT(to_vector(geometry.ring(2)), ElementsAre(Vec2s64 { 10, 10 }, Vec2s64 { 11, 12 }));
+
+    geometry.clear();
+    EXPECT_EQ(geometry.part_count(), 0);
+    EXPECT_EQ(geometry.ring_count(), 0);
+    EXPECT_EQ(geometry.point_count(), 0);
+}
+
+TEST(MultiPolygonTest, snap_round_same_as_nested_vectors)
+{
+    const auto grid = make_grid<GridRounding::NearestNode>(1.1, {}, 8);
+
+    std::mt19937_64 random { 42 };
+    std::uniform_real_distribution<f64> coordinate { -50.0, 50.0 };
+    std::uniform_int_distribution<size_t> ring_size { 2, 10 };
+
+    std::vector<std::vector<Vec2f64>> rings;
+    MultiPolygon2f64 geometry;
+    for (size_t part = 0; part < 20; ++part)
+    {
+        geometry.add_part();
+        for (size_t ring = 0; ring < part % 3; ++ring)
+        {
+            auto & points = rings.emplace_back(ring_size(random));
+            std::ranges::generate(
+                points,
+                [&]
+                {
+                    return Vec2f64 { coordinate(random), coordinate(random) };
+                });
+            points.push_back(points.front());
+            geometry.add_ring(points);
+        }
+    }
+    ASSERT_EQ(geometry.ring_count(), rings.size());
+
+    HotPixelCollector nested_collector;
+    HotPixelCollector flat_collector;
+    for (size_t i = 0; i < rings.size(); ++i)
+    {
+        nested_collector.add_tile_snapped_polyline(grid, rings[i]);
+        flat_collector.add_tile_snapped_polyline(grid, geometry.ring(i));
+    }
+    const auto & nested_index = nested_collector.build_index();
+    const auto & flat_index = flat_collector.build_index();
+
+    std::vector<Vec2s64> expected;
+    std::vector<Vec2s64> result;
+    for (size_t i = 0; const auto ring : geometry.rings())
+    {
+        expected.clear();
+        result.clear();
+        snap_round(grid, nested_index, rings[i], std::back_inserter(expected));
+        snap_round(grid, flat_index, ring, std::back_inserter(result));
+        ASSERT_THAT(result, ElementsAreArray(expected)) << i;
+        ++i;
+    }
+}
+
+} // namespace ka
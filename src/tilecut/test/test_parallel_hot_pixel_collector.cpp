@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <iterator>
+#include <limits>
+#include <random>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include <ka/common/fixed.hpp>
+#include <ka/geometry_types/Vec2.hpp>
+#include <ka/tilecut/HotPixelCollector.hpp>
+#include <ka/tilecut/HotPixelIndex.hpp>
+#include <ka/tilecut/HotPixelOrder.hpp>
+#include <ka/tilecut/ParallelHotPixelCollector.hpp>
+#include <ka/tilecut/snap_round.hpp>
+
+#include "debug_output.hpp"
+#include "mock_grid_parameters.hpp"
+
+namespace ka
+{
+
+using ::testing::ElementsAreArray;
+
+inline namespace
+{
+
+[[nodiscard]] std::vector<Vec2s64> all_pixels(const HotPixelIndex & index)
+{
+    constexpr auto min = std::numeric_limits<s64>::min();
+    constexpr auto max = std::numeric_limits<s64>::max();
+    std::vector<Vec2s64> pixels;
+    std::ignore = index.find_if<HotPixelOrder::Ascending, HotPixelOrder::Ascending>(
+        min,
+        max,
+        min,
+        max,
+        std::back_inserter(pixels),
+        [](const Vec2s64 &)
+        {
+            return true;
+        });
+    return pixels;
+}
+
+} // namespace
+
+TEST(ParallelHotPixelCollectorTest, same_as_single_collector)
+{
+    const auto grid = make_grid<GridRounding::NearestNode>(1.0, {}, 16);
+
+    std::mt19937_64 random { 42 };
+    std::uniform_real_distribution<f64> coordinate { -300.0, 300.0 };
+    std::vector<std::vector<Vec2f64>> polylines(50);
+    for (auto & polyline : polylines)
+    {
+        for (size_t i = 0; i < 20; ++i)
+        {
+            polyline.push_back({ coordinate(random), coordinate(random) });
+        }
+    }
+
+    HotPixelCollector collector;
+    for (const auto & polyline : polylines)
+    {
+        collector.add_tile_snapped_polyline(grid, polyline);
+        // Duplicates of other shards are removed.
+        collector.add_tile_snapped_polyline(grid, polyline);
+    }
+    const auto & expected_index = collector.build_index();
+    const auto expected_pixels = all_pixels(expected_index);
+
+    for (const size_t shard_count : { 1, 3, 8, 64 })
+    {
+        ParallelHotPixelCollector parallel_collector { shard_count };
+        for (size_t repetition = 0; repetition < 2; ++repetition)
+        {
+            std::vector<std::jthread> threads;
+            for (size_t shard = 0; shard < shard_count; ++shard)
+            {
+                threads.emplace_back(
+                    [&, shard]
+                    {
+                        for (auto i = (shard + repetition) % shard_count; i < polylines.size(); i += shard_count)
+                        {
+                            parallel_collector.shard(shard).add_tile_snapped_polyline(grid, polylines[i]);
+                        }
+                    });
+            }
+        }
+        EXPECT_THAT(all_pixels(parallel_collector.build_index()), ElementsAreArray(expected_pixels)) << shard_count;
+        // Building again gives the same index, and it stays valid once the collected pixels are released.
+        const auto & index = parallel_collector.build_index();
+        parallel_collector.release_hot_pixels();
+        EXPECT_THAT(all_pixels(index), ElementsAreArray(expected_pixels)) << shard_count;
+
+        for (const auto & polyline : polylines)
+        {
+            std::vector<Vec2s64> expected;
+            std::vector<Vec2s64> result;
+            snap_round(grid, expected_index, polyline, std::back_inserter(expected));
+            snap_round(grid, index, polyline, std::back_inserter(result));
+            ASSERT_THAT(result, ElementsAreArray(expected)) << shard_count;
+        }
+    }
+}
+
+} // namespace ka
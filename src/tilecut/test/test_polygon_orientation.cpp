@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 
 #include <cmath>
+#include <limits>
 #include <ranges>
 #include <vector>
 
@@ -111,4 +112,30 @@ TEST(PolygonOrientationTest, multiple_touchpoints)
     EXPECT_EQ(polygon_orientation(to_segments(contour)), PolygonOrientation::CounterClockwise);
 }
 
+TEST(PolygonOrientationTest, large_integer_coordinates)
+{
+    // Differences of the coordinates do not fit into s64, and the triangle is almost degenerate.
+    constexpr auto min = std::numeric_limits<s64>::min(), max = std::numeric_limits<s64>::max();
+    std::vector<Vec2s64> contour {
+        { min, min },
+        { max - 1, min + 1 },
+        { max, min + 2 },
+        { min, min },
+    };
+    EXPECT_EQ(contour_orientation(contour), PolygonOrientation::CounterClockwise);
+    EXPECT_EQ(polygon_orientation(to_segments(contour)), PolygonOrientation::CounterClockwise);
+    std::ranges::reverse(contour);
+    EXPECT_EQ(contour_orientation(contour), PolygonOrientation::Clockwise);
+    EXPECT_EQ(polygon_orientation(to_segments(contour)), PolygonOrientation::Clockwise);
+
+    std::vector<Vec2s32> small_contour {
+        { std::numeric_limits<s32>::min(), 0 },
+        { std::numeric_limits<s32>::max(), -1 },
+        { std::numeric_limits<s32>::max(), 1 },
+        { std::numeric_limits<s32>::min(), 0 },
+    };
+    EXPECT_EQ(contour_orientation(small_contour), PolygonOrientation::CounterClockwise);
+    EXPECT_EQ(polygon_orientation(to_segments(small_contour)), PolygonOrientation::CounterClockwise);
+}
+
 } // namespace ka
@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <ka/common/fixed.hpp>
+#include <ka/geometry_types/Segment2.hpp>
+#include <ka/geometry_types/Vec2.hpp>
+#include <ka/tilecut/TileCellGrid.hpp>
+#include <ka/tilecut/collect_tiles.hpp>
+#include <ka/tilecut/radix_sort.hpp>
+
+#include "debug_output.hpp"
+#include "mock_grid_parameters.hpp"
+
+namespace ka
+{
+
+using ::testing::ElementsAreArray;
+using ::testing::UnorderedElementsAreArray;
+
+inline namespace
+{
+
+[[nodiscard]] std::vector<Vec2s64> random_points(
+    std::mt19937_64 & random,
+    const size_t count,
+    const s64 min,
+    const s64 max)
+{
+    std::uniform_int_distribution<s64> coordinate { min, max };
+    std::vector<Vec2s64> points;
+    for (size_t i = 0; i < count; ++i)
+    {
+        points.push_back({ coordinate(random), coordinate(random) });
+    }
+    return points;
+}
+
+} // namespace
+
+TEST(RadixSortTest, same_as_comparison)
+{
+    constexpr auto min = std::numeric_limits<s64>::min();
+    constexpr auto max = std::numeric_limits<s64>::max();
+
+    std::mt19937_64 random { 42 };
+    for (const auto & [from, to] : { std::pair { min, max }, { -300, 300 }, { 1000, 1010 }, { s64 { 1 } << 40, max } })
+    {
+        for (const size_t count : { 0, 1, 2, 100, 10000 })
+        {
+            auto points = random_points(random, count, from, to);
+            if (count > 2)
+            {
+                points[0] = { min, max };
+                points[1] = { max, min };
+                points[2] = { -1, 0 };
+            }
+
+            auto expected = points;
+            std::ranges::sort(expected);
+            radix_sort(points);
+            ASSERT_THAT(points, ElementsAreArray(expected)) << from << ' ' << to << ' ' << count;
+        }
+    }
+}
+
+TEST(RadixSortTest, stable)
+{
+    std::mt19937_64 random { 42 };
+    auto points = random_points(random, 10000, -10, 10);
+    for (auto & point : points)
+    {
+        point.y = static_cast<s64>(random() % 1000);
+    }
+
+    const auto key = [](const Vec2s64 & point)
+    {
+        return RadixKey<1> { point.x };
+    };
+    auto expected = points;
+    std::ranges::stable_sort(expected, {}, &Vec2s64::x);
+    sort_by_key(points, key, SortPolicy::Radix);
+    EXPECT_THAT(points, ElementsAreArray(expected));
+}
+
+TEST(RadixSortTest, collect_tiles_same_as_comparison)
+{
+    const auto grid = make_grid<GridRounding::NearestNode>(1.0, {}, 16);
+
+    std::mt19937_64 random { 42 };
+    std::uniform_int_distribution<s64> tile_coordinate { -50, 50 };
+    std::uniform_int_distribution<s64> local_coordinate { 0, 16 };
+    std::vector<Segment2s64> segments;
+    while (segments.size() < 1000)
+    {
+        const Vec2s64 origin { tile_coordinate(random) * 16, tile_coordinate(random) * 16 };
+        const Segment2s64 segment {
+            { origin.x + local_coordinate(random), origin.y + local_coordinate(random) },
+            { origin.x + local_coordinate(random), origin.y + local_coordinate(random) },
+        };
+        if (segment.a != segment.b)
+        {
+            segments.push_back(segment);
+        }
+    }
+
+    auto comparison_input = segments;
+    std::vector<Segment2u16> comparison_segments;
+    std::vector<Tile> comparison_tiles;
+    collect_tiles(
+        grid.tiles(),
+        comparison_input,
+        comparison_segments,
+        comparison_tiles,
+        TileOrder::Coordinates,
+        SortPolicy::Comparison);
+
+    auto radix_input = segments;
+    std::vector<Segment2u16> radix_segments;
+    std::vector<Tile> radix_tiles;
+    collect_tiles(grid.tiles(), radix_input, radix_segments, radix_tiles, TileOrder::Coordinates, SortPolicy::Radix);
+
+    // Only the order of segments within a tile may differ, since std::ranges::sort is not stable.
+    ASSERT_EQ(radix_tiles.size(), comparison_tiles.size());
+    for (size_t i = 0; i < radix_tiles.size(); ++i)
+    {
+        ASSERT_EQ(radix_tiles[i].tile, comparison_tiles[i].tile);
+        const std::vector<Segment2u16> expected { comparison_tiles[i].segments.begin(),
+                                                  comparison_tiles[i].segments.end() };
+        const std::vector<Segment2u16> result { radix_tiles[i].segments.begin(), radix_tiles[i].segments.end() };
+        EXPECT_THAT(result, UnorderedElementsAreArray(expected)) << radix_tiles[i].tile;
+    }
+}
+
+} // namespace ka
@@ -5,10 +5,14 @@
 #include <cmath>
 #include <concepts>
 #include <iterator>
+#include <random>
 #include <vector>
 
+#include <ka/common/cast.hpp>
+#include <ka/common/fixed.hpp>
 #include <ka/geometry_types/Vec2.hpp>
 #include <ka/tilecut/HotPixelCollector.hpp>
+#include <ka/tilecut/IntegerTileCellGrid.hpp>
 #include <ka/tilecut/TileCellGrid.hpp>
 #include <ka/tilecut/snap_round.hpp>
 
@@ -210,4 +214,72 @@ TEST(SnapRoundingTest, half_integer_perfect_square)
     EXPECT_THAT(result, ElementsAreArray(expected));
 }
 
+TEST(SnapRoundingTest, integer_same_as_floating_point)
+{
+    // Cell size 5 / 4 is exact in both representations.
+    const auto grid = make_grid<GridRounding::Cell>(1.25, {}, 8);
+    const IntegerTileCellGrid<GridRounding::Cell> integer_grid {
+        { .cell_size_numerator = 5, .cell_size_denominator = 4 },
+        {},
+        8,
+    };
+
+    std::mt19937_64 random { 42 };
+    std::uniform_int_distribution<s64> coordinate { -100, 100 };
+
+    std::vector<Vec2s64> integer_geometry;
+    std::vector<Vec2f64> geometry;
+    for (size_t i = 0; i < 100; ++i)
+    {
+        const Vec2s64 vertex { coordinate(random), coordinate(random) };
+        integer_geometry.push_back(vertex);
+        geometry.push_back({ exact_cast<f64>(vertex.x), exact_cast<f64>(vertex.y) });
+    }
+
+    HotPixelCollector collector;
+    collector.add_tile_snapped_polyline(grid, geometry);
+    std::vector<Vec2s64> expected;
+    snap_round(grid, collector.build_index(), geometry, std::back_inserter(expected));
+
+    HotPixelCollector integer_collector;
+    integer_collector.add_tile_snapped_polyline(integer_grid, integer_geometry);
+    std::vector<Vec2s64> result;
+    snap_round(integer_grid, integer_collector.build_index(), integer_geometry, std::back_inserter(result));
+
+    EXPECT_THAT(result, ElementsAreArray(expected));
+}
+
+TEST(SnapRoundingTest, static_grid_same_as_dynamic)
+{
+    constexpr auto static_grid = []
+    {
+        auto grid = g_embedded_grid;
+        grid.cell_size = 0.5;
+        return grid;
+    }();
+    const auto grid = make_grid<GridRounding::NearestNode>(static_grid.cell_size, {}, 8);
+    const TileCellGrid<GridRounding::NearestNode, static_grid> fixed_grid { {}, 8 };
+
+    std::mt19937_64 random { 42 };
+    std::uniform_real_distribution<f64> coordinate { -50.0, 50.0 };
+
+    std::vector<Vec2f64> geometry;
+    for (size_t i = 0; i < 100; ++i)
+    {
+        geometry.push_back({ coordinate(random), coordinate(random) });
+    }
+
+    HotPixelCollector collector;
+    collector.add_tile_snapped_polyline(grid, geometry);
+    std::vector<Vec2s64> expected;
+    snap_round(grid, collector.build_index(), geometry, std::back_inserter(expected));
+
+    HotPixelCollector fixed_collector;
+    fixed_collector.add_tile_snapped_polyline(fixed_grid, geometry);
+    std::vector<Vec2s64> result;
+    snap_round(fixed_grid, fixed_collector.build_index(), geometry, std::back_inserter(result));
+
+    EXPECT_THAT(result, ElementsAreArray(expected));
+}
+
 } // namespace ka
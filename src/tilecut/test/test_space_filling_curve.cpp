@@ -0,0 +1,200 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <ka/common/fixed.hpp>
+#include <ka/geometry_types/Segment2.hpp>
+#include <ka/geometry_types/Vec2.hpp>
+#include <ka/geometry_types/space_filling_curve.hpp>
+#include <ka/tilecut/HotPixelCollector.hpp>
+#include <ka/tilecut/collect_tiles.hpp>
+#include <ka/tilecut/filter_segments.hpp>
+#include <ka/tilecut/snap_round.hpp>
+#include <ka/tilecut/sort_features_along_curve.hpp>
+
+#include "debug_output.hpp"
+#include "mock_grid_parameters.hpp"
+
+namespace ka
+{
+
+using ::testing::ElementsAre;
+using ::testing::UnorderedElementsAreArray;
+
+inline namespace
+{
+
+[[nodiscard]] std::vector<Vec2s64> square(const s64 min, const s64 size)
+{
+    std::vector<Vec2s64> points;
+    for (s64 y = min; y < min + size; ++y)
+    {
+        for (s64 x = min; x < min + size; ++x)
+        {
+            points.push_back({ x, y });
+        }
+    }
+    return points;
+}
+
+} // namespace
+
+TEST(SpaceFillingCurveTest, morton_order)
+{
+    auto points = square(0, 2);
+    std::ranges::reverse(points);
+    sort_along_curve(points, SpaceFillingCurve::Morton);
+    EXPECT_THAT(points, ElementsAre(Vec2s64 { 0, 0 }, Vec2s64 { 1, 0 }, Vec2s64 { 0, 1 }, Vec2s64 { 1, 1 }));
+
+    // Morton keys are monotonic in both coordinates.
+    constexpr auto min = std::numeric_limits<s64>::min();
+    constexpr auto max = std::numeric_limits<s64>::max();
+    std::mt19937_64 random { 42 };
+    std::uniform_int_distribution<s64> coordinate { min, max };
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        const Vec2s64 a { coordinate(random), coordinate(random) };
+        const Vec2s64 b { coordinate(random), coordinate(random) };
+        const Vec2s64 lower { std::min(a.x, b.x), std::min(a.y, b.y) };
+        const Vec2s64 upper { std::max(a.x, b.x), std::max(a.y, b.y) };
+        EXPECT_LE(morton_key(lower), morton_key(upper)) << lower << upper;
+    }
+    EXPECT_LT(morton_key({ -1, -1 }), morton_key({ 0, 0 }));
+    EXPECT_EQ(morton_key({ min, min }), (CurveKey { 0, 0 }));
+    EXPECT_EQ(morton_key({ max, max }), (CurveKey { ~u64 { 0 }, ~u64 { 0 } }));
+}
+
+TEST(SpaceFillingCurveTest, hilbert_neighbours)
+{
+    // The Hilbert curve passes through every aligned square block without leaving it.
+    for (const auto min : { s64 { 0 }, s64 { -16 }, s64 { 1 } << 40 })
+    {
+        auto points = square(min, 16);
+        std::ranges::shuffle(points, std::mt19937_64 { 42 });
+        sort_along_curve(points, SpaceFillingCurve::Hilbert);
+        for (size_t i = 1; i < points.size(); ++i)
+        {
+            EXPECT_EQ(std::abs(points[i].x - points[i - 1].x) + std::abs(points[i].y - points[i - 1].y), 1)
+                << points[i - 1] << points[i];
+            EXPECT_LT(hilbert_key(points[i - 1]), hilbert_key(points[i]));
+        }
+    }
+}
+
+TEST(SpaceFillingCurveTest, collect_tiles_along_curve)
+{
+    const auto grid = make_grid<GridRounding::NearestNode>(1.0, {}, 16);
+
+    std::mt19937_64 random { 42 };
+    std::uniform_real_distribution<f64> coordinate { -200.0, 200.0 };
+    std::vector<Vec2f64> contour;
+    for (size_t i = 0; i < 30; ++i)
+    {
+        contour.push_back({ coordinate(random), coordinate(random) });
+    }
+    contour.push_back(contour.front());
+
+    HotPixelCollector collector;
+    collector.add_tile_snapped_polyline(grid, contour);
+    const auto & hot_pixels = collector.build_index();
+    std::vector<Vec2s64> points;
+    snap_round(grid, hot_pixels, contour, std::back_inserter(points));
+    std::vector<Segment2s64> segments;
+    for (size_t i = 1; i < points.size(); ++i)
+    {
+        segments.push_back({ points[i - 1], points[i] });
+    }
+    filter_segments(segments);
+    ASSERT_FALSE(segments.empty());
+
+    std::vector<Segment2u16> tile_segments;
+    std::vector<Tile> tiles;
+    collect_tiles(grid.tiles(), segments, tile_segments, tiles);
+
+    for (const auto order : { TileOrder::Morton, TileOrder::Hilbert })
+    {
+        const auto curve = order == TileOrder::Morton ? SpaceFillingCurve::Morton : SpaceFillingCurve::Hilbert;
+
+        std::vector<Segment2u16> curve_segments;
+        std::vector<Tile> curve_tiles;
+        collect_tiles(grid.tiles(), segments, curve_segments, curve_tiles, order);
+        ASSERT_EQ(curve_tiles.size(), tiles.size());
+        EXPECT_TRUE(std::ranges::is_sorted(
+            curve_tiles,
+            {},
+            [&](const Tile & tile)
+            {
+                return curve_key(curve, tile.tile);
+            }));
+        for (const auto & tile : curve_tiles)
+        {
+            const auto expected = std::ranges::find(tiles, tile.tile, &Tile::tile);
+            ASSERT_NE(expected, tiles.end()) << tile.tile;
+            const std::vector<Segment2u16> tile_segments_vector { tile.segments.begin(), tile.segments.end() };
+            EXPECT_THAT(tile_segments_vector, UnorderedElementsAreArray(expected->segments));
+        }
+
+        std::vector<u8> tile_bytes;
+        std::vector<CompactTile> compact_tiles;
+        collect_tiles(grid.tiles(), segments, tile_bytes, compact_tiles, order);
+        ASSERT_EQ(compact_tiles.size(), curve_tiles.size());
+        for (size_t i = 0; i < curve_tiles.size(); ++i)
+        {
+            EXPECT_EQ(compact_tiles[i].tile, curve_tiles[i].tile);
+        }
+    }
+}
+
+TEST(SpaceFillingCurveTest, sort_features)
+{
+    const auto grid = make_grid<GridRounding::NearestNode>(1.0, {}, 16);
+
+    std::mt19937_64 random { 42 };
+    std::uniform_real_distribution<f64> coordinate { -500.0, 500.0 };
+    std::uniform_real_distribution<f64> offset { -10.0, 10.0 };
+    std::vector<std::vector<Vec2f64>> features(100);
+    for (auto & feature : features)
+    {
+        const Vec2f64 center { coordinate(random), coordinate(random) };
+        for (size_t i = 0; i < 5; ++i)
+        {
+            feature.push_back({ center.x + offset(random), center.y + offset(random) });
+        }
+    }
+    features.emplace_back();
+
+    auto sorted = features;
+    sort_features_along_curve(grid, sorted, SpaceFillingCurve::Hilbert);
+    EXPECT_THAT(sorted, UnorderedElementsAreArray(features));
+    EXPECT_TRUE(std::ranges::is_sorted(
+        sorted,
+        {},
+        [&](const auto & feature)
+        {
+            return hilbert_key(feature_tile(grid, feature));
+        }));
+
+    // Features can be reordered by their indices.
+    std::vector<size_t> indices(features.size());
+    std::iota(indices.begin(), indices.end(), size_t { 0 });
+    sort_features_along_curve(
+        grid,
+        indices,
+        SpaceFillingCurve::Hilbert,
+        [&](const size_t i) -> const std::vector<Vec2f64> &
+        {
+            return features[i];
+        });
+    for (size_t i = 0; i < indices.size(); ++i)
+    {
+        EXPECT_EQ(features[indices[i]], sorted[i]) << i;
+    }
+}
+
+} // namespace ka
@@ -3,11 +3,14 @@
 
 #include <algorithm>
 #include <iterator>
+#include <random>
 #include <vector>
 
+#include <ka/common/cast.hpp>
 #include <ka/common/fixed.hpp>
 #include <ka/exact/GridParameters.hpp>
 #include <ka/exact/GridRounding.hpp>
+#include <ka/exact/grid.hpp>
 #include <ka/geometry_types/Segment2.hpp>
 #include <ka/geometry_types/Vec2.hpp>
 #include <ka/tilecut/TileCellGrid.hpp>
@@ -39,6 +42,103 @@ TEST(TileCellGridTest, cell_of)
     EXPECT_EQ(grid.cell_of(point), expected);
 }
 
+template <GridRounding rounding>
+void check_batch_cell_of(const f64 cell_size)
+{
+    const auto grid = make_grid<rounding>(cell_size, {}, g_tile_size);
+
+    std::mt19937_64 random { 42 };
+    std::uniform_real_distribution<f64> coordinate { -1e6, 1e6 };
+    std::uniform_int_distribution<s64> node { -100000, 100000 };
+
+    std::vector<Vec2f64> points;
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        points.push_back({ coordinate(random), coordinate(random) });
+        // Points on the grid lines and between them have integer quotients.
+        const auto half_cell = cell_size / 2.0;
+        points.push_back({ exact_cast<f64>(node(random)) * cell_size, exact_cast<f64>(node(random)) * half_cell });
+        points.push_back({ exact_cast<f64>(node(random)) * half_cell, coordinate(random) });
+    }
+
+    std::vector<Vec2s64> cells(points.size());
+    grid.cell_of(points, cells);
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+        ASSERT_EQ(cells[i], grid.cell_of(points[i])) << points[i];
+    }
+}
+
+TEST(TileCellGridTest, batch_cell_of)
+{
+    check_batch_cell_of<GridRounding::Cell>(g_cell_size);
+    check_batch_cell_of<GridRounding::Cell>(0.1);
+    check_batch_cell_of<GridRounding::NearestNode>(g_cell_size);
+    check_batch_cell_of<GridRounding::NearestNode>(0.1);
+}
+
+inline namespace
+{
+
+[[nodiscard]] constexpr GridParameters embedded_grid_with_cell_size(const f64 cell_size)
+{
+    auto grid = g_embedded_grid;
+    grid.cell_size = cell_size;
+    return grid;
+}
+
+} // namespace
+
+static_assert(!TileCellGrid<GridRounding::Cell>::has_static_grid);
+static_assert(!TileCellGrid<GridRounding::Cell, g_embedded_grid>::power_of_two_cell_size);
+static_assert(TileCellGrid<GridRounding::Cell, embedded_grid_with_cell_size(1.0)>::power_of_two_cell_size);
+
+template <GridRounding rounding, GridParameters static_grid>
+void check_static_grid_cell_of()
+{
+    const TileCellGrid<rounding, static_grid> grid { {}, g_tile_size };
+    const TileCellGrid<rounding> dynamic_grid { static_grid, {}, g_tile_size };
+    static_assert(decltype(grid)::has_static_grid);
+    EXPECT_EQ(&grid.grid(), &static_grid);
+
+    std::mt19937_64 random { 42 };
+    std::uniform_real_distribution<f64> coordinate { -1e6, 1e6 };
+    std::uniform_int_distribution<s64> node { -100000, 100000 };
+
+    std::vector<Vec2f64> points { { 0.0, -0.0 } };
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        points.push_back({ coordinate(random), coordinate(random) });
+        const auto half_cell = static_grid.cell_size / 2.0;
+        points.push_back({
+            exact_cast<f64>(node(random)) * static_grid.cell_size,
+            exact_cast<f64>(node(random)) * half_cell,
+        });
+        points.push_back({ -g_embedded_grid.min_input, g_embedded_grid.min_input });
+    }
+
+    std::vector<Vec2s64> cells(points.size());
+    grid.cell_of(points, cells);
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+        const auto expected = dynamic_grid.cell_of(points[i]);
+        ASSERT_EQ(grid.cell_of(points[i]), expected) << points[i];
+        ASSERT_EQ(cells[i], expected) << points[i];
+    }
+}
+
+TEST(TileCellGridTest, static_grid_cell_of)
+{
+    check_static_grid_cell_of<GridRounding::Cell, embedded_grid_with_cell_size(1.0)>();
+    check_static_grid_cell_of<GridRounding::Cell, embedded_grid_with_cell_size(0x1p-3)>();
+    check_static_grid_cell_of<GridRounding::Cell, embedded_grid_with_cell_size(0x1p+4)>();
+    check_static_grid_cell_of<GridRounding::Cell, embedded_grid_with_cell_size(0.1)>();
+    check_static_grid_cell_of<GridRounding::NearestNode, embedded_grid_with_cell_size(1.0)>();
+    check_static_grid_cell_of<GridRounding::NearestNode, embedded_grid_with_cell_size(0x1p-3)>();
+    check_static_grid_cell_of<GridRounding::NearestNode, embedded_grid_with_cell_size(0x1p+4)>();
+    check_static_grid_cell_of<GridRounding::NearestNode, embedded_grid_with_cell_size(0.1)>();
+}
+
 TEST(TileCellGridTest, tile_boundary_intersection_cells)
 {
     const auto grid = make_grid<GridRounding::NearestNode>(g_cell_size, {}, g_tile_size);
@@ -137,4 +237,66 @@ TEST(TileCellGridTest, tile_boundary_intersection_cells_same_cell)
     EXPECT_EQ(result, expected);
 }
 
+template <GridRounding rounding>
+void check_long_segments_boundary_intersection_cells(const f64 cell_size)
+{
+    const auto grid = make_grid<rounding>(cell_size, { -7, 13 }, g_tile_size);
+
+    std::mt19937_64 random { 42 };
+    std::uniform_real_distribution<f64> coordinate { -1e5 * cell_size, 1e5 * cell_size };
+
+    for (size_t i = 0; i < 100; ++i)
+    {
+        const Segment2f64 segment {
+            { coordinate(random), coordinate(random) },
+            { coordinate(random), coordinate(random) },
+        };
+        const Segment2s64 segment_cells { grid.cell_of(segment.a), grid.cell_of(segment.b) };
+
+        std::vector<Vec2s64> result;
+        grid.tile_boundary_intersection_cells(segment, segment_cells, std::back_inserter(result));
+
+        // Each boundary is processed independently.
+        std::vector<Vec2s64> expected;
+        const auto [min_x, max_x, min_y, max_y] = grid.tiles().intersected_boundaries_ranges(segment_cells);
+        for (auto x = min_x; x <= max_x; x += g_tile_size)
+        {
+            if (border_between_coordinates(grid.cell_size(), segment.a.x, segment.b.x, x))
+            {
+                const auto y = column_border_intersection<rounding>(
+                    grid.grid(),
+                    segment.a.x,
+                    segment.a.y,
+                    segment.b.x,
+                    segment.b.y,
+                    x);
+                expected.push_back({ x, y });
+            }
+        }
+        for (auto y = min_y; y <= max_y; y += g_tile_size)
+        {
+            if (border_between_coordinates(grid.cell_size(), segment.a.y, segment.b.y, y))
+            {
+                const auto x = row_border_intersection<rounding>(
+                    grid.grid(),
+                    segment.a.x,
+                    segment.a.y,
+                    segment.b.x,
+                    segment.b.y,
+                    y);
+                expected.push_back({ x, y });
+            }
+        }
+        ASSERT_EQ(result, expected);
+    }
+}
+
+TEST(TileCellGridTest, tile_boundary_intersection_cells_long_segments)
+{
+    check_long_segments_boundary_intersection_cells<GridRounding::Cell>(g_cell_size);
+    check_long_segments_boundary_intersection_cells<GridRounding::Cell>(0.1);
+    check_long_segments_boundary_intersection_cells<GridRounding::NearestNode>(g_cell_size);
+    check_long_segments_boundary_intersection_cells<GridRounding::NearestNode>(0.1);
+}
+
 } // namespace ka
@@ -2,6 +2,7 @@
 #include <vector>
 
 #include <ka/exact/GridRounding.hpp>
+#include <ka/geometry_types/MultiPolygon2.hpp>
 #include <ka/geometry_types/Segment2.hpp>
 #include <ka/tilecut/HotPixelCollector.hpp>
 #include <ka/tilecut/TileCellGrid.hpp>
@@ -11,24 +12,31 @@
 #include <ka/tilecut/snap_round.hpp>
 #include <ka_test/grid.hpp>
 
-int main(int argc, char * argv[])
+// The grid is known at compile time and its cell size is a power of two, so points are rounded without division.
+constexpr auto g_grid_params = []
 {
     auto grid_params = ka::g_embedded_grid;
     grid_params.cell_size = 1.0;
+    return grid_params;
+}();
+
+int main(int argc, char * argv[])
+{
     const ka::u16 tile_size = 10000;
-    ka::TileCellGrid<ka::GridRounding::NearestNode> grid(grid_params, {}, tile_size);
+    ka::TileCellGrid<ka::GridRounding::NearestNode, g_grid_params> grid({}, tile_size);
 
-    // Input geometry.
-    std::vector<std::vector<ka::Vec2f64>> contours = {
-        { { 50, 50.01 }, { 100, 100 }, { 50, 50.01 } },
-        { { 1000, 1000 }, { 2000, 1000 }, { 1500, 2000 }, { 1000, 1000 } },
-    };
+    // Input geometry. All rings are stored in the same flat arrays.
+    ka::MultiPolygon2f64 contours;
+    contours.add_part();
+    contours.add_ring(std::vector<ka::Vec2f64> { { 50, 50.01 }, { 100, 100 }, { 50, 50.01 } });
+    contours.add_part();
+    contours.add_ring(std::vector<ka::Vec2f64> { { 1000, 1000 }, { 2000, 1000 }, { 1500, 2000 }, { 1000, 1000 } });
 
     // Collect all relevant hot pixels.
     ka::HotPixelCollector hot_pixel_collector;
     hot_pixel_collector.reset();
 
-    for (const auto & contour : contours)
+    for (const auto contour : contours.rings())
     {
         hot_pixel_collector.add_tile_snapped_polyline(grid, contour);
     }
@@ -37,7 +45,7 @@ int main(int argc, char * argv[])
     std::vector<ka::Segment2s64> segments;
     const auto & hot_pixels = hot_pixel_collector.build_index();
     std::vector<ka::Vec2s64> coarse_points;
-    for (const auto & contour : contours)
+    for (const auto contour : contours.rings())
     {
         coarse_points.clear();
         snap_round(grid, hot_pixels, contour, std::back_inserter(coarse_points));